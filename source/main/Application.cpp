@@ -96,6 +96,8 @@ CVar* sim_spawn_running;
 CVar* sim_replay_enabled;
 CVar* sim_replay_length;
 CVar* sim_replay_stepping;
+CVar* sim_replay_memory;
+CVar* sim_replay_quantization;
 CVar* sim_realistic_commands;
 CVar* sim_races_enabled;
 CVar* sim_no_collisions;
@@ -103,6 +105,10 @@ CVar* sim_no_self_collisions;
 CVar* sim_gearbox_mode;
 CVar* sim_soft_reset_mode;
 CVar* sim_quickload_dialog;
+CVar* sim_savegame_binary;
+CVar* sim_autosave_interval;
+CVar* sim_parallel_forces;
+CVar* sim_step_pipeline;
 
 // Multiplayer
 CVar* mp_state;
@@ -117,6 +123,8 @@ CVar* mp_server_password;
 CVar* mp_player_name;
 CVar* mp_player_token;
 CVar* mp_api_url;
+CVar* mp_send_budget;
+CVar* mp_record_node_stream;
 
 // Diagnostic
 CVar* diag_auto_spawner_report;
@@ -156,6 +164,7 @@ CVar* sys_resources_dir;
 CVar* sys_profiler_dir;
 CVar* sys_savegames_dir;
 CVar* sys_screenshot_dir;
+CVar* sys_replays_dir;
 
 // OS command line
 CVar* cli_server_host;
@@ -225,6 +234,9 @@ CVar* gfx_fps_limit;
 CVar* gfx_speedo_digital;
 CVar* gfx_speedo_imperial;
 CVar* gfx_flexbody_cache;
+CVar* gfx_flexbody_lod_distance;
+CVar* gfx_flexbody_lod_rigid_distance;
+CVar* gfx_flexbody_lod_interval;
 CVar* gfx_reduce_shadows;
 CVar* gfx_enable_rtshaders;
 CVar* gfx_classic_shaders;
@@ -89,6 +89,8 @@ enum MsgType
     MSG_SIM_DELETE_ACTOR_REQUESTED,        //!< Payload = Actor* (weak)
     MSG_SIM_SEAT_PLAYER_REQUESTED,         //!< Payload = Actor* (weak) | nullptr
     MSG_SIM_TELEPORT_PLAYER_REQUESTED,     //!< Payload = Ogre::Vector3* (owner)
+    MSG_SIM_SCENE_SAVED,                   //!< Description = savegame filename
+    MSG_SIM_SCENE_SAVE_FAILED,             //!< Description = savegame filename
     // GUI
     MSG_GUI_OPEN_MENU_REQUESTED,
     MSG_GUI_CLOSE_MENU_REQUESTED,
@@ -270,6 +272,8 @@ extern CVar* sim_spawn_running;
 extern CVar* sim_replay_enabled;
 extern CVar* sim_replay_length;
 extern CVar* sim_replay_stepping;
+extern CVar* sim_replay_memory;
+extern CVar* sim_replay_quantization;
 extern CVar* sim_realistic_commands;
 extern CVar* sim_races_enabled;
 extern CVar* sim_no_collisions;
@@ -277,6 +281,10 @@ extern CVar* sim_no_self_collisions;
 extern CVar* sim_gearbox_mode;
 extern CVar* sim_soft_reset_mode;
 extern CVar* sim_quickload_dialog;
+extern CVar* sim_savegame_binary;
+extern CVar* sim_autosave_interval;
+extern CVar* sim_parallel_forces;
+extern CVar* sim_step_pipeline;
 
 // Multiplayer
 extern CVar* mp_state;
@@ -291,6 +299,8 @@ extern CVar* mp_server_password;
 extern CVar* mp_player_name;
 extern CVar* mp_player_token;
 extern CVar* mp_api_url;
+extern CVar* mp_send_budget;
+extern CVar* mp_record_node_stream;
 
 // Diagnostic
 extern CVar* diag_auto_spawner_report;
@@ -331,6 +341,7 @@ extern CVar* sys_resources_dir;
 extern CVar* sys_profiler_dir;
 extern CVar* sys_savegames_dir;
 extern CVar* sys_screenshot_dir;
+extern CVar* sys_replays_dir;
 
 // OS command line
 extern CVar* cli_server_host;
@@ -400,6 +411,9 @@ extern CVar* gfx_fps_limit;
 extern CVar* gfx_speedo_digital;
 extern CVar* gfx_speedo_imperial;
 extern CVar* gfx_flexbody_cache;
+extern CVar* gfx_flexbody_lod_distance;
+extern CVar* gfx_flexbody_lod_rigid_distance;
+extern CVar* gfx_flexbody_lod_interval;
 extern CVar* gfx_reduce_shadows;
 extern CVar* gfx_enable_rtshaders;
 extern CVar* gfx_classic_shaders;
@@ -89,6 +89,7 @@ namespace RoR
     class  Renderdash;
     class  Replay;
     class  RigLoadingProfiler;
+    struct SavedActorBlocks;
     class  Screwprop;
     class  ScriptEngine;
     class  ShadowManager;
@@ -251,6 +251,7 @@ Actor* GameContext::SpawnActor(ActorSpawnRequest& rq)
             req->amr_actor = fresh_actor;
             req->amr_type = ActorModifyRequest::Type::RESTORE_SAVED;
             req->amr_saved_state = rq.asr_saved_state;
+            req->amr_saved_blocks = rq.asr_saved_blocks;
             this->PushMessage(Message(MSG_SIM_MODIFY_ACTOR_REQUESTED, (void*)req));
         }
     }
@@ -282,7 +283,7 @@ void GameContext::ModifyActor(ActorModifyRequest& rq)
     }
     else if (rq.amr_type == ActorModifyRequest::Type::RESTORE_SAVED)
     {
-        m_actor_manager.RestoreSavedState(rq.amr_actor, *rq.amr_saved_state.get());
+        m_actor_manager.RestoreSavedState(rq.amr_actor, *rq.amr_saved_state.get(), rq.amr_saved_blocks.get());
     }
     else if (rq.amr_type == ActorModifyRequest::Type::WAKE_UP &&
         rq.amr_actor->ar_sim_state == Actor::SimState::LOCAL_SLEEPING)
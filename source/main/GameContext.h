@@ -136,6 +136,7 @@ public:
 
     void                LoadScene(std::string const& filename); //!< Matching terrain must be already loaded
     void                SaveScene(std::string const& filename);
+    void                UpdateAutosave(float dt); //!< Saves 'autosave.sav' every `sim_autosave_interval` seconds
     std::string         GetQuicksaveFilename(); //!< For currently loaded terrain (cvar 'sim_terrain_name')
     std::string         ExtractSceneName(std::string const& filename);
     std::string         ExtractSceneTerrain(std::string const& filename); //!< Returns terrain filename
@@ -162,6 +163,9 @@ private:
     Message*            m_msg_chain_end = nullptr;
     std::mutex          m_msg_mutex;
 
+    // Savegames
+    float               m_autosave_timer = 0.f;
+
     // Actors (physics and netcode)
     ActorManager        m_actor_manager;
     Actor*              m_player_actor = nullptr;           //!< Actor (vehicle or machine) mounted and controlled by player
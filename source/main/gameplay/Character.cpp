@@ -470,15 +470,15 @@ void Character::SendStreamData()
 #endif // USE_SOCKETW
 }
 
-void Character::receiveStreamData(unsigned int& type, int& source, unsigned int& streamid, char* buffer)
+void Character::receiveStreamData(unsigned int type, int source, unsigned int streamid, const char* buffer)
 {
 #ifdef USE_SOCKETW
     if (type == RoRnet::MSG2_STREAM_DATA && m_source_id == source && m_stream_id == streamid)
     {
-        auto* msg = reinterpret_cast<NetCharacterMsgGeneric*>(buffer);
+        auto* msg = reinterpret_cast<const NetCharacterMsgGeneric*>(buffer);
         if (msg->command == CHARACTER_CMD_POSITION)
         {
-            auto* pos_msg = reinterpret_cast<NetCharacterMsgPos*>(buffer);
+            auto* pos_msg = reinterpret_cast<const NetCharacterMsgPos*>(buffer);
             this->setPosition(Ogre::Vector3(pos_msg->pos_x, pos_msg->pos_y, pos_msg->pos_z));
             this->setRotation(Ogre::Radian(pos_msg->rot_angle));
             if (strnlen(pos_msg->anim_name, CHARACTER_ANIM_NAME_LEN) < CHARACTER_ANIM_NAME_LEN)
@@ -495,7 +495,7 @@ void Character::receiveStreamData(unsigned int& type, int& source, unsigned int&
         }
         else if (msg->command == CHARACTER_CMD_ATTACH)
         {
-            auto* attach_msg = reinterpret_cast<NetCharacterMsgAttach*>(buffer);
+            auto* attach_msg = reinterpret_cast<const NetCharacterMsgAttach*>(buffer);
             Actor* beam = App::GetGameContext()->GetActorManager()->GetActorByNetworkLinks(attach_msg->source_id, attach_msg->stream_id);
             if (beam != nullptr)
             {
@@ -53,7 +53,7 @@ public:
     void           move(Ogre::Vector3 offset);
     void           update(float dt);
     void           updateCharacterRotation();
-    void           receiveStreamData(unsigned int& type, int& source, unsigned int& streamid, char* buffer);
+    void           receiveStreamData(unsigned int type, int source, unsigned int streamid, const char* buffer);
     void           SetActorCoupling(bool enabled, Actor* actor);
     GfxCharacter*  SetupGfx();
 
@@ -86,6 +86,17 @@ void CharacterFactory::Update(float dt)
     }
 }
 
+void CharacterFactory::GetRemoteCharacterPositions(std::vector<Ogre::Vector3>& out)
+{
+    for (auto& c : m_remote_characters)
+    {
+        if (c->GetActorCoupling() == nullptr)
+        {
+            out.push_back(c->getPosition());
+        }
+    }
+}
+
 void CharacterFactory::UndoRemoteActorCoupling(Actor* actor)
 {
     for (auto& c : m_remote_characters)
@@ -104,13 +115,13 @@ void CharacterFactory::DeleteAllCharacters()
 }
 
 #ifdef USE_SOCKETW
-void CharacterFactory::handleStreamData(std::vector<RoR::NetRecvPacket> packet_buffer)
+void CharacterFactory::handleStreamData(std::vector<RoR::NetRecvPacket> const& packet_buffer)
 {
-    for (auto packet : packet_buffer)
+    for (auto& packet : packet_buffer)
     {
         if (packet.header.command == RoRnet::MSG2_STREAM_REGISTER)
         {
-            RoRnet::StreamRegister* reg = (RoRnet::StreamRegister *)packet.buffer;
+            const RoRnet::StreamRegister* reg = (const RoRnet::StreamRegister *)packet.buffer;
             if (reg->type == 1)
             {
                 createRemoteInstance(packet.header.source, packet.header.streamid);
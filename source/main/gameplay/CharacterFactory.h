@@ -38,9 +38,10 @@ public:
     Character* GetLocalCharacter() { return m_local_character.get(); }
     void DeleteAllCharacters();
     void UndoRemoteActorCoupling(Actor* actor);
+    void GetRemoteCharacterPositions(std::vector<Ogre::Vector3>& out); //!< Only characters on foot
     void Update(float dt);
 #ifdef USE_SOCKETW
-    void handleStreamData(std::vector<RoR::NetRecvPacket> packet);
+    void handleStreamData(std::vector<RoR::NetRecvPacket> const& packet);
 #endif // USE_SOCKETW
 
 private:
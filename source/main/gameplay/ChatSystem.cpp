@@ -44,7 +44,7 @@ void SendStreamSetup()
 #endif // USE_SOCKETW
 
 #ifdef USE_SOCKETW
-void ReceiveStreamData(unsigned int type, int source, char* buffer)
+void ReceiveStreamData(unsigned int type, int source, const char* buffer)
 {
     if (type != MSG2_UTF8_CHAT && type != MSG2_UTF8_PRIVCHAT)
         return;
@@ -60,9 +60,9 @@ void ReceiveStreamData(unsigned int type, int source, char* buffer)
 #endif // USE_SOCKETW
 
 #ifdef USE_SOCKETW
-void HandleStreamData(std::vector<RoR::NetRecvPacket> packet_buffer)
+void HandleStreamData(std::vector<RoR::NetRecvPacket> const& packet_buffer)
 {
-    for (auto packet : packet_buffer)
+    for (auto& packet : packet_buffer)
     {
         ReceiveStreamData(packet.header.command, packet.header.source, packet.buffer);
     }
@@ -25,38 +25,68 @@
 #include "ErrorUtils.h"
 #include "Language.h"
 #include "TerrainManager.h"
+#include "PlatformUtils.h"
 #include "PropertyMaps.h"
 #include "PagedGeometry.h"
+#include "Utils.h"
 
 #include <OgreConfigFile.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
 using namespace Ogre;
 using namespace RoR;
 
+static const char     LANDUSE_CACHE_SIGNATURE[8] = "RoRLuse";
+static const uint32_t LANDUSE_CACHE_VERSION = 1;
+
+struct LanduseCacheHeader
+{
+    char     signature[8];
+    uint32_t version;
+    int32_t  width;
+    int32_t  height;
+    uint32_t num_ground_models;
+};
+
 Landusemap::Landusemap(String configFilename) :
-    data(0)
-    , default_ground_model(nullptr)
-    , mapsize(App::GetSimTerrain()->getMaxTerrainSize())
+    default_ground_model(nullptr)
 {
+    const Vector3 mapsize = App::GetSimTerrain()->getMaxTerrainSize();
+    width = static_cast<int>(mapsize.x);
+    height = static_cast<int>(mapsize.z);
+    tiles_x = (width + TILE_MASK) >> TILE_BITS;
+
     loadConfig(configFilename);
 }
 
 Landusemap::~Landusemap()
 {
-    if (data != nullptr)
-        delete[] data;
 }
 
 ground_model_t* Landusemap::getGroundModelAt(int x, int z)
 {
-    if (!data)
+    if (raster.empty())
         return nullptr;
 
     // we return the default ground model if we are not anymore in this map
-    if (x < 0 || x >= mapsize.x || z < 0 || z >= mapsize.z)
-        return default_ground_model;
+    return this->sample(x, z);
+}
+
+void Landusemap::getGroundModelsAt(const float* x, const float* z, ground_model_t** out, int count)
+{
+    if (raster.empty())
+    {
+        std::fill(out, out + count, nullptr);
+        return;
+    }
 
-    return data[x + z * (int)mapsize.x];
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = this->sample(static_cast<int>(x[i]), static_cast<int>(z[i]));
+    }
 }
 
 int Landusemap::loadConfig(const Ogre::String& filename)
@@ -126,32 +156,84 @@ int Landusemap::loadConfig(const Ogre::String& filename)
             }
         }
     }
-    // process the config data and load the buffers finally
-    try
+    // ground model table - index 0 stands for colors without a use, like before
+    ground_model_names.assign(1, "");
+    std::map<String, int> name_to_index;
+    std::unordered_map<unsigned int, uint8_t> color_to_index;
+    for (auto& entry: usemap)
     {
-        Forests::ColorMap* colourMap = Forests::ColorMap::load(textureFilename, Forests::CHANNEL_COLOR);
-        colourMap->setFilter(Forests::MAPFILTER_NONE);
+        auto found = name_to_index.find(entry.second);
+        if (found == name_to_index.end())
+        {
+            if (ground_model_names.size() == MAX_GROUND_MODELS)
+            {
+                LogFormat("[RoR|Physics] Landuse: too many ground models in '%s', ignoring '%s'",
+                    filename.c_str(), entry.second.c_str());
+                continue;
+            }
+            found = name_to_index.insert(std::make_pair(entry.second, (int)ground_model_names.size())).first;
+            ground_model_names.push_back(entry.second);
+        }
+        color_to_index[entry.first] = static_cast<uint8_t>(found->second);
+    }
+    for (const String& name: ground_model_names)
+    {
+        ground_models.push_back(App::GetSimTerrain()->GetCollisions()->getGroundModelByString(name));
+    }
 
-        /*
-        // debug things below
-        printf("found ground use definitions:\n");
-        for (std::map < uint32, String >::iterator it=usemap.begin(); it!=usemap.end(); it++)
+    // the cache is keyed by everything the raster is built from
+    std::string cache_path;
+    try
+    {
+        // The texture goes in by size and modification time; hashing its contents would read it even on a cache hit
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        DataStreamPtr stream = rgm.openResource(textureFilename, ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME);
+        const String group = rgm.findGroupContainingResource(textureFilename);
+        std::string key = filename + ";" + textureFilename + ";" + TOSTRING(width) + "x" + TOSTRING(height) + ";";
+        for (auto& entry: usemap)
         {
-            printf(" 0x%Lx : %s\n", it->first, it->second.c_str());
+            key += TOSTRING(entry.first) + "=" + entry.second + ";";
         }
-        */
+        key += TOSTRING(stream->size()) + ";" + TOSTRING(static_cast<unsigned long>(rgm.resourceModifiedTime(group, textureFilename)));
+        cache_path = PathCombine(App::sys_cache_dir->GetStr(), "landuse_" + Utils::Sha1Hash(key) + ".dat");
+    }
+    catch (...)
+    {
+        // no texture to hash - buildRaster() will report it
+    }
+
+    if (!cache_path.empty() && this->loadRasterCache(cache_path))
+    {
+        LOG("Landuse raster loaded from cache: '" + cache_path + "'");
+        return 0;
+    }
+
+    this->buildRaster(textureFilename, color_to_index);
+    if (!cache_path.empty() && !raster.empty())
+    {
+        this->saveRasterCache(cache_path);
+    }
+
+    return 0;
+}
+
+void Landusemap::buildRaster(const Ogre::String& textureFilename, std::unordered_map<unsigned int, uint8_t> const& color_to_index)
+{
+    try
+    {
+        Forests::ColorMap* colourMap = Forests::ColorMap::load(textureFilename, Forests::CHANNEL_COLOR);
+        colourMap->setFilter(Forests::MAPFILTER_NONE);
 
         bool bgr = colourMap->getPixelBox().format == PF_A8B8G8R8;
 
-        Ogre::TRect<Ogre::Real> bounds = Forests::TBounds(0, 0, mapsize.x, mapsize.z);
+        Ogre::TRect<Ogre::Real> bounds = Forests::TBounds(0, 0, width, height);
 
-        // now allocate the data buffer to hold pointers to ground models
-        data = new ground_model_t*[(int)(mapsize.x * mapsize.z)];
-        ground_model_t** ptr = data;
-        //std::map < String, int > counters;
-        for (int z = 0; z < mapsize.z; z++)
+        // now allocate the raster, whole tiles
+        const int tiles_z = (height + TILE_MASK) >> TILE_BITS;
+        raster.assign((size_t)tiles_x * tiles_z * TILE_SIZE * TILE_SIZE, 0);
+        for (int z = 0; z < height; z++)
         {
-            for (int x = 0; x < mapsize.x; x++)
+            for (int x = 0; x < width; x++)
             {
                 unsigned int col = colourMap->getColorAt(x, z, bounds);
                 if (bgr)
@@ -162,30 +244,106 @@ int Landusemap::loadConfig(const Ogre::String& filename)
                     cols |= (col & 0xFF0000) >> 16;
                     col = cols;
                 }
-                String use = usemap[col];
-                //if (use!="")
-                //	counters[use]++;
-
-                // store the pointer to the ground model in the data slot
-                *ptr = App::GetSimTerrain()->GetCollisions()->getGroundModelByString(use);
-                ptr++;
+                auto found = color_to_index.find(col);
+                if (found != color_to_index.end())
+                {
+                    const int tile = (z >> TILE_BITS) * tiles_x + (x >> TILE_BITS);
+                    const int texel = ((z & TILE_MASK) << TILE_BITS) | (x & TILE_MASK);
+                    raster[(tile << (2 * TILE_BITS)) | texel] = found->second;
+                }
             }
         }
     }
     catch (Ogre::Exception& oex)
     {
+        raster.clear();
         LogFormat("[RoR|Physics] Landuse: failed to load texture '%s', <Ogre::Exception> message: '%s'",
             textureFilename.c_str(), oex.getFullDescription().c_str());
     }
     catch (std::exception& stex)
     {
+        raster.clear();
         LogFormat("[RoR|Physics] Landuse: failed to load texture '%s', <std::exception> message: '%s'",
             textureFilename.c_str(), stex.what());
     }
     catch (...)
     {
+        raster.clear();
         LogFormat("[RoR|Physics] Landuse: failed to load texture '%s', unknown error", textureFilename.c_str());
     }
+}
 
-    return 0;
+bool Landusemap::loadRasterCache(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    bool ok = false;
+    LanduseCacheHeader header;
+    if (fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.signature, LANDUSE_CACHE_SIGNATURE, sizeof(header.signature)) == 0
+        && header.version == LANDUSE_CACHE_VERSION
+        && header.width == width && header.height == height
+        && header.num_ground_models == ground_model_names.size())
+    {
+        ok = true;
+        for (size_t i = 0; ok && i < ground_model_names.size(); i++)
+        {
+            uint16_t len = 0;
+            ok = fread(&len, sizeof(len), 1, file) == 1;
+            std::string name(ok ? len : 0, '\0');
+            ok = ok && fread(&name[0], 1, len, file) == len && ground_model_names[i] == name;
+        }
+        if (ok)
+        {
+            const int tiles_z = (height + TILE_MASK) >> TILE_BITS;
+            raster.resize((size_t)tiles_x * tiles_z * TILE_SIZE * TILE_SIZE);
+            ok = fread(raster.data(), 1, raster.size(), file) == raster.size();
+            // `sample()` indexes the ground model table with these
+            for (size_t i = 0; ok && i < raster.size(); i++)
+            {
+                ok = raster[i] < ground_model_names.size();
+            }
+        }
+    }
+    fclose(file);
+
+    if (!ok)
+    {
+        raster.clear();
+        LOG("Landuse raster cache is invalid, rebuilding: '" + path + "'");
+    }
+    return ok;
+}
+
+void Landusemap::saveRasterCache(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        LOG("Failed to write landuse raster cache: '" + path + "'");
+        return;
+    }
+
+    LanduseCacheHeader header;
+    memcpy(header.signature, LANDUSE_CACHE_SIGNATURE, sizeof(header.signature));
+    header.version = LANDUSE_CACHE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.num_ground_models = static_cast<uint32_t>(ground_model_names.size());
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const String& name: ground_model_names)
+    {
+        const uint16_t len = static_cast<uint16_t>(std::min(name.size(), (size_t)UINT16_MAX));
+        ok = ok && fwrite(&len, sizeof(len), 1, file) == 1 && fwrite(name.data(), 1, len, file) == len;
+    }
+    ok = ok && fwrite(raster.data(), 1, raster.size(), file) == raster.size();
+    fclose(file);
+
+    if (!ok)
+    {
+        LOG("Failed to write landuse raster cache: '" + path + "'");
+        std::remove(path.c_str());
+    }
 }
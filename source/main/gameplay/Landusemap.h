@@ -25,8 +25,17 @@
 #include "Application.h"
 #include "SimData.h"
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 namespace RoR {
 
+/// Ground models painted over the terrain by a color texture ('use-map' section of the landuse config).
+///
+/// The texture is converted at load into a raster of 1-byte indices into a small ground model table,
+/// stored in square tiles so that the nodes of an actor hit few cache lines. The raster is cached
+/// in `sys_cache_dir`, keyed by the config, the texture's size and modification time and the terrain size.
 class Landusemap : public ZeroedMemoryAllocator
 {
 public:
@@ -35,14 +44,39 @@ public:
     ~Landusemap();
 
     ground_model_t* getGroundModelAt(int x, int z);
+    /// Batched getGroundModelAt(); thread-safe. Coordinates are truncated like getGroundModelAt() does.
+    void getGroundModelsAt(const float* x, const float* z, ground_model_t** out, int count);
     int loadConfig(const Ogre::String& filename);
 
 protected:
 
-    ground_model_t** data;
+    static const int TILE_BITS = 6; //!< 64x64 texels = 4KB per tile
+    static const int TILE_SIZE = 1 << TILE_BITS;
+    static const int TILE_MASK = TILE_SIZE - 1;
+    static const int MAX_GROUND_MODELS = 256; //!< Addressable by the uint8 raster; index 0 is 'no ground model'
+
+    inline ground_model_t* sample(int x, int z) const
+    {
+        if (x < 0 || x >= width || z < 0 || z >= height)
+            return default_ground_model;
+
+        const int tile = (z >> TILE_BITS) * tiles_x + (x >> TILE_BITS);
+        const int texel = ((z & TILE_MASK) << TILE_BITS) | (x & TILE_MASK);
+        return ground_models[raster[(tile << (2 * TILE_BITS)) | texel]];
+    }
+
+    void buildRaster(const Ogre::String& texture_filename, std::unordered_map<unsigned int, uint8_t> const& color_to_index);
+    bool loadRasterCache(const std::string& path);
+    void saveRasterCache(const std::string& path);
+
+    std::vector<uint8_t>         raster;              //!< Ground model indices, tiled
+    std::vector<ground_model_t*> ground_models;       //!< Indexed by `raster`
+    std::vector<Ogre::String>    ground_model_names;  //!< Parallel to `ground_models`; what the cache stores
     ground_model_t* default_ground_model;
 
-    Ogre::Vector3 mapsize;
+    int width;
+    int height;
+    int tiles_x;
 };
 
 } // namespace RoR
@@ -23,226 +23,549 @@
 #include "Application.h"
 #include "Actor.h"
 #include "ActorManager.h"
+#include "BitStream.h"
 #include "GameContext.h"
 #include "GUIManager.h"
 #include "InputEngine.h"
 #include "Language.h"
 #include "Utils.h"
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
 using namespace Ogre;
 using namespace RoR;
 
-Replay::Replay(Actor* actor, int _numFrames)
-{
-    m_actor = actor;
-    numFrames = _numFrames;
-
-    curFrameTime = 0;
+namespace {
 
-    replayTimer = new Timer();
-
-    // DO NOT get memory here, get memory when we use it first time!
-    nodes = 0;
-    beams = 0;
-    times = 0;
-
-    outOfMemory = false;
+inline int32_t Quantize(float value, float inv_step)
+{
+    const float q = std::floor(value * inv_step + 0.5f);
+    return static_cast<int32_t>(std::max(-float(REPLAY_MAX_COORD), std::min(float(REPLAY_MAX_COORD), q)));
+}
 
-    unsigned long bsize = (actor->ar_num_nodes * numFrames * sizeof(node_simple_t) + actor->ar_num_beams * numFrames * sizeof(beam_simple_t) + numFrames * sizeof(unsigned long)) / 1024.0f;
-    LOG("replay buffer size: " + TOSTRING(bsize) + " kB");
+inline bool IsRecorded(Actor* actor)
+{
+    return actor->ar_sim_state == Actor::SimState::LOCAL_SIMULATED
+        || actor->ar_sim_state == Actor::SimState::LOCAL_SLEEPING;
+}
 
-    writeIndex = 0;
-    firstRun = 1;
+} // namespace
 
+Replay::Replay()
+{
     int steps = App::sim_replay_stepping->GetInt();
 
     if (steps <= 0)
         this->ar_replay_precision = 0.0f;
     else
         this->ar_replay_precision = 1.0f / ((float)steps);
+    m_steps_per_frame = std::max(1, static_cast<int>(ar_replay_precision / PHYSICS_DT + 0.5f));
+
+    m_quantization = std::max(0.5f, App::sim_replay_quantization->GetFloat()) / 1000.f; // mm -> m; finer steps would hit REPLAY_MAX_COORD on big terrains
 
-    // windowing
-    int width = 300;
-    int height = 60;
-    int x = (MyGUI::RenderManager::getInstance().getViewSize().width - width) / 2;
-    int y = 0;
+    // DO NOT get memory here, chunks get it when they're used first time!
+    const size_t budget = static_cast<size_t>(std::max(1, App::sim_replay_memory->GetInt())) * 1024 * 1024;
+    m_chunks.resize(std::max(size_t(2), budget / REPLAY_CHUNK_SIZE));
+
+    LOG("replay buffer: " + TOSTRING(m_chunks.size()) + " chunks of " + TOSTRING(REPLAY_CHUNK_SIZE / 1024) + " kB,"
+        " position step: " + TOSTRING(m_quantization * 1000.f) + " mm");
 }
 
 Replay::~Replay()
 {
-    if (nodes)
+    this->StopSaving();
+}
+
+int Replay::getNumFrames() const
+{
+    if (m_file_reader.IsOpen())
+        return static_cast<int>(std::min(m_file_reader.GetNumFrames(), static_cast<uint64_t>(INT_MAX)));
+    if (m_num_chunks == 0)
+        return 0;
+
+    const size_t oldest = (m_head_chunk + m_chunks.size() + 1 - m_num_chunks) % m_chunks.size();
+    const size_t available = m_num_frames - m_chunks[oldest].first_frame;
+    return static_cast<int>(std::min(available, static_cast<size_t>(std::max(1, App::sim_replay_length->GetInt()))));
+}
+
+float Replay::getPrecision() const
+{
+    return m_file_reader.IsOpen() ? m_file_reader.GetHeader().frame_interval : ar_replay_precision;
+}
+
+size_t Replay::getMemoryUsage() const
+{
+    size_t bytes = 0;
+    for (Chunk const& chunk: m_chunks)
     {
-        free(nodes);
-        nodes = 0;
-        free(beams);
-        beams = 0;
-        free(times);
-        times = 0;
+        bytes += chunk.data.capacity() + chunk.frame_offsets.capacity() * sizeof(uint32_t);
     }
-    delete replayTimer;
+    return bytes;
 }
 
-void* Replay::getWriteBuffer(int type)
+void Replay::onPhysicsStep(std::vector<Actor*> const& actors)
 {
-    if (outOfMemory)
-        return 0;
-    if (!nodes)
+    if (m_replaying)
+        return;
+
+    m_num_steps++;
+    if (--m_steps_to_frame > 0)
+        return;
+    m_steps_to_frame = m_steps_per_frame;
+
+    // Quantize all recorded actors
+    m_frame_actors.clear();
+    m_frame_pos.clear();
+    m_frame_beams.clear();
+    const float inv_step = 1.f / m_quantization;
+    for (Actor* actor: actors)
     {
-        // get memory
-        nodes = (node_simple_t*)calloc(m_actor->ar_num_nodes * numFrames, sizeof(node_simple_t));
-        if (!nodes)
+        if (!IsRecorded(actor))
+            continue;
+
+        Track& track = m_rec_tracks[actor->ar_instance_id];
+        if (track.num_nodes != static_cast<uint32_t>(actor->ar_num_nodes) || track.num_beams != static_cast<uint32_t>(actor->ar_num_beams))
+        {
+            track = Track();
+            track.num_nodes = actor->ar_num_nodes;
+            track.num_beams = actor->ar_num_beams;
+
+            ReplayFileActor info;
+            std::memset(&info, 0, sizeof(ReplayFileActor));
+            info.instance_id = actor->ar_instance_id;
+            info.num_nodes = track.num_nodes;
+            info.num_beams = track.num_beams;
+            strncpy(info.file_hash, actor->ar_filehash.c_str(), sizeof(info.file_hash) - 1);
+            strncpy(info.file_name, actor->ar_filename.c_str(), sizeof(info.file_name) - 1);
+            m_actor_infos[actor->ar_instance_id] = info;
+            m_file_writer.WriteActor(info);
+        }
+        else if (track.last_frame + 1 != m_num_frames)
         {
-            outOfMemory = true;
-            return 0;
+            track.history = 0; // Missed frames (replay, sleeping in another state), the prediction would be off
         }
-        beams = (beam_simple_t*)calloc(m_actor->ar_num_beams * numFrames, sizeof(beam_simple_t));
-        if (!beams)
+        track.last_frame = m_num_frames;
+
+        FrameActor fa;
+        fa.actor = actor;
+        fa.track = &track;
+        fa.pos_offset = m_frame_pos.size();
+        fa.beam_offset = m_frame_beams.size();
+        m_frame_actors.push_back(fa);
+
+        for (int i = 0; i < actor->ar_num_nodes; i++)
         {
-            free(nodes);
-            nodes = 0;
-            outOfMemory = true;
-            return 0;
+            const Vector3& pos = actor->ar_nodes[i].AbsPosition;
+            m_frame_pos.push_back(Quantize(pos.x, inv_step));
+            m_frame_pos.push_back(Quantize(pos.y, inv_step));
+            m_frame_pos.push_back(Quantize(pos.z, inv_step));
         }
-        times = (unsigned long*)calloc(numFrames, sizeof(unsigned long));
-        if (!times)
+        for (int i = 0; i < actor->ar_num_beams; i++)
         {
-            free(nodes);
-            nodes = 0;
-            free(beams);
-            beams = 0;
-            outOfMemory = true;
-            return 0;
+            m_frame_beams.push_back((actor->ar_beams[i].bm_broken ? 1 : 0) | (actor->ar_beams[i].bm_disabled ? 2 : 0));
         }
     }
-    void* ptr = 0;
-    times[writeIndex] = replayTimer->getMicroseconds();
-    if (type == 0)
+
+    if (m_frame_actors.empty() || m_frame_actors.size() > UINT16_MAX)
+        return;
+
+    // Append to the current chunk, or start a new one with a keyframe
+    bool new_chunk = (m_num_chunks == 0) || (m_chunks[m_head_chunk].frame_offsets.size() >= REPLAY_CHUNK_MAX_FRAMES);
+    if (!new_chunk)
     {
-        // nodes
-        ptr = (void *)(nodes + (writeIndex * m_actor->ar_num_nodes));
+        this->EncodeFrame(/*keyframe=*/false);
+        new_chunk = (m_chunks[m_head_chunk].data.size() + m_frame_data.size() > REPLAY_CHUNK_SIZE);
     }
-    else if (type == 1)
+    if (new_chunk)
     {
-        // beams
-        ptr = (void *)(beams + (writeIndex * m_actor->ar_num_beams));
+        this->StartChunk();
+        this->EncodeFrame(/*keyframe=*/true);
     }
-    return ptr;
+
+    Chunk& chunk = m_chunks[m_head_chunk];
+    chunk.frame_offsets.push_back(static_cast<uint32_t>(chunk.data.size()));
+    chunk.data.insert(chunk.data.end(), m_frame_data.begin(), m_frame_data.end());
+
+    this->CommitFrame();
+    m_num_frames++;
 }
 
-void Replay::writeDone()
+Replay::Chunk& Replay::StartChunk()
 {
-    if (outOfMemory)
-        return;
-    writeIndex++;
-    if (writeIndex == numFrames)
+    if (m_num_chunks > 0 && m_file_writer.IsOpen())
+        this->WriteChunk(m_chunks[m_head_chunk]);
+
+    if (m_num_chunks > 0)
+        m_head_chunk = (m_head_chunk + 1) % m_chunks.size();
+    if (m_num_chunks < m_chunks.size())
+        m_num_chunks++;
+
+    Chunk& chunk = m_chunks[m_head_chunk];
+    chunk.data.clear();
+    chunk.data.reserve(REPLAY_CHUNK_SIZE);
+    chunk.frame_offsets.clear();
+    chunk.first_frame = m_num_frames;
+
+    // Chunks must decode on their own: forget actors which are gone, key the others
+    for (auto itor = m_rec_tracks.begin(); itor != m_rec_tracks.end(); )
     {
-        firstRun = 0;
-        writeIndex = 0;
+        if (itor->second.last_frame != m_num_frames)
+        {
+            itor = m_rec_tracks.erase(itor);
+        }
+        else
+        {
+            itor->second.history = 0;
+            ++itor;
+        }
     }
+    return chunk;
 }
 
-//we take negative offsets only
-void* Replay::getReadBuffer(int offset, int type, unsigned long& time)
+void Replay::EncodeFrame(bool keyframe)
 {
-    if (offset >= 0)
-        offset = -1;
-    if (offset <= -numFrames)
-        offset = -numFrames + 1;
-
-    int delta = writeIndex + offset;
-    if (delta < 0)
-        if (firstRun && type == 0)
-            return (void *)(nodes);
-        else if (firstRun && type == 1)
-            return (void *)(beams);
+    ReplayFrameHeader frame_header;
+    frame_header.time_us = static_cast<uint64_t>(m_num_steps * static_cast<double>(PHYSICS_DT) * 1000000.0);
+    frame_header.num_actors = static_cast<uint16_t>(m_frame_actors.size());
+    m_frame_data.resize(sizeof(ReplayFrameHeader));
+    std::memcpy(m_frame_data.data(), &frame_header, sizeof(ReplayFrameHeader));
+
+    for (FrameActor const& fa: m_frame_actors)
+    {
+        Track const& track = *fa.track;
+        const int32_t* pos = m_frame_pos.data() + fa.pos_offset;
+        const uint8_t* beams = m_frame_beams.data() + fa.beam_offset;
+        const size_t num_values = track.num_nodes * 3;
+
+        ReplayActorHeader header;
+        header.instance_id = fa.actor->ar_instance_id;
+        header.num_nodes = track.num_nodes;
+        header.num_beams = track.num_beams;
+        header.flags = 0;
+
+        m_residuals.clear();
+        if (keyframe || track.history == 0)
+        {
+            // Predict each node from the previous one, neighbours are usually close
+            header.flags |= REPLAY_ACTOR_KEY | REPLAY_ACTOR_BEAMS;
+            for (size_t i = 0; i < num_values; i++)
+            {
+                const int32_t prediction = (i >= 3) ? pos[i - 3] : 0;
+                m_residuals.push_back(ZigZag(pos[i] - prediction));
+            }
+        }
         else
-            delta += numFrames;
+        {
+            if (std::equal(pos, pos + num_values, track.pos.begin()))
+            {
+                header.flags |= REPLAY_ACTOR_UNCHANGED;
+            }
+            else
+            {
+                // Extrapolate if nodes keep moving the way they did; noise at rest is better predicted by the last frame
+                bool linear = false;
+                if (track.history == 2)
+                {
+                    int bits_last = 0, bits_linear = 0;
+                    for (size_t i = 0; i < num_values; i++)
+                    {
+                        bits_last += FloorLog2(ZigZag(pos[i] - track.pos[i]) + 1);
+                        bits_linear += FloorLog2(ZigZag(pos[i] - (2 * track.pos[i] - track.prev_pos[i])) + 1);
+                    }
+                    linear = (bits_linear < bits_last);
+                }
+                if (linear)
+                {
+                    header.flags |= REPLAY_ACTOR_LINEAR;
+                    for (size_t i = 0; i < num_values; i++)
+                        m_residuals.push_back(ZigZag(pos[i] - (2 * track.pos[i] - track.prev_pos[i])));
+                }
+                else
+                {
+                    for (size_t i = 0; i < num_values; i++)
+                        m_residuals.push_back(ZigZag(pos[i] - track.pos[i]));
+                }
+            }
+            if (!std::equal(beams, beams + track.num_beams, track.beams.begin()))
+            {
+                header.flags |= REPLAY_ACTOR_BEAMS;
+            }
+        }
 
-    // set the time
-    time = times[delta];
-    curFrameTime = time;
+        header.golomb_k = static_cast<uint8_t>(ChooseGolombK(m_residuals.data(), m_residuals.size()));
 
-    if (outOfMemory)
-        return 0;
+        // Worst case: 2 * 29 + 1 bits per residual, see REPLAY_MAX_COORD
+        const size_t header_pos = m_frame_data.size();
+        const size_t capacity = m_residuals.size() * 8 + track.num_beams / 4 + 8;
+        m_frame_data.resize(header_pos + sizeof(ReplayActorHeader) + capacity);
+        BitWriter writer(m_frame_data.data() + header_pos + sizeof(ReplayActorHeader), capacity);
+        for (uint32_t u: m_residuals)
+        {
+            writer.PutGolomb(u, header.golomb_k);
+        }
+        if (header.flags & REPLAY_ACTOR_BEAMS)
+        {
+            for (uint32_t i = 0; i < track.num_beams; i++)
+                writer.Put(beams[i], 2);
+        }
+        header.data_size = static_cast<uint32_t>(writer.Finish());
+        ROR_ASSERT(header.data_size != 0 || (m_residuals.empty() && !(header.flags & REPLAY_ACTOR_BEAMS)));
+
+        std::memcpy(m_frame_data.data() + header_pos, &header, sizeof(ReplayActorHeader));
+        m_frame_data.resize(header_pos + sizeof(ReplayActorHeader) + header.data_size);
+    }
+}
+
+void Replay::CommitFrame()
+{
+    // Must match what DecodeFrame() does with the tracks
+    for (FrameActor const& fa: m_frame_actors)
+    {
+        Track& track = *fa.track;
+        const int32_t* pos = m_frame_pos.data() + fa.pos_offset;
+        const uint8_t* beams = m_frame_beams.data() + fa.beam_offset;
+
+        track.prev_pos.swap(track.pos);
+        track.pos.assign(pos, pos + track.num_nodes * 3);
+        track.beams.assign(beams, beams + track.num_beams);
+        track.history = (track.history == 0) ? 1 : 2;
+    }
+}
+
+void Replay::WriteChunk(Chunk const& chunk)
+{
+    m_file_writer.WriteChunk(chunk.first_frame, chunk.frame_offsets.data(), static_cast<uint32_t>(chunk.frame_offsets.size()),
+        chunk.data.data(), static_cast<uint32_t>(chunk.data.size()));
+}
+
+bool Replay::FindChunk(size_t frame, ChunkView& out) const
+{
+    if (m_file_reader.IsOpen())
+    {
+        const int index = m_file_reader.FindChunk(frame);
+        if (index == -1)
+            return false;
+        ReplayFileIndexEntry const& entry = m_file_reader.GetChunks()[index];
+        out.data = m_file_reader.GetFrameData(index);
+        out.data_size = entry.data_size;
+        out.frame_offsets = m_file_reader.GetFrameOffsets(index);
+        out.num_frames = entry.num_frames;
+        out.first_frame = static_cast<size_t>(entry.first_frame);
+        return true;
+    }
 
-    // return buffer pointer
-    if (type == 0)
-        return (void *)(nodes + delta * m_actor->ar_num_nodes);
-    else if (type == 1)
-        return (void *)(beams + delta * m_actor->ar_num_beams);
-    return 0;
+    for (size_t i = 0; i < m_num_chunks; i++)
+    {
+        Chunk const& chunk = m_chunks[(m_head_chunk + m_chunks.size() - i) % m_chunks.size()];
+        if (frame >= chunk.first_frame && frame < chunk.first_frame + chunk.frame_offsets.size())
+        {
+            out.data = chunk.data.data();
+            out.data_size = chunk.data.size();
+            out.frame_offsets = chunk.frame_offsets.data();
+            out.num_frames = chunk.frame_offsets.size();
+            out.first_frame = chunk.first_frame;
+            return true;
+        }
+    }
+    return false;
 }
 
-unsigned long Replay::getLastReadTime()
+size_t Replay::GetNewestFrame() const
 {
-    return curFrameTime;
+    if (m_file_reader.IsOpen())
+        return static_cast<size_t>(m_file_reader.GetFirstFrame() + m_file_reader.GetNumFrames() - 1);
+    return m_num_frames - 1;
 }
- 
-void Replay::onPhysicsStep()
+
+bool Replay::DecodeFrame(const uint8_t* data, size_t size, size_t frame)
 {
-    m_replay_timer += PHYSICS_DT;
-    if (m_replay_timer >= ar_replay_precision)
+    ReplayFrameHeader frame_header;
+    if (size < sizeof(ReplayFrameHeader))
+        return false;
+    std::memcpy(&frame_header, data, sizeof(ReplayFrameHeader));
+    m_play_prev_time_us = m_play_time_us;
+    m_play_time_us = static_cast<unsigned long>(frame_header.time_us);
+
+    size_t offset = sizeof(ReplayFrameHeader);
+    for (int n = 0; n < frame_header.num_actors; n++)
     {
-        // store nodes
-        node_simple_t* nbuff = (node_simple_t *)this->getWriteBuffer(0);
-        if (nbuff)
+        ReplayActorHeader header;
+        if (offset + sizeof(ReplayActorHeader) > size)
+            return false;
+        std::memcpy(&header, data + offset, sizeof(ReplayActorHeader));
+        offset += sizeof(ReplayActorHeader);
+        if (header.data_size > size - offset || header.golomb_k > BITSTREAM_MAX_GOLOMB_K)
+            return false;
+        if (m_file_reader.IsOpen() && !this->IsKnownFileActor(header))
+            return false;
+        // At least 1 bit per residual and 2 per beam - also bounds the allocations below by the data at hand
+        const uint64_t min_bits = ((header.flags & REPLAY_ACTOR_UNCHANGED) ? 0 : uint64_t(header.num_nodes) * 3)
+                                + ((header.flags & REPLAY_ACTOR_BEAMS) ? uint64_t(header.num_beams) * 2 : 0);
+        if (min_bits > uint64_t(header.data_size) * 8)
+            return false;
+
+        Track& track = m_play_tracks[header.instance_id];
+        if (track.num_nodes != header.num_nodes || track.num_beams != header.num_beams)
+        {
+            track = Track();
+            track.num_nodes = header.num_nodes;
+            track.num_beams = header.num_beams;
+            track.pos.resize(size_t(header.num_nodes) * 3);
+            track.prev_pos.resize(size_t(header.num_nodes) * 3);
+            track.beams.resize(header.num_beams);
+        }
+        const bool key = (header.flags & REPLAY_ACTOR_KEY) != 0;
+        const bool linear = (header.flags & REPLAY_ACTOR_LINEAR) != 0;
+        if ((!key && track.history == 0) || (linear && track.history != 2))
+            return false;
+
+        // Decode into `prev_pos`, then swap - each value only depends on its own history
+        BitReader reader(data + offset, header.data_size);
+        const size_t num_values = size_t(track.num_nodes) * 3;
+        uint32_t u = 0;
+        if (header.flags & REPLAY_ACTOR_UNCHANGED)
+        {
+            track.prev_pos = track.pos;
+        }
+        else
         {
-            for (int i = 0; i < m_actor->ar_num_nodes; i++)
+            for (size_t i = 0; i < num_values; i++)
             {
-                nbuff[i].position = m_actor->ar_nodes[i].AbsPosition;
-                nbuff[i].velocity = m_actor->ar_nodes[i].Velocity;
+                if (!reader.GetGolomb(header.golomb_k, u))
+                    return false;
+                int64_t prediction;
+                if (key)
+                    prediction = (i >= 3) ? track.prev_pos[i - 3] : 0;
+                else if (linear)
+                    prediction = 2 * int64_t(track.pos[i]) - track.prev_pos[i];
+                else
+                    prediction = track.pos[i];
+                const int64_t value = prediction + UnZigZag(u);
+                if (value < -REPLAY_MAX_COORD || value > REPLAY_MAX_COORD)
+                    return false; // Corrupt data; the recorder clamps
+                track.prev_pos[i] = static_cast<int32_t>(value);
             }
         }
+        track.prev_pos.swap(track.pos);
 
-        // store beams
-        beam_simple_t* bbuff = (beam_simple_t *)this->getWriteBuffer(1);
-        if (bbuff)
+        if (header.flags & REPLAY_ACTOR_BEAMS)
         {
-            for (int i = 0; i < m_actor->ar_num_beams; i++)
+            for (uint32_t i = 0; i < track.num_beams; i++)
             {
-                bbuff[i].broken = m_actor->ar_beams[i].bm_broken;
-                bbuff[i].disabled = m_actor->ar_beams[i].bm_disabled;
+                if (!reader.Get(2, u))
+                    return false;
+                track.beams[i] = static_cast<uint8_t>(u);
             }
         }
 
-        this->writeDone();
-        m_replay_timer = 0.0f;
+        track.history = key ? 1 : 2;
+        track.last_frame = frame;
+        offset += header.data_size;
     }
+    return true;
 }
 
-void Replay::replayStepActor()
+bool Replay::IsKnownFileActor(ReplayActorHeader const& header) const
 {
-    if (ar_replay_pos != m_replay_pos_prev)
+    for (ReplayFileActor const& actor: m_file_reader.GetActors())
     {
-        unsigned long time = 0;
+        if (actor.instance_id == header.instance_id)
+            return actor.num_nodes == header.num_nodes && actor.num_beams == header.num_beams;
+    }
+    return false;
+}
 
-        node_simple_t* nbuff = (node_simple_t *)this->getReadBuffer(ar_replay_pos, 0, time);
-        if (nbuff)
-        {
-            for (int i = 0; i < m_actor->ar_num_nodes; i++)
-            {
-                m_actor->ar_nodes[i].AbsPosition = nbuff[i].position;
-                m_actor->ar_nodes[i].RelPosition = nbuff[i].position - m_actor->ar_origin;
+void Replay::replayStepActors(std::vector<Actor*> const& actors)
+{
+    if (ar_replay_pos == m_replay_pos_prev)
+        return;
+    m_replay_pos_prev = ar_replay_pos;
 
-                m_actor->ar_nodes[i].Velocity = nbuff[i].velocity;
-                m_actor->ar_nodes[i].Forces = Vector3::ZERO;
-            }
+    const int num_frames = this->getNumFrames();
+    if (num_frames == 0)
+        return;
+    const size_t frame = this->GetNewestFrame() - std::min(-ar_replay_pos, num_frames - 1);
+    ChunkView chunk;
+    if (!this->FindChunk(frame, chunk))
+        return;
 
-            m_actor->updateSlideNodePositions();
-            m_actor->UpdateBoundingBoxes();
-            m_actor->calculateAveragePosition();
+    // Decode forward from the chunk start, or from the last decoded frame if that's on the way
+    size_t next_frame = m_play_frame + 1;
+    if (chunk.first_frame != m_play_chunk_first_frame || m_play_frame == SIZE_MAX || frame < m_play_frame)
+    {
+        m_play_tracks.clear();
+        m_play_chunk_first_frame = chunk.first_frame;
+        next_frame = chunk.first_frame;
+    }
+    for (size_t f = next_frame; f <= frame; f++)
+    {
+        const size_t index = f - chunk.first_frame;
+        const size_t begin = chunk.frame_offsets[index];
+        const size_t end = (index + 1 < chunk.num_frames) ? chunk.frame_offsets[index + 1] : chunk.data_size;
+        if (!this->DecodeFrame(chunk.data + begin, end - begin, f))
+        {
+            LOG("replay: malformed frame " + TOSTRING(f));
+            m_play_tracks.clear();
+            m_play_frame = SIZE_MAX;
+            return;
+        }
+        m_play_frame = f;
+    }
+
+    const float dt = static_cast<float>(m_play_time_us - m_play_prev_time_us) / 1000000.0f;
+    const float step = m_file_reader.IsOpen() ? m_file_reader.GetHeader().quantization : m_quantization;
+    for (Actor* actor: actors)
+    {
+        if (actor->ar_sim_state != Actor::SimState::LOCAL_REPLAY)
+            continue;
+        int recorded_id = actor->ar_instance_id;
+        if (m_file_reader.IsOpen())
+        {
+            auto mapping = m_file_actor_ids.find(actor->ar_instance_id);
+            if (mapping == m_file_actor_ids.end())
+                continue;
+            recorded_id = mapping->second;
+        }
+        auto itor = m_play_tracks.find(recorded_id);
+        if (itor == m_play_tracks.end() || itor->second.last_frame != frame ||
+            itor->second.num_nodes != static_cast<uint32_t>(actor->ar_num_nodes) ||
+            itor->second.num_beams != static_cast<uint32_t>(actor->ar_num_beams))
+        {
+            continue;
         }
 
-        beam_simple_t* bbuff = (beam_simple_t *)this->getReadBuffer(ar_replay_pos, 1, time);
-        if (bbuff)
+        Track const& track = itor->second;
+        const bool has_velocity = (track.history == 2 && dt > 0.0f);
+        for (int i = 0; i < actor->ar_num_nodes; i++)
         {
-            for (int i = 0; i < m_actor->ar_num_beams; i++)
+            const Vector3 pos(track.pos[i * 3 + 0] * step, track.pos[i * 3 + 1] * step, track.pos[i * 3 + 2] * step);
+            actor->ar_nodes[i].AbsPosition = pos;
+            actor->ar_nodes[i].RelPosition = pos - actor->ar_origin;
+
+            if (has_velocity)
+            {
+                const Vector3 prev(track.prev_pos[i * 3 + 0] * step, track.prev_pos[i * 3 + 1] * step, track.prev_pos[i * 3 + 2] * step);
+                actor->ar_nodes[i].Velocity = (pos - prev) / dt;
+            }
+            else
             {
-                m_actor->ar_beams[i].bm_broken = bbuff[i].broken;
-                m_actor->ar_beams[i].bm_disabled = bbuff[i].disabled;
+                actor->ar_nodes[i].Velocity = Vector3::ZERO;
             }
+            actor->ar_nodes[i].Forces = Vector3::ZERO;
+        }
+
+        actor->updateSlideNodePositions();
+        actor->UpdateBoundingBoxes();
+        actor->calculateAveragePosition();
+
+        for (int i = 0; i < actor->ar_num_beams; i++)
+        {
+            actor->ar_beams[i].bm_broken = (track.beams[i] & 1) != 0;
+            actor->ar_beams[i].bm_disabled = (track.beams[i] & 2) != 0;
         }
-        m_replay_pos_prev = ar_replay_pos;
     }
 }
 
@@ -250,15 +573,15 @@ void Replay::UpdateInputEvents()
 {
     if (App::GetInputEngine()->getEventBoolValueBounce(EV_COMMON_TOGGLE_REPLAY_MODE))
     {
-        if (m_actor->ar_sim_state == Actor::SimState::LOCAL_REPLAY)
-            m_actor->ar_sim_state = Actor::SimState::LOCAL_SIMULATED;
+        if (m_file_reader.IsOpen())
+            this->UnloadFile();
         else
-            m_actor->ar_sim_state = Actor::SimState::LOCAL_REPLAY;
+            this->SetReplaying(!m_replaying, App::GetGameContext()->GetActorManager()->GetActors());
     }
 
-    if (m_actor->ar_sim_state == Actor::SimState::LOCAL_REPLAY)
+    if (m_replaying)
     {
-        if (App::GetInputEngine()->getEventBoolValueBounce(EV_COMMON_REPLAY_FORWARD, 0.1f) && this->ar_replay_pos <= 0)
+        if (App::GetInputEngine()->getEventBoolValueBounce(EV_COMMON_REPLAY_FORWARD, 0.1f) && this->ar_replay_pos < 0)
         {
             this->ar_replay_pos++;
         }
@@ -299,3 +622,117 @@ void Replay::UpdateInputEvents()
         }
     }
 }
+
+void Replay::SetReplaying(bool replaying, std::vector<Actor*> const& actors)
+{
+    // The whole scene goes into replay mode, not just the player's actor
+    m_replaying = replaying;
+    m_replay_pos_prev = 1;
+    for (Actor* actor: actors)
+    {
+        if (m_replaying && IsRecorded(actor))
+            actor->ar_sim_state = Actor::SimState::LOCAL_REPLAY;
+        else if (!m_replaying && actor->ar_sim_state == Actor::SimState::LOCAL_REPLAY)
+            actor->ar_sim_state = Actor::SimState::LOCAL_SIMULATED;
+    }
+}
+
+void Replay::ResetPlayback()
+{
+    m_play_tracks.clear();
+    m_play_frame = SIZE_MAX;
+    m_play_chunk_first_frame = SIZE_MAX;
+    m_play_time_us = 0;
+    m_play_prev_time_us = 0;
+    m_replay_pos_prev = 1;
+}
+
+bool Replay::SaveFile(std::string const& path)
+{
+    this->StopSaving();
+    if (!m_file_writer.Open(path, m_quantization, m_steps_per_frame * PHYSICS_DT))
+        return false;
+
+    for (auto& entry: m_actor_infos)
+    {
+        m_file_writer.WriteActor(entry.second);
+    }
+
+    // What's in memory goes first, oldest to newest; the head chunk is written once it's full, see StartChunk()
+    for (size_t i = m_num_chunks; i > 1; i--)
+    {
+        this->WriteChunk(m_chunks[(m_head_chunk + m_chunks.size() + 1 - i) % m_chunks.size()]);
+    }
+    return true;
+}
+
+void Replay::StopSaving()
+{
+    if (!m_file_writer.IsOpen())
+        return;
+
+    if (m_num_chunks > 0)
+        this->WriteChunk(m_chunks[m_head_chunk]);
+    m_file_writer.Finish();
+}
+
+bool Replay::LoadFile(std::string const& path, std::vector<Actor*> const& actors)
+{
+    this->UnloadFile();
+    if (!m_file_reader.Open(path))
+        return false;
+
+    // An actor re-spawned with a different structure is in the file twice, the later one is current
+    std::map<int, ReplayFileActor> recorded;
+    for (ReplayFileActor const& info: m_file_reader.GetActors())
+    {
+        recorded[info.instance_id] = info;
+    }
+
+    // Each recorded actor plays on a spawned actor with the same truckfile and structure, none is used twice
+    for (auto& entry: recorded)
+    {
+        ReplayFileActor const& info = entry.second;
+        const std::string hash(info.file_hash, std::find(info.file_hash, info.file_hash + sizeof(info.file_hash), '\0'));
+        for (Actor* actor: actors)
+        {
+            if ((IsRecorded(actor) || actor->ar_sim_state == Actor::SimState::LOCAL_REPLAY) &&
+                actor->ar_filehash == hash &&
+                actor->ar_num_nodes == static_cast<int>(info.num_nodes) &&
+                actor->ar_num_beams == static_cast<int>(info.num_beams) &&
+                m_file_actor_ids.find(actor->ar_instance_id) == m_file_actor_ids.end())
+            {
+                m_file_actor_ids[actor->ar_instance_id] = info.instance_id;
+                break;
+            }
+        }
+    }
+
+    if (m_file_actor_ids.empty())
+    {
+        RoR::LogFormat("[RoR|Replay] '%s': none of the %d recorded actors is spawned", path.c_str(), (int)recorded.size());
+        m_file_reader.Close();
+        return false;
+    }
+
+    m_file_path = path;
+    this->ResetPlayback();
+    this->SetReplaying(true, actors);
+    ar_replay_pos = 1 - this->getNumFrames(); // From the start
+    RoR::LogFormat("[RoR|Replay] Loaded '%s': %d frames, %d of %d recorded actors matched",
+        path.c_str(), this->getNumFrames(), (int)m_file_actor_ids.size(), (int)recorded.size());
+    return true;
+}
+
+void Replay::UnloadFile()
+{
+    if (!m_file_reader.IsOpen())
+        return;
+
+    m_file_reader.Close();
+    m_file_path.clear();
+    m_file_actor_ids.clear();
+    this->ResetPlayback();
+    ar_replay_pos = 0;
+    this->SetReplaying(false, App::GetGameContext()->GetActorManager()->GetActors());
+}
@@ -21,57 +21,163 @@
 #pragma once
 
 #include "Application.h"
+#include "ReplayFile.h"
+
+#include <cstdint>
+#include <map>
+#include <vector>
 
 namespace RoR {
 
-struct node_simple_t
+#pragma pack(push, 1)
+
+struct ReplayFrameHeader
 {
-    Ogre::Vector3 position;
-    Ogre::Vector3 velocity;
+    uint64_t time_us;      //!< Simulation time since the recording started
+    uint16_t num_actors;   //!< ReplayActorHeader + data for each
 };
 
-struct beam_simple_t
+/// Followed by `data_size` bytes of bitstream: Exp-Golomb coded residuals of the quantized node positions
+/// (3 per node, unless REPLAY_ACTOR_UNCHANGED), then 2 bits per beam (broken, disabled) if REPLAY_ACTOR_BEAMS.
+struct ReplayActorHeader
 {
-    bool broken:1;
-    bool disabled:1;
+    int32_t  instance_id;  //!< `Actor::ar_instance_id`
+    uint32_t num_nodes;
+    uint32_t num_beams;
+    uint32_t data_size;
+    uint8_t  flags;        //!< REPLAY_ACTOR_*
+    uint8_t  golomb_k;
 };
 
+#pragma pack(pop)
+
+static const uint8_t REPLAY_ACTOR_KEY       = 0x1; //!< Nodes predicted from the previous node; otherwise from the actor's previous frame(s)
+static const uint8_t REPLAY_ACTOR_UNCHANGED = 0x2; //!< Same node positions as in the previous frame, no residuals
+static const uint8_t REPLAY_ACTOR_BEAMS     = 0x4; //!< Beam states follow; otherwise they didn't change
+static const uint8_t REPLAY_ACTOR_LINEAR    = 0x8; //!< Nodes predicted by extrapolating the two previous frames; otherwise the previous frame is the prediction
+
+static const size_t REPLAY_CHUNK_SIZE       = 512 * 1024; //!< Bytes; frames which don't fit start a new chunk
+static const int    REPLAY_CHUNK_MAX_FRAMES = 256;        //!< Bounds the decoding work for seeking within a chunk
+static const int    REPLAY_MAX_COORD        = 1 << 26;    //!< Quantized positions are clamped to +/- this
+
+/// Records the local actors of the scene for the replay mode (see `ActorManager::PrepareActorsForStep()`)
+/// and plays them back.
+///
+/// Frames are stored in a ring of fixed-size chunks, oldest chunk is overwritten when `sim_replay_memory` runs out.
+/// Node positions are quantized to `sim_replay_quantization` and coded as residuals to a prediction from the actor's
+/// previous frames; every chunk starts with a keyframe of all actors, so that it can be decoded on its own.
+/// Velocities are not stored, playback derives them from consecutive frames.
+///
+/// The chunks can also be streamed to a file (see ReplayFile.h) while the game runs, and such a file can be
+/// played back later on matching actors; it's memory-mapped, so only the chunks being decoded get paged in.
 class Replay : public ZeroedMemoryAllocator
 {
 public:
-    Replay(Actor* b, int nframes);
+    Replay();
     ~Replay();
 
-    void*               getWriteBuffer(int type);
-    void*               getReadBuffer(int offset, int type, unsigned long& time);
-    unsigned long       getLastReadTime();
-    void                writeDone();
-    void                onPhysicsStep();
-    void                replayStepActor();
-    float               getPrecision() const { return ar_replay_precision; }
-    float               getReplayPositionSec() const { return ((float)curFrameTime) / 1000000.0f; }
-    int                 getNumFrames() const { return numFrames; }
+    void                onPhysicsStep(std::vector<Actor*> const& actors); //!< Records a frame every `sim_replay_stepping`th of a second
+    void                replayStepActors(std::vector<Actor*> const& actors); //!< Moves actors in LOCAL_REPLAY state to the current frame
+    unsigned long       getLastReadTime() const { return m_play_time_us; }
+    float               getPrecision() const; //!< Seconds between frames
+    float               getReplayPositionSec() const { return ((float)m_play_time_us) / 1000000.0f; }
+    int                 getNumFrames() const; //!< Frames available for playback
     int                 getCurrentFrame() const { return ar_replay_pos; }
-    bool                isValid() { return numFrames && !outOfMemory; };
+    size_t              getMemoryUsage() const; //!< Bytes
+    bool                isValid() const { return true; }
     void                UpdateInputEvents();
 
-protected:
-    Actor*              m_actor = nullptr;
-    float               m_replay_timer = 0.f;
+    // Files
+    bool                SaveFile(std::string const& path); //!< Writes what's in memory, then keeps appending chunks until StopSaving()
+    void                StopSaving();
+    bool                IsSaving() const { return m_file_writer.IsOpen(); }
+    ReplayFileWriter const& GetFileWriter() const { return m_file_writer; }
+    bool                LoadFile(std::string const& path, std::vector<Actor*> const& actors); //!< Plays the file on spawned actors with the same truckfile
+    void                UnloadFile(); //!< Back to the live recording
+    bool                IsFileLoaded() const { return m_file_reader.IsOpen(); }
+    std::string const&  GetLoadedFilePath() const { return m_file_path; }
+
+private:
+    struct Chunk
+    {
+        std::vector<uint8_t>  data;
+        std::vector<uint32_t> frame_offsets;
+        size_t                first_frame = 0;  //!< Serial number of the first frame
+    };
+
+    /// Actor state at the last frame which included it; the recorder and the player each have their own.
+    struct Track
+    {
+        uint32_t              num_nodes = 0;
+        uint32_t              num_beams = 0;
+        int                   history = 0;      //!< Frames in `pos` and `prev_pos`, up to 2; 0 forces a keyframe
+        size_t                last_frame = 0;
+        std::vector<int32_t>  pos;              //!< Quantized, 3 per node
+        std::vector<int32_t>  prev_pos;
+        std::vector<uint8_t>  beams;            //!< Bit 0 broken, bit 1 disabled
+    };
+
+    /// A chunk either from memory or from the loaded file
+    struct ChunkView
+    {
+        const uint8_t*        data = nullptr;
+        size_t                data_size = 0;
+        const uint32_t*       frame_offsets = nullptr;
+        size_t                num_frames = 0;
+        size_t                first_frame = 0;
+    };
+
+    /// Recorder scratch: an actor of the frame being encoded
+    struct FrameActor
+    {
+        Actor*                actor;
+        Track*                track;
+        size_t                pos_offset;       //!< Into `m_frame_pos`
+        size_t                beam_offset;      //!< Into `m_frame_beams`
+    };
+
+    void                EncodeFrame(bool keyframe);
+    void                CommitFrame();
+    Chunk&              StartChunk();
+    void                WriteChunk(Chunk const& chunk);
+    bool                FindChunk(size_t frame, ChunkView& out) const;
+    size_t              GetNewestFrame() const;
+    bool                DecodeFrame(const uint8_t* data, size_t size, size_t frame);
+    bool                IsKnownFileActor(ReplayActorHeader const& header) const; //!< Listed in the loaded file, same size
+    void                SetReplaying(bool replaying, std::vector<Actor*> const& actors);
+    void                ResetPlayback();
+
+    // Recording
+    std::vector<Chunk>  m_chunks;               //!< Ring, sized by `sim_replay_memory`
+    size_t              m_head_chunk = 0;       //!< Being written
+    size_t              m_num_chunks = 0;       //!< In use
+    size_t              m_num_frames = 0;       //!< Recorded since the start
     float               ar_replay_precision = 1.f;
-    int                 ar_replay_pos = 0;
-    int                 m_replay_pos_prev = 0;
-    Ogre::Timer*        replayTimer;
-    int                 numFrames;
-    bool                outOfMemory;
-    int                 writeIndex;
-    int                 firstRun;
-    unsigned long       curFrameTime;
-
-    // malloc'ed
-    node_simple_t*      nodes;
-    beam_simple_t*      beams;
-    unsigned long*      times;
+    int                 m_steps_per_frame = 1;  //!< Whole physics steps, so that frames are evenly spaced for the prediction
+    int                 m_steps_to_frame = 0;
+    uint64_t            m_num_steps = 0;        //!< Recorded since the start
+    float               m_quantization = 0.001f;
+    std::map<int, Track> m_rec_tracks;
+    std::vector<FrameActor> m_frame_actors;
+    std::vector<int32_t> m_frame_pos;
+    std::vector<uint8_t> m_frame_beams;
+    std::vector<uint32_t> m_residuals;
+    std::vector<uint8_t> m_frame_data;
+    std::map<int, ReplayFileActor> m_actor_infos; //!< Every actor recorded so far, for the file
+    ReplayFileWriter    m_file_writer;
+
+    // Playback
+    int                 ar_replay_pos = 0;      //!< Frames back from the newest; 0 or negative
+    int                 m_replay_pos_prev = 1;  //!< Forces an update
+    bool                m_replaying = false;
+    size_t              m_play_chunk_first_frame = SIZE_MAX;
+    size_t              m_play_frame = SIZE_MAX; //!< Last decoded
+    unsigned long       m_play_time_us = 0;
+    uint64_t            m_play_prev_time_us = 0;
+    std::map<int, Track> m_play_tracks;
+    ReplayFileReader    m_file_reader;
+    std::string         m_file_path;
+    std::map<int, int>  m_file_actor_ids;       //!< Spawned actor instance ID -> recorded instance ID
 };
 
 } // namespace RoR
@@ -0,0 +1,347 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ReplayFile.h"
+
+#include "Application.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace RoR;
+
+namespace {
+
+inline uint32_t GetPadding(uint64_t size) { return static_cast<uint32_t>((8 - size % 8) % 8); }
+
+inline void Append(std::vector<uint8_t>& buf, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    buf.insert(buf.end(), bytes, bytes + size);
+}
+
+} // namespace
+
+// -------------------------- Writer --------------------------
+
+bool ReplayFileWriter::Open(std::string const& path, float quantization, float frame_interval)
+{
+    this->Finish();
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (m_file == nullptr)
+    {
+        RoR::LogFormat("[RoR|Replay] Cannot create '%s'", path.c_str());
+        return false;
+    }
+    m_path = path;
+    m_offset = 0;
+    m_failed = false;
+    m_actors.clear();
+    m_index.clear();
+    if (!m_write_thread_pool)
+        m_write_thread_pool = std::unique_ptr<ThreadPool>(new ThreadPool(1));
+
+    std::memset(&m_header, 0, sizeof(ReplayFileHeader));
+    std::memcpy(m_header.magic, REPLAY_FILE_MAGIC, sizeof(REPLAY_FILE_MAGIC));
+    m_header.version = REPLAY_FILE_VERSION;
+    m_header.quantization = quantization;
+    m_header.frame_interval = frame_interval;
+    this->Write(&m_header, sizeof(ReplayFileHeader));
+    return !m_failed;
+}
+
+void ReplayFileWriter::WriteActor(ReplayFileActor const& actor)
+{
+    if (m_file == nullptr)
+        return;
+
+    this->WaitForWrite();
+    m_actors.push_back(actor);
+    this->BeginBlock(REPLAY_BLOCK_ACTOR, sizeof(ReplayFileActor));
+    this->Write(&actor, sizeof(ReplayFileActor));
+    this->EndBlock(sizeof(ReplayFileActor));
+}
+
+void ReplayFileWriter::WriteChunk(uint64_t first_frame, const uint32_t* frame_offsets, uint32_t num_frames, const uint8_t* data, uint32_t data_size)
+{
+    if (m_file == nullptr || num_frames == 0)
+        return;
+
+    this->WaitForWrite(); // Usually long done; chunks take seconds to fill
+
+    ReplayFileIndexEntry entry;
+    entry.block_offset = m_offset + sizeof(ReplayFileBlock);
+    entry.first_frame = first_frame;
+    entry.num_frames = num_frames;
+    entry.data_size = data_size;
+    m_index.push_back(entry);
+
+    ReplayFileChunk chunk;
+    chunk.first_frame = first_frame;
+    chunk.num_frames = num_frames;
+    chunk.data_size = data_size;
+
+    ReplayFileBlock block;
+    block.type = REPLAY_BLOCK_CHUNK;
+    block.size = static_cast<uint32_t>(sizeof(ReplayFileChunk) + num_frames * sizeof(uint32_t) + data_size);
+    const uint8_t zeros[8] = {};
+
+    // The caller reuses its buffers right away, so the block is assembled in a copy
+    m_chunk_buffer.clear();
+    Append(m_chunk_buffer, &block, sizeof(ReplayFileBlock));
+    Append(m_chunk_buffer, &chunk, sizeof(ReplayFileChunk));
+    Append(m_chunk_buffer, frame_offsets, num_frames * sizeof(uint32_t));
+    Append(m_chunk_buffer, data, data_size);
+    Append(m_chunk_buffer, zeros, GetPadding(block.size));
+    m_offset += m_chunk_buffer.size();
+
+    m_write_task = m_write_thread_pool->RunTask([this]()
+        {
+            if (std::fwrite(m_chunk_buffer.data(), 1, m_chunk_buffer.size(), m_file) != m_chunk_buffer.size() ||
+                std::fflush(m_file) != 0)
+            {
+                m_failed = true;
+            }
+        });
+}
+
+void ReplayFileWriter::Finish()
+{
+    if (m_file == nullptr)
+        return;
+
+    this->WaitForWrite();
+    m_header.index_offset = m_offset;
+    m_header.num_actors = static_cast<uint32_t>(m_actors.size());
+    m_header.num_chunks = m_index.size();
+
+    const uint32_t size = static_cast<uint32_t>(m_actors.size() * sizeof(ReplayFileActor) + m_index.size() * sizeof(ReplayFileIndexEntry));
+    this->BeginBlock(REPLAY_BLOCK_INDEX, size);
+    this->Write(m_actors.data(), m_actors.size() * sizeof(ReplayFileActor));
+    this->Write(m_index.data(), m_index.size() * sizeof(ReplayFileIndexEntry));
+    this->EndBlock(size);
+
+    // The header goes last; until then, readers see an unfinished file and scan it
+    if (std::fseek(m_file, 0, SEEK_SET) != 0 || std::fwrite(&m_header, sizeof(ReplayFileHeader), 1, m_file) != 1)
+        m_failed = true;
+    if (std::fclose(m_file) != 0)
+        m_failed = true;
+    m_file = nullptr;
+
+    if (m_failed)
+        RoR::LogFormat("[RoR|Replay] Error writing '%s', the replay may be incomplete", m_path.c_str());
+    else
+        RoR::LogFormat("[RoR|Replay] Saved '%s' (%d chunks, %d actors)", m_path.c_str(), (int)m_index.size(), (int)m_actors.size());
+}
+
+void ReplayFileWriter::BeginBlock(uint32_t type, uint32_t size)
+{
+    ReplayFileBlock block;
+    block.type = type;
+    block.size = size;
+    this->Write(&block, sizeof(ReplayFileBlock));
+}
+
+void ReplayFileWriter::Write(const void* data, size_t size)
+{
+    if (size > 0 && std::fwrite(data, 1, size, m_file) != size)
+        m_failed = true;
+    m_offset += size;
+}
+
+void ReplayFileWriter::EndBlock(uint32_t size)
+{
+    const uint8_t zeros[8] = {};
+    this->Write(zeros, GetPadding(size));
+}
+
+// -------------------------- Reader --------------------------
+
+bool ReplayFileReader::Open(std::string const& path)
+{
+    this->Close();
+    if (!m_file.Open(path))
+        return false;
+
+    bool valid = (m_file.GetSize() >= sizeof(ReplayFileHeader));
+    if (valid)
+    {
+        std::memcpy(&m_header, m_file.GetData(), sizeof(ReplayFileHeader));
+        valid = std::memcmp(m_header.magic, REPLAY_FILE_MAGIC, sizeof(REPLAY_FILE_MAGIC)) == 0
+             && m_header.version == REPLAY_FILE_VERSION
+             && m_header.quantization > 0.f;
+    }
+    if (valid)
+    {
+        if (m_header.index_offset == 0 || !this->ReadIndex())
+        {
+            RoR::LogFormat("[RoR|Replay] '%s' has no valid index (unfinished recording?), scanning it", path.c_str());
+            valid = this->ScanBlocks();
+        }
+        valid = valid && !m_chunks.empty();
+    }
+
+    if (!valid)
+    {
+        RoR::LogFormat("[RoR|Replay] '%s' is not a valid replay file", path.c_str());
+        this->Close();
+        return false;
+    }
+    return true;
+}
+
+void ReplayFileReader::Close()
+{
+    m_file.Close();
+    m_actors.clear();
+    m_chunks.clear();
+}
+
+bool ReplayFileReader::ReadIndex()
+{
+    const uint64_t file_size = m_file.GetSize();
+    if (m_header.index_offset % 8 != 0 || m_header.index_offset + sizeof(ReplayFileBlock) > file_size)
+        return false;
+
+    ReplayFileBlock block;
+    std::memcpy(&block, m_file.GetData() + m_header.index_offset, sizeof(ReplayFileBlock));
+    const uint64_t payload = m_header.index_offset + sizeof(ReplayFileBlock);
+    // Counts are bounded by the file size first, so that the size check below can't overflow
+    if (block.type != REPLAY_BLOCK_INDEX || block.size > file_size - payload ||
+        m_header.num_actors > block.size / sizeof(ReplayFileActor) ||
+        m_header.num_chunks > block.size / sizeof(ReplayFileIndexEntry) ||
+        block.size != m_header.num_actors * sizeof(ReplayFileActor) + m_header.num_chunks * sizeof(ReplayFileIndexEntry))
+    {
+        return false;
+    }
+
+    m_actors.resize(m_header.num_actors);
+    std::memcpy(m_actors.data(), m_file.GetData() + payload, m_actors.size() * sizeof(ReplayFileActor));
+
+    m_chunks.resize(static_cast<size_t>(m_header.num_chunks));
+    const uint8_t* entries = m_file.GetData() + payload + m_actors.size() * sizeof(ReplayFileActor);
+    for (size_t i = 0; i < m_chunks.size(); i++)
+    {
+        ReplayFileIndexEntry entry;
+        std::memcpy(&entry, entries + i * sizeof(ReplayFileIndexEntry), sizeof(ReplayFileIndexEntry));
+        if (!this->CheckChunk(entry.block_offset, m_chunks[i]) || m_chunks[i].first_frame != entry.first_frame ||
+            (i > 0 && entry.first_frame < m_chunks[i - 1].first_frame + m_chunks[i - 1].num_frames))
+        {
+            m_actors.clear();
+            m_chunks.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ReplayFileReader::ScanBlocks()
+{
+    m_actors.clear();
+    m_chunks.clear();
+
+    const uint64_t file_size = m_file.GetSize();
+    uint64_t offset = sizeof(ReplayFileHeader);
+    while (offset + sizeof(ReplayFileBlock) <= file_size)
+    {
+        ReplayFileBlock block;
+        std::memcpy(&block, m_file.GetData() + offset, sizeof(ReplayFileBlock));
+        const uint64_t payload = offset + sizeof(ReplayFileBlock);
+        if (block.size > file_size - payload)
+            break; // Truncated by a crash; keep what we have
+
+        if (block.type == REPLAY_BLOCK_ACTOR && block.size >= sizeof(ReplayFileActor))
+        {
+            ReplayFileActor actor;
+            std::memcpy(&actor, m_file.GetData() + payload, sizeof(ReplayFileActor));
+            m_actors.push_back(actor);
+        }
+        else if (block.type == REPLAY_BLOCK_CHUNK)
+        {
+            ReplayFileIndexEntry entry;
+            if (!this->CheckChunk(payload, entry))
+                break;
+            if (!m_chunks.empty() && entry.first_frame < m_chunks.back().first_frame + m_chunks.back().num_frames)
+                return false;
+            m_chunks.push_back(entry);
+        }
+        offset = payload + block.size + GetPadding(block.size);
+    }
+    return true;
+}
+
+bool ReplayFileReader::CheckChunk(uint64_t block_offset, ReplayFileIndexEntry& out) const
+{
+    const uint64_t file_size = m_file.GetSize();
+    if (block_offset % 8 != 0 || block_offset + sizeof(ReplayFileChunk) > file_size)
+        return false;
+
+    ReplayFileChunk chunk;
+    std::memcpy(&chunk, m_file.GetData() + block_offset, sizeof(ReplayFileChunk));
+    const uint64_t offsets_pos = block_offset + sizeof(ReplayFileChunk);
+    if (chunk.num_frames == 0 || offsets_pos + uint64_t(chunk.num_frames) * sizeof(uint32_t) + chunk.data_size > file_size)
+        return false;
+
+    // Frame boundaries must be in order, so that DecodeFrame() gets proper sizes
+    const uint32_t* offsets = reinterpret_cast<const uint32_t*>(m_file.GetData() + offsets_pos);
+    for (uint32_t i = 0; i < chunk.num_frames; i++)
+    {
+        if (offsets[i] >= chunk.data_size || (i > 0 && offsets[i] < offsets[i - 1]))
+            return false;
+    }
+
+    out.block_offset = block_offset;
+    out.first_frame = chunk.first_frame;
+    out.num_frames = chunk.num_frames;
+    out.data_size = chunk.data_size;
+    return true;
+}
+
+uint64_t ReplayFileReader::GetFirstFrame() const
+{
+    return m_chunks.empty() ? 0 : m_chunks.front().first_frame;
+}
+
+uint64_t ReplayFileReader::GetNumFrames() const
+{
+    return m_chunks.empty() ? 0 : m_chunks.back().first_frame + m_chunks.back().num_frames - m_chunks.front().first_frame;
+}
+
+int ReplayFileReader::FindChunk(uint64_t frame) const
+{
+    auto itor = std::upper_bound(m_chunks.begin(), m_chunks.end(), frame,
+        [](uint64_t f, ReplayFileIndexEntry const& entry) { return f < entry.first_frame; });
+    if (itor == m_chunks.begin())
+        return -1;
+    --itor;
+    if (frame >= itor->first_frame + itor->num_frames)
+        return -1;
+    return static_cast<int>(itor - m_chunks.begin());
+}
+
+const uint32_t* ReplayFileReader::GetFrameOffsets(int chunk) const
+{
+    return reinterpret_cast<const uint32_t*>(m_file.GetData() + m_chunks[chunk].block_offset + sizeof(ReplayFileChunk));
+}
+
+const uint8_t* ReplayFileReader::GetFrameData(int chunk) const
+{
+    return reinterpret_cast<const uint8_t*>(this->GetFrameOffsets(chunk) + m_chunks[chunk].num_frames);
+}
@@ -0,0 +1,163 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief On-disk replays, see `Replay`.
+///
+/// Layout: ReplayFileHeader, then blocks (ReplayFileBlock + payload, padded to 8 bytes):
+/// - REPLAY_BLOCK_ACTOR: ReplayFileActor; written when an actor is first recorded.
+/// - REPLAY_BLOCK_CHUNK: ReplayFileChunk, uint32 frame offsets, then the frames exactly as `Replay` keeps them in memory.
+/// - REPLAY_BLOCK_INDEX: all ReplayFileActor entries, then a ReplayFileIndexEntry per chunk; written last.
+/// Blocks are appended while the game runs, so a file which wasn't finished (crash) has no index;
+/// readers then scan the blocks instead.
+
+#pragma once
+
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace RoR {
+
+static const char     REPLAY_FILE_MAGIC[8] = {'R', 'O', 'R', 'R', 'P', 'L', 'Y', '\0'};
+static const uint32_t REPLAY_FILE_VERSION = 1;
+
+enum ReplayFileBlockType: uint32_t
+{
+    REPLAY_BLOCK_ACTOR = 1,
+    REPLAY_BLOCK_CHUNK = 2,
+    REPLAY_BLOCK_INDEX = 3,
+};
+
+#pragma pack(push, 1)
+
+struct ReplayFileHeader
+{
+    char     magic[8];
+    uint32_t version;
+    float    quantization;   //!< Meters per step of the quantized node positions
+    float    frame_interval; //!< Seconds between frames
+    uint32_t num_actors;     //!< In the index
+    uint64_t num_chunks;     //!< In the index
+    uint64_t index_offset;   //!< 0 until the file is finished
+    uint64_t _reserved;
+};
+
+struct ReplayFileBlock
+{
+    uint32_t type;           //!< ReplayFileBlockType
+    uint32_t size;           //!< Payload bytes, without padding
+};
+
+struct ReplayFileActor
+{
+    int32_t  instance_id;    //!< `ReplayActorHeader::instance_id`
+    uint32_t num_nodes;
+    uint32_t num_beams;
+    char     file_hash[48];  //!< SHA1 of the truckfile, hex
+    char     file_name[128];
+    uint32_t _pad;
+};
+
+struct ReplayFileChunk
+{
+    uint64_t first_frame;
+    uint32_t num_frames;
+    uint32_t data_size;
+};
+
+struct ReplayFileIndexEntry
+{
+    uint64_t block_offset;   //!< Of the ReplayFileChunk
+    uint64_t first_frame;
+    uint32_t num_frames;
+    uint32_t data_size;
+};
+
+#pragma pack(pop)
+
+/// Appends blocks with stdio; buffered, but flushed after every chunk so that a crash loses at most the last one.
+/// Chunks are copied and written on a background thread, so that the recorder (sim thread) doesn't wait for the disk.
+class ReplayFileWriter
+{
+public:
+    ~ReplayFileWriter() { this->Finish(); }
+
+    bool               Open(std::string const& path, float quantization, float frame_interval);
+    void               WriteActor(ReplayFileActor const& actor);
+    void               WriteChunk(uint64_t first_frame, const uint32_t* frame_offsets, uint32_t num_frames, const uint8_t* data, uint32_t data_size);
+    void               Finish(); //!< Writes the index and closes the file
+
+    bool               IsOpen() const     { return m_file != nullptr; }
+    std::string const& GetPath() const    { return m_path; }
+    uint64_t           GetNumBytes() const { return m_offset; }
+
+private:
+    void               BeginBlock(uint32_t type, uint32_t size);
+    void               Write(const void* data, size_t size);
+    void               EndBlock(uint32_t size);
+    void               WaitForWrite() { m_write_task.join(); } //!< Must precede any other use of `m_file`, `m_failed` and `m_chunk_buffer`
+
+    std::FILE*                        m_file = nullptr;
+    std::string                       m_path;
+    uint64_t                          m_offset = 0;     //!< Advanced by the caller, also for chunks still being written
+    bool                              m_failed = false;
+    std::vector<uint8_t>              m_chunk_buffer;   //!< Whole block being written by `m_write_task`
+    std::unique_ptr<ThreadPool>       m_write_thread_pool; //!< Single thread, created by Open()
+    TaskHandle                        m_write_task;
+    ReplayFileHeader                  m_header;
+    std::vector<ReplayFileActor>      m_actors;
+    std::vector<ReplayFileIndexEntry> m_index;
+};
+
+/// Maps the file and validates its structure; frame data is only touched during playback.
+class ReplayFileReader
+{
+public:
+    bool               Open(std::string const& path);
+    void               Close();
+
+    bool               IsOpen() const { return m_file.IsOpen(); }
+    ReplayFileHeader const& GetHeader() const { return m_header; }
+    std::vector<ReplayFileActor> const& GetActors() const { return m_actors; }
+    std::vector<ReplayFileIndexEntry> const& GetChunks() const { return m_chunks; }
+    uint64_t           GetFirstFrame() const;
+    uint64_t           GetNumFrames() const;
+    int                FindChunk(uint64_t frame) const; //!< Returns -1 if not found
+
+    const uint32_t*    GetFrameOffsets(int chunk) const;
+    const uint8_t*     GetFrameData(int chunk) const;
+
+private:
+    bool               ReadIndex();
+    bool               ScanBlocks();
+    bool               CheckChunk(uint64_t block_offset, ReplayFileIndexEntry& out) const;
+
+    MappedFile                        m_file;
+    ReplayFileHeader                  m_header;
+    std::vector<ReplayFileActor>      m_actors;
+    std::vector<ReplayFileIndexEntry> m_chunks;
+};
+
+} // namespace RoR
@@ -50,6 +50,8 @@
 
 #include <Ogre.h>
 
+static const int FLEXBODY_CHUNK_SIZE = 4096; //!< Vertices per work item of the flexbody update; multiple of the SIMD width
+
 RoR::GfxActor::GfxActor(Actor* actor, ActorSpawner* spawner, std::string ogre_resource_group,
                         std::vector<NodeGfx>& gfx_nodes, RoR::Renderdash* renderdash):
     m_actor(actor),
@@ -76,7 +78,11 @@ RoR::GfxActor::GfxActor(Actor* actor, ActorSpawner* spawner, std::string ogre_re
     m_particles_sparks = App::GetGfxScene()->GetDustPool("sparks");
     m_particles_clump  = App::GetGfxScene()->GetDustPool("clump");
 
-    m_simbuf.simbuf_nodes.reset(new SimBuffer::NodeSB[actor->ar_num_nodes]);
+    for (auto& snapshot: m_node_snapshots)
+    {
+        snapshot.reset(new SimBuffer::NodeSB[actor->ar_num_nodes]());
+    }
+    m_simbuf.simbuf_nodes = m_node_snapshots[m_node_snapshot_front].get();
     m_simbuf.simbuf_aeroengines.resize(actor->ar_num_aeroengines);
     m_simbuf.simbuf_commandkey.resize(MAX_COMMANDS + 10);
     m_simbuf.simbuf_airbrakes.resize(spawner->GetMemoryRequirements().num_airbrakes);
@@ -432,7 +438,7 @@ void RoR::GfxActor::UpdateVideoCameras(float dt_sec)
             vidcam.vcam_render_window->update();
 
         // get the normal of the camera plane now
-        GfxActor::SimBuffer::NodeSB* node_buf = m_simbuf.simbuf_nodes.get();
+        GfxActor::SimBuffer::NodeSB* node_buf = m_simbuf.simbuf_nodes;
         const Ogre::Vector3 abs_pos_center = node_buf[vidcam.vcam_node_center].AbsPosition;
         const Ogre::Vector3 abs_pos_z = node_buf[vidcam.vcam_node_dir_z].AbsPosition;
         const Ogre::Vector3 abs_pos_y = node_buf[vidcam.vcam_node_dir_y].AbsPosition;
@@ -1751,18 +1757,16 @@ void RoR::GfxActor::UpdateSimDataBuffer()
     m_simbuf.simbuf_net_username = m_actor->m_net_username;
     m_simbuf.simbuf_is_remote = m_actor->ar_sim_state == Actor::SimState::NETWORKED_OK;
 
-    // nodes
-    const int num_nodes = m_actor->ar_num_nodes;
-    for (int i = 0; i < num_nodes; ++i)
+    // nodes - written by physics, see WriteSimNodeSnapshot()
+    if (m_node_snapshot_ready.load(std::memory_order_relaxed) & NODE_SNAPSHOT_FRESH)
     {
-        auto node = m_actor->ar_nodes[i];
-        m_simbuf.simbuf_nodes.get()[i].AbsPosition = node.AbsPosition;
-        m_simbuf.simbuf_nodes.get()[i].nd_has_contact = node.nd_has_ground_contact || node.nd_has_mesh_contact;
+        m_node_snapshot_front = m_node_snapshot_ready.exchange(m_node_snapshot_front, std::memory_order_acq_rel) & ~NODE_SNAPSHOT_FRESH;
+        m_simbuf.simbuf_nodes = m_node_snapshots[m_node_snapshot_front].get();
     }
 
     for (NodeGfx& nx: m_gfx_nodes)
     {
-        m_simbuf.simbuf_nodes.get()[nx.nx_node_idx].nd_is_wet = (nx.nx_wet_time_sec != -1.f);
+        m_simbuf.simbuf_nodes[nx.nx_node_idx].nd_is_wet = (nx.nx_wet_time_sec != -1.f);
     }
 
     // beams
@@ -1873,6 +1877,22 @@ void RoR::GfxActor::UpdateSimDataBuffer()
     }
 }
 
+void RoR::GfxActor::WriteSimNodeSnapshot()
+{
+    SimBuffer::NodeSB* nodes = m_node_snapshots[m_node_snapshot_write].get();
+    const int num_nodes = m_actor->ar_num_nodes;
+    for (int i = 0; i < num_nodes; ++i)
+    {
+        node_t const& node = m_actor->ar_nodes[i];
+        nodes[i].AbsPosition = node.AbsPosition;
+        nodes[i].nd_has_contact = node.nd_has_ground_contact || node.nd_has_mesh_contact;
+        nodes[i].nd_is_wet = false; // Wetness is visual state, filled by UpdateSimDataBuffer()
+    }
+
+    // Publish; if the renderer skipped the previous snapshot, its slot is reused
+    m_node_snapshot_write = m_node_snapshot_ready.exchange(m_node_snapshot_write | NODE_SNAPSHOT_FRESH, std::memory_order_acq_rel) & ~NODE_SNAPSHOT_FRESH;
+}
+
 bool RoR::GfxActor::IsActorLive() const
 {
     return (m_actor->ar_sim_state < Actor::SimState::LOCAL_SLEEPING);
@@ -1917,7 +1937,7 @@ void RoR::GfxActor::FinishWheelUpdates()
 {
     for (auto& task: m_flexwheel_tasks)
     {
-        task->join();
+        task.join();
     }
     for (WheelGfx& w: m_wheels)
     {
@@ -1996,7 +2016,7 @@ void RoR::GfxActor::RegisterProps(std::vector<Prop> const& props, int driverseat
 void RoR::GfxActor::UpdateAirbrakes()
 {
     const size_t num_airbrakes = m_gfx_airbrakes.size();
-    SimBuffer::NodeSB* nodes = m_simbuf.simbuf_nodes.get();
+    SimBuffer::NodeSB* nodes = m_simbuf.simbuf_nodes;
     for (size_t i=0; i<num_airbrakes; ++i)
     {
         AirbrakeGfx abx = m_gfx_airbrakes[i];
@@ -2026,7 +2046,7 @@ void RoR::GfxActor::UpdateAirbrakes()
 void RoR::GfxActor::UpdateCParticles()
 {
     //update custom particle systems
-    SimBuffer::NodeSB* nodes = m_simbuf.simbuf_nodes.get();
+    SimBuffer::NodeSB* nodes = m_simbuf.simbuf_nodes;
     for (int i = 0; i < m_actor->ar_num_custom_particles; i++)
     {
         Ogre::Vector3 pos = nodes[m_actor->ar_custom_particles[i].emitterNode].AbsPosition;
@@ -3127,26 +3147,33 @@ void RoR::GfxActor::UpdatePropAnimations(float dt, bool is_player_connected)
     }
 }
 
-void RoR::GfxActor::SortFlexbodies()
+void RoR::GfxActor::UpdateFlexbodies(std::vector<FlexBodyChunk>& chunks, FlexBodyStats& stats)
 {
-    std::sort(m_flexbodies.begin(), m_flexbodies.end(), [](FlexBody* a, FlexBody* b) { return a->size() > b->size(); });
-}
-
-void RoR::GfxActor::UpdateFlexbodies()
-{
-    m_flexbody_tasks.clear();
-
+    const Ogre::Vector3 camera_pos = App::GetCameraManager()->GetCameraNode()->getPosition();
     for (FlexBody* fb: m_flexbodies)
     {
         const int camera_mode = fb->getCameraMode();
         if ((camera_mode == -2) || (camera_mode == m_simbuf.simbuf_cur_cinecam))
         {
-            auto func = std::function<void()>([fb]()
-                {
-                    fb->ComputeFlexbody();
-                });
-            auto task_handle = App::GetThreadPool()->RunTask(func);
-            m_flexbody_tasks.push_back(task_handle);
+            const bool deform = fb->PrepareFlexbodyUpdate(camera_pos);
+            stats.fbs_num_visible++;
+            stats.fbs_vertices_visible += fb->size();
+            if (fb->GetLod() == FlexBody::Lod::REDUCED_RATE) { stats.fbs_num_reduced_rate++; }
+            if (fb->GetLod() == FlexBody::Lod::RIGID)        { stats.fbs_num_rigid++; }
+            if (!deform)
+            {
+                continue; // At rest, or skipped by LOD
+            }
+            stats.fbs_num_deformed++;
+            stats.fbs_vertices_deformed += fb->size();
+            for (int begin = 0; begin < fb->size(); begin += FLEXBODY_CHUNK_SIZE)
+            {
+                FlexBodyChunk chunk;
+                chunk.fbc_flexbody = fb;
+                chunk.fbc_begin = begin;
+                chunk.fbc_end = std::min(begin + FLEXBODY_CHUNK_SIZE, fb->size());
+                chunks.push_back(chunk);
+            }
         }
         else
         {
@@ -3171,12 +3198,28 @@ void RoR::GfxActor::SetFlexbodyVisible(bool visible)
     }
 }
 
-void RoR::GfxActor::FinishFlexbodyTasks()
+void RoR::GfxActor::ComputeFlexbodyChunks(std::vector<FlexBodyChunk>& chunks)
 {
-    for (auto& task: m_flexbody_tasks)
+    App::GetThreadPool()->ParallelFor(0, static_cast<int>(chunks.size()), 1, [&chunks](int begin, int end)
+    {
+        for (int i = begin; i < end; i++)
+        {
+            chunks[i].fbc_blend_changed = chunks[i].fbc_flexbody->ComputeFlexbodyVertices(chunks[i].fbc_begin, chunks[i].fbc_end);
+        }
+    });
+
+    // Each chunk wrote only its own result; merge them now that all are done
+    for (FlexBodyChunk const& chunk: chunks)
     {
-        task->join();
+        if (chunk.fbc_blend_changed)
+        {
+            chunk.fbc_flexbody->SetBlendChanged();
+        }
     }
+}
+
+void RoR::GfxActor::FinishFlexbodyUpdates()
+{
     for (FlexBody* fb: m_flexbodies)
     {
         fb->UpdateFlexbodyVertexBuffers();
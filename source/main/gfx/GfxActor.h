@@ -31,7 +31,7 @@
 #include "ForwardDeclarations.h"
 #include "GfxData.h"
 #include "RigDef_Prerequisites.h"
-#include "ThreadPool.h" // class Task
+#include "ThreadPool.h" // class TaskHandle
 
 #include <OgreAxisAlignedBox.h>
 #include <OgreColourValue.h>
@@ -39,6 +39,7 @@
 #include <OgreQuaternion.h>
 #include <OgreTexture.h>
 #include <OgreVector3.h>
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -111,7 +112,7 @@ public:
             float simbuf_ab_ratio;
         };
 
-        std::unique_ptr<NodeSB>     simbuf_nodes;
+        NodeSB*                     simbuf_nodes              = nullptr; //!< Front slot of the node snapshots, see `GfxActor::WriteSimNodeSnapshot()`
         Ogre::Vector3               simbuf_pos                = Ogre::Vector3::ZERO;
         Ogre::Vector3               simbuf_node0_velo         = Ogre::Vector3::ZERO;
         bool                        simbuf_live_local         = false;
@@ -201,13 +202,15 @@ public:
     bool                      IsActorLive        () const; //!< Should the visuals be updated for this actor?
     bool                      IsActorInitialized () const  { return m_initialized; } //!< Temporary TODO: Remove once the spawn routine is fixed
     void                      InitializeActor    ()        { m_initialized = true; } //!< Temporary TODO: Remove once the spawn routine is fixed
-    void                      UpdateSimDataBuffer(); //!< Copies sim. data from `Actor` to `GfxActor` for later update
+    void                      UpdateSimDataBuffer(); //!< Copies sim. data from `Actor` to `GfxActor` for later update; takes the newest node snapshot
+    void                      WriteSimNodeSnapshot(); //!< Physics side, at the end of `ActorManager::UpdatePhysicsSimulation()`
     void                      SetWheelVisuals    (uint16_t index, WheelGfx wheel_gfx);
     void                      CalculateDriverPos (Ogre::Vector3& out_pos, Ogre::Quaternion& out_rot);
     void                      UpdateWheelVisuals ();
     void                      FinishWheelUpdates ();
-    void                      UpdateFlexbodies   ();
-    void                      FinishFlexbodyTasks();
+    void                      UpdateFlexbodies   (std::vector<FlexBodyChunk>& chunks, FlexBodyStats& stats); //!< Adds vertex ranges to compute, see `GfxScene::UpdateScene()`
+    void                      FinishFlexbodyUpdates();
+    static void               ComputeFlexbodyChunks(std::vector<FlexBodyChunk>& chunks); //!< On the thread pool; returns when all are done
     void                      SetFlexbodyVisible (bool visible);
     void                      SetWheelsVisible   (bool value);
     void                      SetAllMeshesVisible(bool value);
@@ -230,14 +233,13 @@ public:
     void                      UpdateAeroEngines  ();
     void                      UpdateNetLabels    (float dt);
     void                      SetDebugView       (DebugViewType dv);
-    void                      SortFlexbodies     ();
     void                      AddFlexbody        (FlexBody* fb)           { m_flexbodies.push_back(fb); }
     Attributes&               GetAttributes      ()                       { return m_attr; }
     inline Ogre::MaterialPtr& GetCabTransMaterial()                       { return m_cab_mat_visual_trans; }
     inline VideoCamState      GetVideoCamState   () const                 { return m_vidcam_state; }
     inline DebugViewType      GetDebugView       () const                 { return m_debug_view; }
     SimBuffer &               GetSimDataBuffer   ()                       { return m_simbuf; }
-    SimBuffer::NodeSB*        GetSimNodeBuffer   ()                       { return m_simbuf.simbuf_nodes.get(); }
+    SimBuffer::NodeSB*        GetSimNodeBuffer   ()                       { return m_simbuf.simbuf_nodes; }
     std::set<GfxActor*>       GetLinkedGfxActors ()                       { return m_linked_gfx_actors; }
     Ogre::String              GetResourceGroup   ()                       { return m_custom_resource_group; }
     std::string               FetchActorDesignName() const;
@@ -284,8 +286,7 @@ private:
     std::vector<WheelGfx>       m_wheels;
     Ogre::SceneNode*            m_rods_parent_scenenode;
     RoR::Renderdash*            m_renderdash;
-    std::vector<std::shared_ptr<Task>> m_flexwheel_tasks;
-    std::vector<std::shared_ptr<Task>> m_flexbody_tasks;
+    std::vector<TaskHandle>            m_flexwheel_tasks;
     bool                        m_beaconlight_active;
     float                       m_prop_anim_crankfactor_prev;
     float                       m_prop_anim_shift_timer;
@@ -296,6 +297,14 @@ private:
 
     SimBuffer                   m_simbuf;
 
+    // Node snapshots, triple buffered: the physics thread and the renderer each own a slot
+    // and trade it for the middle one, so neither waits nor copies more than once.
+    static const int            NODE_SNAPSHOT_FRESH = 0x4;  //!< Flag in `m_node_snapshot_ready`: not picked up yet
+    std::unique_ptr<SimBuffer::NodeSB[]> m_node_snapshots[3];
+    std::atomic<int>            m_node_snapshot_ready{1};   //!< Middle slot index | NODE_SNAPSHOT_FRESH
+    int                         m_node_snapshot_write = 0;  //!< Owned by WriteSimNodeSnapshot()
+    int                         m_node_snapshot_front = 2;  //!< Owned by UpdateSimDataBuffer(), is `m_simbuf.simbuf_nodes`
+
     // Old cab mesh
     FlexObj*                    m_cab_mesh;
     Ogre::SceneNode*            m_cab_scene_node;
@@ -216,6 +216,26 @@ struct WheelGfx
     bool             wx_is_meshwheel     = false;
 };
 
+/// Vertex range of one flexbody; unit of work of the parallel flexbody update, see `GfxScene::UpdateScene()`
+struct FlexBodyChunk
+{
+    FlexBody*        fbc_flexbody        = nullptr;
+    int              fbc_begin           = 0;
+    int              fbc_end             = 0;
+    bool             fbc_blend_changed   = false; //!< Output; applied to the flexbody after the parallel loop
+};
+
+/// Flexbody work of one frame, see console command 'flexbodies'
+struct FlexBodyStats
+{
+    int              fbs_num_visible          = 0;
+    int              fbs_num_deformed         = 0;
+    int              fbs_num_reduced_rate     = 0; //!< Visible in LOD `FlexBody::Lod::REDUCED_RATE`
+    int              fbs_num_rigid            = 0; //!< Visible in LOD `FlexBody::Lod::RIGID`
+    size_t           fbs_vertices_visible     = 0;
+    size_t           fbs_vertices_deformed    = 0;
+};
+
 struct AirbrakeGfx
 {
     Ogre::MeshPtr    abx_mesh;
@@ -86,12 +86,24 @@ void RoR::GfxScene::Init()
 void RoR::GfxScene::UpdateScene(float dt_sec)
 {
     // Actors - start threaded tasks
+    m_flexbody_chunks.clear();
+    m_flexbody_stats = FlexBodyStats();
     for (GfxActor* gfx_actor: m_live_gfx_actors)
     {
-        gfx_actor->UpdateFlexbodies(); // Push flexbody tasks to threadpool
+        gfx_actor->UpdateFlexbodies(m_flexbody_chunks, m_flexbody_stats); // Collect flexbody vertex ranges, pick LODs
         gfx_actor->UpdateWheelVisuals(); // Push flexwheel tasks to threadpool
     }
 
+    // Flexbodies of all actors as one parallel loop over equally sized chunks, so that a big body
+    // doesn't end up on a single worker; the loop itself runs as a task to overlap with the rest of this function.
+    if (!m_flexbody_chunks.empty())
+    {
+        m_flexbody_task = App::GetThreadPool()->RunTask([this]()
+        {
+            GfxActor::ComputeFlexbodyChunks(m_flexbody_chunks);
+        });
+    }
+
     // Var
     GfxActor* player_gfx_actor = nullptr;
     std::set<GfxActor*> player_connected_gfx_actors;
@@ -244,10 +256,11 @@ void RoR::GfxScene::UpdateScene(float dt_sec)
     App::GetGameContext()->GetSceneMouse().UpdateVisuals();
 
     // Actors - finalize threaded tasks
+    m_flexbody_task.join();
     for (GfxActor* gfx_actor: m_live_gfx_actors)
     {
         gfx_actor->FinishWheelUpdates();
-        gfx_actor->FinishFlexbodyTasks();
+        gfx_actor->FinishFlexbodyUpdates();
     }
 }
 
@@ -28,7 +28,9 @@
 #include "CameraManager.h"
 #include "ForwardDeclarations.h"
 #include "EnvironmentMap.h" // RoR::GfxEnvmap
+#include "GfxData.h"
 #include "Skidmark.h"
+#include "ThreadPool.h" // class TaskHandle
 
 #include <map>
 #include <string>
@@ -79,6 +81,7 @@ public:
     Ogre::SceneManager* GetSceneManager() { return m_scene_manager; }
     std::vector<GfxActor*>& GetGfxActors() { return m_all_gfx_actors; }
     std::vector<GfxCharacter*>& GetGfxCharacters() { return m_all_gfx_characters; }
+    FlexBodyStats const& GetFlexbodyStats() const { return m_flexbody_stats; } //!< Of the last frame
 
 private:
 
@@ -90,6 +93,9 @@ private:
     RoR::GfxEnvmap                    m_envmap;
     SimBuffer                         m_simbuf;
     SkidmarkConfig                    m_skidmark_conf;
+    std::vector<FlexBodyChunk>        m_flexbody_chunks;
+    TaskHandle                        m_flexbody_task;
+    FlexBodyStats                     m_flexbody_stats;
 };
 
 } // namespace RoR
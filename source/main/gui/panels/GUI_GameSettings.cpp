@@ -257,6 +257,8 @@ void GameSettings::DrawGameplaySettings()
     {
         DrawGIntBox(App::sim_replay_length, _LC("GameSettings", "Replay length"));
         DrawGIntBox(App::sim_replay_stepping, _LC("GameSettings", "Replay stepping"));
+        DrawGIntBox(App::sim_replay_memory, _LC("GameSettings", "Replay memory (MiB)"));
+        DrawGFloatBox(App::sim_replay_quantization, _LC("GameSettings", "Replay position step (mm)"));
     }
 
     DrawGCheckbox(App::sim_realistic_commands, _LC("GameSettings", "Realistic forward commands"));
@@ -269,6 +271,7 @@ void GameSettings::DrawGameplaySettings()
     DrawGCheckbox(App::io_discord_rpc, _LC("GameSettings", "Discord Rich Presence"));
 
         DrawGCheckbox(App::sim_quickload_dialog, _LC("GameSettings", "Show confirm. UI dialog for quickload"));
+        DrawGCheckbox(App::sim_savegame_binary, _LC("GameSettings", "Binary savegames (faster, smaller)"));
 }
 
 void GameSettings::DrawAudioSettings()
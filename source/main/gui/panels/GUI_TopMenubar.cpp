@@ -860,7 +860,7 @@ void TopMenubar::DrawSpecialStateBox(float top_offset)
                 
                 // Progress bar with frame index/count
                 Replay* replay = App::GetGameContext()->GetPlayerActor()->GetReplay();
-                float fraction = (float)std::abs(replay->getCurrentFrame())/(float)replay->getNumFrames();
+                float fraction = (float)std::abs(replay->getCurrentFrame())/(float)std::max(1, replay->getNumFrames());
                 Str<100> pbar_text; pbar_text << replay->getCurrentFrame() << "/" << replay->getNumFrames();
                 float pbar_width = content_width - (ImGui::GetStyle().ItemSpacing.x + ImGui::CalcTextSize(special_text.c_str()).x);
                 ImGui::ProgressBar(fraction, ImVec2(pbar_width, ImGui::GetTextLineHeight()), pbar_text.ToCStr());
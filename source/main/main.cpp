@@ -96,6 +96,7 @@ int main(int argc, char *argv[])
         App::sys_cache_dir     ->SetStr(PathCombine(App::sys_user_dir->GetStr(), "cache"));
         App::sys_savegames_dir ->SetStr(PathCombine(App::sys_user_dir->GetStr(), "savegames"));
         App::sys_screenshot_dir->SetStr(PathCombine(App::sys_user_dir->GetStr(), "screenshots"));
+        App::sys_replays_dir   ->SetStr(PathCombine(App::sys_user_dir->GetStr(), "replays"));
 
         // Load RoR.cfg - updates cvars
         App::GetConsole()->LoadConfig();
@@ -305,6 +306,7 @@ int main(int argc, char *argv[])
                     if (App::app_state->GetEnum<AppState>() == AppState::SIMULATION)
                     {
                         App::GetGameContext()->SaveScene("autosave.sav");
+                        App::GetGameContext()->GetActorManager()->WaitForSceneSave();
                     }
                     App::GetConsole()->SaveConfig(); // RoR.cfg
                     App::GetDiscordRpc()->Shutdown();
@@ -534,6 +536,7 @@ int main(int argc, char *argv[])
                         App::GetSimTerrain()->GetTerrainEditor()->WriteOutputFile();
                     }
                     App::GetGameContext()->SaveScene("autosave.sav");
+                    App::GetGameContext()->GetActorManager()->WaitForSceneSave(); // The main menu offers to resume it
                     App::GetGameContext()->ChangePlayerActor(nullptr);
                     App::GetGameContext()->GetActorManager()->CleanUpSimulation();
                     App::GetGameContext()->GetCharacterFactory()->DeleteAllCharacters();
@@ -626,6 +629,19 @@ int main(int argc, char *argv[])
                     }
                     break;
 
+                case MSG_SIM_SCENE_SAVED:
+                    if (m.description != "autosave.sav")
+                    {
+                        App::GetConsole()->putMessage(
+                            Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_NOTICE, _L("Scene saved"));
+                    }
+                    break;
+
+                case MSG_SIM_SCENE_SAVE_FAILED:
+                    App::GetConsole()->putMessage(
+                        Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_ERROR, _L("Error while saving scene"));
+                    break;
+
                 // -- GUI events ---
 
                 case MSG_GUI_OPEN_MENU_REQUESTED:
@@ -745,7 +761,7 @@ int main(int argc, char *argv[])
             // Process incoming network traffic
             if (App::mp_state->GetEnum<MpState>() == MpState::CONNECTED)
             {
-                std::vector<RoR::NetRecvPacket> packets = App::GetNetwork()->GetIncomingStreamData();
+                std::vector<RoR::NetRecvPacket> const& packets = App::GetNetwork()->GetIncomingStreamData();
                 if (!packets.empty())
                 {
                     RoR::ChatSystem::HandleStreamData(packets);
@@ -780,6 +796,7 @@ int main(int argc, char *argv[])
                     else if (App::sim_state->GetEnum<SimState>() == SimState::RUNNING)
                     {
                         App::GetGameContext()->GetCharacterFactory()->Update(dt);
+                        App::GetGameContext()->UpdateAutosave(dt);
                         if (App::GetCameraManager()->GetCurrentBehavior() != CameraManager::CAMERA_BEHAVIOR_FREE)
                         {
                             App::GetGameContext()->UpdateSimInputEvents(dt);
@@ -0,0 +1,159 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifdef USE_SOCKETW
+
+#include "RoRnet.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RoR {
+
+/// A received packet; `buffer` points into the NetRecvQueue and holds `header.size` bytes plus a zero terminator.
+struct NetRecvPacket
+{
+    RoRnet::Header header;
+    const char*    buffer;
+};
+
+/// Lock-free single-producer/single-consumer queue of received packets.
+///
+/// Packets are stored back to back as variable-length records in one ring buffer. The producer
+/// (network receive thread) reserves a record, receives the payload straight into it and commits it,
+/// or just reserves again to drop it. The consumer (main thread) reads packets in place; they stay
+/// valid until it calls Release(), which hands all of them back to the producer at once.
+class NetRecvQueue
+{
+public:
+    static const size_t CAPACITY = size_t(1) << 24; //!< 16MB, over 2000 packets of maximum size
+    static const size_t ALIGNMENT = 8;
+
+    NetRecvQueue():
+        // Readers of malformed (too short) packets may look up to a full message past the payload, keep that in bounds
+        m_ring(CAPACITY + RORNET_MAX_MESSAGE_LENGTH, 0)
+    {}
+
+    // ---------------- Producer ----------------
+
+    /// Returns room for `header.size` bytes plus a terminator, or nullptr if the queue is full.
+    /// Reserving again without CommitWrite() discards the previous reservation.
+    char* BeginWrite(RoRnet::Header const& header)
+    {
+        const size_t write = m_write.load(std::memory_order_relaxed);
+        const size_t pos = write & (CAPACITY - 1);
+        const size_t tail_room = CAPACITY - pos;
+        const size_t rec_size = AlignUp(sizeof(Record) + header.size + 1);
+        const size_t skip = (rec_size > tail_room) ? tail_room : 0; // Records never wrap around
+
+        if (write + skip + rec_size - m_read.load(std::memory_order_acquire) > CAPACITY)
+        {
+            return nullptr;
+        }
+
+        if (skip != 0)
+        {
+            this->GetRecord(pos)->rec_size = 0; // Wrap marker
+        }
+        Record* rec = this->GetRecord((write + skip) & (CAPACITY - 1));
+        rec->rec_size = static_cast<uint32_t>(rec_size);
+        rec->header = header;
+        m_pending_size = skip + rec_size;
+
+        char* payload = reinterpret_cast<char*>(rec + 1);
+        payload[header.size] = '\0';
+        return payload;
+    }
+
+    void CommitWrite()
+    {
+        m_write.store(m_write.load(std::memory_order_relaxed) + m_pending_size, std::memory_order_release);
+        m_pending_size = 0;
+    }
+
+    // ---------------- Consumer ----------------
+
+    /// Returns false when there are no more committed packets.
+    bool Read(NetRecvPacket& out)
+    {
+        const size_t write = m_write.load(std::memory_order_acquire);
+        while (m_read_cursor != write)
+        {
+            const size_t pos = m_read_cursor & (CAPACITY - 1);
+            const Record* rec = this->GetRecord(pos);
+            if (rec->rec_size == 0)
+            {
+                m_read_cursor += CAPACITY - pos; // Wrap marker
+                continue;
+            }
+            out.header = rec->header;
+            out.buffer = reinterpret_cast<const char*>(rec + 1);
+            m_read_cursor += rec->rec_size;
+            return true;
+        }
+        return false;
+    }
+
+    /// Frees all packets read so far.
+    void Release()
+    {
+        m_read.store(m_read_cursor, std::memory_order_release);
+    }
+
+    /// Bytes occupied by committed packets, both read and unread.
+    size_t GetUsedBytes() const
+    {
+        return m_write.load(std::memory_order_acquire) - m_read.load(std::memory_order_relaxed);
+    }
+
+    /// Only valid while neither side is running.
+    void Clear()
+    {
+        m_write = 0;
+        m_read = 0;
+        m_read_cursor = 0;
+        m_pending_size = 0;
+    }
+
+private:
+    struct Record
+    {
+        uint32_t       rec_size; //!< Including this header and padding; 0 means 'continue at the start of the ring'
+        uint32_t       _pad;
+        RoRnet::Header header;
+    };
+
+    static size_t AlignUp(size_t size) { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+    Record* GetRecord(size_t pos) { return reinterpret_cast<Record*>(m_ring.data() + pos); }
+
+    std::vector<char>   m_ring;
+    std::atomic<size_t> m_write{0};       //!< Total bytes committed; written by the producer only
+    std::atomic<size_t> m_read{0};        //!< Total bytes released; written by the consumer only
+    size_t              m_read_cursor = 0;  //!< Consumer-private
+    size_t              m_pending_size = 0; //!< Producer-private
+};
+
+} // namespace RoR
+
+#endif // USE_SOCKETW
@@ -160,17 +160,32 @@ bool Network::SendNetMessage(int type, unsigned int streamid, int len, char* con
     return SendMessageRaw(buffer, msgsize);
 }
 
-void Network::QueueStreamData(RoRnet::Header &header, char *buffer, size_t buffer_len)
+char* Network::ReserveRecvBuffer(RoRnet::Header const& header)
 {
-    NetRecvPacket packet;
-    packet.header = header;
-    memcpy(packet.buffer, buffer, std::min(buffer_len, size_t(RORNET_MAX_MESSAGE_LENGTH)));
-
-    std::lock_guard<std::mutex> lock(m_recv_packetqueue_mutex);
-    m_recv_packet_buffer.push_back(packet);
+    char* buffer = m_recv_queue.BeginWrite(header);
+    if (buffer == nullptr)
+    {
+        m_recv_queue_full_waits++;
+        do
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            buffer = m_recv_queue.BeginWrite(header);
+        } while (buffer == nullptr && !m_shutdown);
+    }
+    return buffer;
 }
 
 int Network::ReceiveMessage(RoRnet::Header *head, char* content, int bufferlen)
+{
+    int err = this->ReceiveMessageHeader(head, bufferlen);
+    if (err != 0)
+    {
+        return err;
+    }
+    return this->ReceiveMessageBody(head, content, bufferlen);
+}
+
+int Network::ReceiveMessageHeader(RoRnet::Header *head, int bufferlen)
 {
     SWBaseSocket::SWBaseError error;
 
@@ -193,6 +208,13 @@ int Network::ReceiveMessage(RoRnet::Header *head, char* content, int bufferlen)
         return -3;
     }
 
+    return 0;
+}
+
+int Network::ReceiveMessageBody(RoRnet::Header *head, char* content, int bufferlen)
+{
+    SWBaseSocket::SWBaseError error;
+
     if (head->size > 0)
     {
         // Read the packet content
@@ -241,11 +263,20 @@ void Network::RecvThread()
 
     RoRnet::Header header;
 
-    char buffer[RORNET_MAX_MESSAGE_LENGTH] = {0};
-
     while (!m_shutdown)
     {
-        int err = ReceiveMessage(&header, buffer, RORNET_MAX_MESSAGE_LENGTH);
+        // The payload is received straight into the packet queue; only stream data is committed at the end
+        char* buffer = nullptr;
+        int err = ReceiveMessageHeader(&header, RORNET_MAX_MESSAGE_LENGTH);
+        if (err == 0)
+        {
+            buffer = this->ReserveRecvBuffer(header);
+            if (buffer == nullptr)
+            {
+                continue; // Shutting down
+            }
+            err = ReceiveMessageBody(&header, buffer, header.size + 1);
+        }
         //LOG("Received data: " + TOSTRING(header.command) + ", source: " + TOSTRING(header.source) + ":" + TOSTRING(header.streamid) + ", size: " + TOSTRING(header.size));
         if (err != 0)
         {
@@ -366,7 +397,7 @@ void Network::RecvThread()
         }
         //DebugPacket("recv", &header, buffer);
 
-        QueueStreamData(header, buffer, RORNET_MAX_MESSAGE_LENGTH);
+        m_recv_queue.CommitWrite();
     }
 
     LOG_THREAD("[RoR|Networking] RecvThread stopped");
@@ -592,7 +623,8 @@ void Network::Disconnect()
 
     m_users.clear();
     m_disconnected_users.clear();
-    m_recv_packet_buffer.clear();
+    m_recv_queue.Clear();
+    m_recv_packets.clear();
     m_send_packet_buffer.clear();
     App::GetConsole()->DoCommand("clear net");
 
@@ -668,12 +700,46 @@ void Network::AddLocalStream(RoRnet::StreamRegister *reg, int size)
     m_stream_id++;
 }
 
-std::vector<NetRecvPacket> Network::GetIncomingStreamData()
+std::vector<NetRecvPacket> const& Network::GetIncomingStreamData()
+{
+    m_recv_queue.Release(); // Consumers are done with the previous frame
+    m_recv_packets.clear();
+
+    m_recv_stats.nrs_max_queue_bytes = std::max(m_recv_stats.nrs_max_queue_bytes, m_recv_queue.GetUsedBytes());
+
+    size_t bytes_received = 0;
+    NetRecvPacket packet;
+    while (m_recv_queue.Read(packet))
+    {
+        m_recv_packets.push_back(packet);
+        bytes_received += packet.header.size;
+    }
+
+    // Payloads are handed over in place, only the headers get copied
+    const size_t bytes_copied = m_recv_packets.size() * sizeof(RoRnet::Header);
+    m_recv_stats.nrs_num_frames++;
+    m_recv_stats.nrs_num_packets += m_recv_packets.size();
+    m_recv_stats.nrs_bytes_received += bytes_received;
+    m_recv_stats.nrs_bytes_copied += bytes_copied;
+    m_recv_stats.nrs_frame_packets = m_recv_packets.size();
+    m_recv_stats.nrs_frame_bytes_received = bytes_received;
+    m_recv_stats.nrs_frame_bytes_copied = bytes_copied;
+    m_recv_stats.nrs_max_frame_bytes_copied = std::max(m_recv_stats.nrs_max_frame_bytes_copied, bytes_copied);
+
+    return m_recv_packets;
+}
+
+Network::NetRecvStats Network::GetRecvStats()
+{
+    NetRecvStats stats = m_recv_stats;
+    stats.nrs_queue_full_waits = m_recv_queue_full_waits;
+    return stats;
+}
+
+void Network::ResetRecvStats()
 {
-    std::lock_guard<std::mutex> lock(m_recv_packetqueue_mutex);
-    std::vector<NetRecvPacket> buf_copy = m_recv_packet_buffer;
-    m_recv_packet_buffer.clear();
-    return buf_copy;
+    m_recv_stats = NetRecvStats();
+    m_recv_queue_full_waits = 0;
 }
 
 Ogre::String Network::GetTerrainName()
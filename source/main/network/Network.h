@@ -24,6 +24,7 @@
 #ifdef USE_SOCKETW
 
 #include "Application.h"
+#include "NetRecvQueue.h"
 #include "RoRnet.h"
 
 #include <SocketW.h>
@@ -81,12 +82,6 @@ struct NetSendPacket
     int size;
 };
 
-struct NetRecvPacket
-{
-    RoRnet::Header header;
-    char buffer[RORNET_MAX_MESSAGE_LENGTH];
-};
-
 #pragma pack(pop)
 
 // ------------------------ End of network messages --------------------------
@@ -101,7 +96,25 @@ public:
     void                 AddPacket(int streamid, int type, int len, const char *content);
     void                 AddLocalStream(RoRnet::StreamRegister *reg, int size);
 
-    std::vector<NetRecvPacket> GetIncomingStreamData();
+    /// Packets received since the last call; valid until the next call.
+    std::vector<NetRecvPacket> const& GetIncomingStreamData();
+
+    /// Receive path traffic, see console command 'netstats'
+    struct NetRecvStats
+    {
+        size_t     nrs_num_frames = 0;          //!< Calls to GetIncomingStreamData()
+        size_t     nrs_num_packets = 0;
+        size_t     nrs_bytes_received = 0;      //!< Payload
+        size_t     nrs_bytes_copied = 0;        //!< Copied on the way from the socket to the consumers
+        size_t     nrs_frame_packets = 0;       //!< Last frame
+        size_t     nrs_frame_bytes_received = 0;
+        size_t     nrs_frame_bytes_copied = 0;
+        size_t     nrs_max_frame_bytes_copied = 0;
+        size_t     nrs_max_queue_bytes = 0;     //!< Peak fill of the receive queue
+        size_t     nrs_queue_full_waits = 0;    //!< Times the receive thread had to wait for the main thread
+    };
+    NetRecvStats         GetRecvStats();
+    void                 ResetRecvStats();
 
     int                  GetUID();
     int                  GetNetQuality();
@@ -129,8 +142,10 @@ private:
     void                 SetNetQuality(int quality);
     bool                 SendMessageRaw(char *buffer, int msgsize);
     bool                 SendNetMessage(int type, unsigned int streamid, int len, char* content);
-    void                 QueueStreamData(RoRnet::Header &header, char *buffer, size_t buffer_len);
+    char*                ReserveRecvBuffer(RoRnet::Header const& header); //!< Waits while the receive queue is full
     int                  ReceiveMessage(RoRnet::Header *head, char* content, int bufferlen);
+    int                  ReceiveMessageHeader(RoRnet::Header *head, int bufferlen);
+    int                  ReceiveMessageBody(RoRnet::Header *head, char* content, int bufferlen);
     void                 CouldNotConnect(std::string const & msg, bool close_socket = true);
 
     bool                 ConnectThread();
@@ -161,16 +176,18 @@ private:
     std::string          m_status_message;
     std::atomic<bool>    m_shutdown;
     std::atomic<int>     m_net_quality;
+    std::atomic<size_t>  m_recv_queue_full_waits{0};
     int                  m_stream_id = 10;
 
     std::mutex           m_users_mutex;
     std::mutex           m_userdata_mutex;
-    std::mutex           m_recv_packetqueue_mutex;
     std::mutex           m_send_packetqueue_mutex;
 
     std::condition_variable m_send_packet_available_cv;
 
-    std::vector<NetRecvPacket> m_recv_packet_buffer;
+    NetRecvQueue               m_recv_queue;     //!< Filled by RecvThread, drained by GetIncomingStreamData()
+    std::vector<NetRecvPacket> m_recv_packets;   //!< Views into `m_recv_queue`, last frame
+    NetRecvStats               m_recv_stats;     //!< Main thread only
     std::deque <NetSendPacket> m_send_packet_buffer;
 };
 
@@ -0,0 +1,126 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NodeInterpolation.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#   define ROR_NODE_INTERP_X86
+#   include <emmintrin.h>
+#endif
+
+using namespace RoR;
+
+void RoR::DecodeNodePositions(const float ref[3], const int16_t* quantized, int num_quantized, float inv_scale,
+                              float* soa, int stride)
+{
+    float* x = soa;
+    float* y = soa + stride;
+    float* z = soa + 2 * stride;
+    x[0] = ref[0];
+    y[0] = ref[1];
+    z[0] = ref[2];
+
+    int i = 0;
+#ifdef ROR_NODE_INTERP_X86
+    const __m128 scale = _mm_set1_ps(inv_scale);
+    const __m128 ref_x = _mm_set1_ps(ref[0]);
+    const __m128 ref_y = _mm_set1_ps(ref[1]);
+    const __m128 ref_z = _mm_set1_ps(ref[2]);
+    for (; i + 4 <= num_quantized; i += 4)
+    {
+        // 4 nodes = 12 shorts, sign-extended to x0y0z0x1 y1z1x2y2 z2x3y3z3
+        const __m128i s01 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(quantized + i * 3));
+        const __m128i s2 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(quantized + i * 3 + 8));
+        const __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s01, s01), 16)), scale);
+        const __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s01, s01), 16)), scale);
+        const __m128 c = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s2, s2), 16)), scale);
+
+        // Transpose to SoA
+        const __m128 vx = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        const __m128 vy = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                                         _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 vz = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                                         _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+        _mm_storeu_ps(x + 1 + i, _mm_add_ps(vx, ref_x));
+        _mm_storeu_ps(y + 1 + i, _mm_add_ps(vy, ref_y));
+        _mm_storeu_ps(z + 1 + i, _mm_add_ps(vz, ref_z));
+    }
+#endif // ROR_NODE_INTERP_X86
+    for (; i < num_quantized; i++)
+    {
+        x[1 + i] = quantized[i * 3 + 0] * inv_scale + ref[0];
+        y[1 + i] = quantized[i * 3 + 1] * inv_scale + ref[1];
+        z[1 + i] = quantized[i * 3 + 2] * inv_scale + ref[2];
+    }
+}
+
+NodeHermiteWeights RoR::GetNodeHermiteWeights(float s, float span, float t0, float t1, float t2, float t3, float extrapolation)
+{
+    const float s2 = s * s, s3 = s2 * s;
+    NodeHermiteWeights w;
+    w.pos[0] = 2 * s3 - 3 * s2 + 1;
+    w.pos[1] = s3 - 2 * s2 + s;
+    w.pos[2] = -2 * s3 + 3 * s2;
+    w.pos[3] = s3 - s2;
+    // Derivatives of the above by `s`, divided by the span
+    w.vel[0] = (6 * s2 - 6 * s) / span;
+    w.vel[1] = (3 * s2 - 4 * s + 1) / span;
+    w.vel[2] = (-6 * s2 + 6 * s) / span;
+    w.vel[3] = (3 * s2 - 2 * s) / span;
+    w.tangent_scale[0] = span / (t2 - t0);
+    w.tangent_scale[1] = span / (t3 - t1);
+    w.extrapolation = extrapolation;
+    return w;
+}
+
+void RoR::InterpolateNodePositions(const float* p0, const float* p1, const float* p2, const float* p3, int stride,
+                                   NodeHermiteWeights const& w, float* out_pos, float* out_vel)
+{
+    // The same for all components, so x, y and z run as one array
+    const int count = stride * 3;
+    int i = 0;
+#ifdef ROR_NODE_INTERP_X86
+    const __m128 hp1 = _mm_set1_ps(w.pos[0]), hm1 = _mm_set1_ps(w.pos[1]), hp2 = _mm_set1_ps(w.pos[2]), hm2 = _mm_set1_ps(w.pos[3]);
+    const __m128 dp1 = _mm_set1_ps(w.vel[0]), dm1 = _mm_set1_ps(w.vel[1]), dp2 = _mm_set1_ps(w.vel[2]), dm2 = _mm_set1_ps(w.vel[3]);
+    const __m128 ts1 = _mm_set1_ps(w.tangent_scale[0]), ts2 = _mm_set1_ps(w.tangent_scale[1]);
+    const __m128 ext = _mm_set1_ps(w.extrapolation);
+    const __m128 ms_to_s = _mm_set1_ps(1000.f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 a = _mm_loadu_ps(p0 + i), b = _mm_loadu_ps(p1 + i), c = _mm_loadu_ps(p2 + i), d = _mm_loadu_ps(p3 + i);
+        const __m128 m1 = _mm_mul_ps(_mm_sub_ps(c, a), ts1);
+        const __m128 m2 = _mm_mul_ps(_mm_sub_ps(d, b), ts2);
+        const __m128 vel = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dp1, b), _mm_mul_ps(dm1, m1)),
+                                      _mm_add_ps(_mm_mul_ps(dp2, c), _mm_mul_ps(dm2, m2)));
+        const __m128 pos = _mm_add_ps(_mm_add_ps(_mm_mul_ps(hp1, b), _mm_mul_ps(hm1, m1)),
+                                      _mm_add_ps(_mm_add_ps(_mm_mul_ps(hp2, c), _mm_mul_ps(hm2, m2)), _mm_mul_ps(vel, ext)));
+        _mm_storeu_ps(out_pos + i, pos);
+        _mm_storeu_ps(out_vel + i, _mm_mul_ps(vel, ms_to_s));
+    }
+#endif // ROR_NODE_INTERP_X86
+    for (; i < count; i++)
+    {
+        const float m1 = (p2[i] - p0[i]) * w.tangent_scale[0];
+        const float m2 = (p3[i] - p1[i]) * w.tangent_scale[1];
+        const float vel = w.vel[0] * p1[i] + w.vel[1] * m1 + w.vel[2] * p2[i] + w.vel[3] * m2;
+        out_pos[i] = w.pos[0] * p1[i] + w.pos[1] * m1 + w.pos[2] * p2[i] + w.pos[3] * m2 + vel * w.extrapolation;
+        out_vel[i] = vel * 1000.f;
+    }
+}
@@ -0,0 +1,50 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace RoR {
+
+/// Kernels for remote actors (see `Actor::CalcNetworkNodes()`). Node positions of each received update are
+/// decoded once into a float SoA cache: x[stride], y[stride], z[stride]; `stride` is the node count rounded
+/// up to a multiple of 4, padding is zero. Standalone, so that they can be benchmarked.
+
+inline int GetNodeSoaStride(int num_nodes) { return (num_nodes + 3) & ~3; }
+
+/// Writes node 0 = `ref` and nodes 1..num_nodes = `ref` + quantized offsets (3 per node) * `inv_scale`.
+void DecodeNodePositions(const float ref[3], const int16_t* quantized, int num_quantized, float inv_scale,
+                         float* soa, int stride);
+
+/// Weights of a cubic Hermite segment between updates 1 and 2, see InterpolateNodePositions()
+struct NodeHermiteWeights
+{
+    float pos[4];           //!< Of p1, m1, p2, m2 in the position
+    float vel[4];           //!< Of p1, m1, p2, m2 in the velocity (per ms)
+    float tangent_scale[2]; //!< m1 = (p2 - p0) * tangent_scale[0], m2 = (p3 - p1) * tangent_scale[1]
+    float extrapolation;    //!< ms to continue past the segment at the computed velocity
+};
+
+/// Positions (at `s`, plus extrapolation) and velocities (m/s) of all nodes, SoA in and out.
+NodeHermiteWeights GetNodeHermiteWeights(float s, float span, float t0, float t1, float t2, float t3, float extrapolation);
+void InterpolateNodePositions(const float* p0, const float* p1, const float* p2, const float* p3, int stride,
+                              NodeHermiteWeights const& w, float* out_pos, float* out_vel);
+
+} // namespace RoR
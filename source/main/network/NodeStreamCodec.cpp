@@ -0,0 +1,143 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NodeStreamCodec.h"
+
+#include "BitStream.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace RoR;
+
+namespace {
+
+bool IsNodeChanged(const int16_t* nodes, const int16_t* key, int i)
+{
+    return std::abs(nodes[i * 3 + 0] - key[i * 3 + 0]) > NODE_STREAM_DEADBAND
+        || std::abs(nodes[i * 3 + 1] - key[i * 3 + 1]) > NODE_STREAM_DEADBAND
+        || std::abs(nodes[i * 3 + 2] - key[i * 3 + 2]) > NODE_STREAM_DEADBAND;
+}
+
+} // namespace
+
+size_t RoR::NodeStreamEncode(const int16_t* nodes, const int16_t* key, int num_nodes, uint8_t& golomb_k,
+                             uint8_t* out, size_t out_capacity, std::vector<uint32_t>& scratch)
+{
+    BitWriter writer(out, out_capacity);
+    scratch.clear();
+
+    if (key == nullptr)
+    {
+        // Keyframe: predict each node from the previous one, neighbours are usually close
+        for (int i = 0; i < num_nodes * 3; i++)
+        {
+            const int32_t prediction = (i >= 3) ? nodes[i - 3] : 0;
+            scratch.push_back(ZigZag(nodes[i] - prediction));
+        }
+    }
+    else
+    {
+        // Delta: masks of changed nodes first, residuals to the keyframe after
+        for (int group = 0; group * NODE_STREAM_MASK_GROUP < num_nodes; group++)
+        {
+            const int begin = group * NODE_STREAM_MASK_GROUP;
+            const int end = std::min(begin + NODE_STREAM_MASK_GROUP, num_nodes);
+            bool changed = false;
+            for (int i = begin; i < end && !changed; i++)
+                changed = IsNodeChanged(nodes, key, i);
+            writer.Put(changed ? 1 : 0, 1);
+        }
+        for (int group = 0; group * NODE_STREAM_MASK_GROUP < num_nodes; group++)
+        {
+            const int begin = group * NODE_STREAM_MASK_GROUP;
+            const int end = std::min(begin + NODE_STREAM_MASK_GROUP, num_nodes);
+            uint32_t mask = 0;
+            for (int i = begin; i < end; i++)
+            {
+                if (IsNodeChanged(nodes, key, i))
+                {
+                    mask |= 1u << (i - begin);
+                    for (int axis = 0; axis < 3; axis++)
+                        scratch.push_back(ZigZag(nodes[i * 3 + axis] - key[i * 3 + axis]));
+                }
+            }
+            if (mask != 0)
+                writer.Put(mask, end - begin);
+        }
+    }
+
+    golomb_k = static_cast<uint8_t>(ChooseGolombK(scratch.data(), scratch.size()));
+    for (uint32_t u: scratch)
+        writer.PutGolomb(u, golomb_k);
+
+    return writer.Finish();
+}
+
+bool RoR::NodeStreamDecode(const uint8_t* in, size_t in_size, const int16_t* key, int num_nodes, uint8_t golomb_k,
+                           int16_t* nodes)
+{
+    if (golomb_k > BITSTREAM_MAX_GOLOMB_K)
+        return false;
+
+    BitReader reader(in, in_size);
+    uint32_t u = 0;
+
+    if (key == nullptr)
+    {
+        for (int i = 0; i < num_nodes * 3; i++)
+        {
+            if (!reader.GetGolomb(golomb_k, u))
+                return false;
+            const int32_t prediction = (i >= 3) ? nodes[i - 3] : 0;
+            nodes[i] = static_cast<int16_t>(prediction + UnZigZag(u));
+        }
+        return true;
+    }
+
+    const int num_groups = (num_nodes + NODE_STREAM_MASK_GROUP - 1) / NODE_STREAM_MASK_GROUP;
+    std::vector<uint32_t> masks(num_groups, 0);
+    for (int group = 0; group < num_groups; group++)
+    {
+        if (!reader.Get(1, masks[group]))
+            return false;
+    }
+    for (int group = 0; group < num_groups; group++)
+    {
+        const int group_size = std::min(NODE_STREAM_MASK_GROUP, num_nodes - group * NODE_STREAM_MASK_GROUP);
+        if (masks[group] != 0 && !reader.Get(group_size, masks[group]))
+            return false;
+    }
+
+    std::copy(key, key + num_nodes * 3, nodes);
+    for (int group = 0; group < num_groups; group++)
+    {
+        for (uint32_t mask = masks[group]; mask != 0; mask &= mask - 1)
+        {
+            const int i = group * NODE_STREAM_MASK_GROUP + CountTrailingZeros(mask);
+            for (int axis = 0; axis < 3; axis++)
+            {
+                if (!reader.GetGolomb(golomb_k, u))
+                    return false;
+                nodes[i * 3 + axis] = static_cast<int16_t>(key[i * 3 + axis] + UnZigZag(u));
+            }
+        }
+    }
+    return true;
+}
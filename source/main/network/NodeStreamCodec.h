@@ -0,0 +1,74 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RoR {
+
+/// Actor node stream formats. The sender offers the delta format in `RoRnet::ActorStreamRegister::bufferSize`
+/// (unused until now, so older clients just echo it back in their MSG2_STREAM_REGISTER_RESULT reply);
+/// receivers which can decode it reply with the 'accept' value instead. Packets in the delta format
+/// are marked with `RoRnet::NETMASK_NODE_STREAM_DELTA` in the VehicleState.
+enum NodeStreamFormat: int32_t
+{
+    NODE_STREAM_LEGACY          = 0,
+    NODE_STREAM_OFFER_DELTA_V1  = 0x52440001, //!< "RD" + version
+    NODE_STREAM_ACCEPT_DELTA_V1 = 0x52448001,
+};
+
+#pragma pack(push, 1)
+
+/// Follows the VehicleState in delta format packets; then come the wheel speeds (float each)
+/// and the bitstream written by NodeStreamEncode().
+struct NodeStreamHeader
+{
+    float    ref_pos[3];   //!< Node 0, absolute; other nodes are quantized relative to it (see `Actor::m_net_node_compression`)
+    uint16_t key_id;       //!< Keyframe which this packet is, or is relative to
+    uint16_t num_nodes;    //!< Nodes in the bitstream (all but node 0 and wheel nodes); a mismatch means different actors
+    uint8_t  flags;        //!< NODE_STREAM_FLAG_*
+    uint8_t  golomb_k;     //!< Exp-Golomb order of the residuals
+    uint16_t send_interval; //!< Milliseconds until the sender's next update, see `ActorManager::UpdateNetSendScheduler()`
+};
+
+#pragma pack(pop)
+
+static const uint8_t NODE_STREAM_FLAG_KEYFRAME = 0x1;
+
+/// Quantized node positions (3 int16 per node) coded either as a keyframe (each node predicted from the
+/// previous one) or as a delta to a keyframe, where nodes within `NODE_STREAM_DEADBAND` of the keyframe
+/// are skipped via a two-level bitmask and the remaining residuals are Exp-Golomb coded with the
+/// order chosen per packet. Standalone, so that it can be benchmarked.
+static const int NODE_STREAM_DEADBAND = 1;    //!< Quantization steps; a node must move more to be sent
+static const int NODE_STREAM_MASK_GROUP = 32; //!< Nodes per bit of the top-level mask
+static const int NODE_STREAM_KEYFRAME_INTERVAL = 50; //!< Packets; how long late joiners may wait for a keyframe
+
+/// Returns the bytes written to `out`, or 0 if they don't fit into `out_capacity`. `key` == nullptr writes a keyframe.
+/// `scratch` only avoids allocations.
+size_t NodeStreamEncode(const int16_t* nodes, const int16_t* key, int num_nodes, uint8_t& golomb_k,
+                        uint8_t* out, size_t out_capacity, std::vector<uint32_t>& scratch);
+
+/// Inverse of NodeStreamEncode() with the same `key` and `golomb_k`; returns false if the data is malformed.
+bool   NodeStreamDecode(const uint8_t* in, size_t in_size, const int16_t* key, int num_nodes, uint8_t golomb_k,
+                        int16_t* nodes);
+
+} // namespace RoR
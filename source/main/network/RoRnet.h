@@ -108,7 +108,9 @@ enum Netmask
     NETMASK_ENGINE_MODE_SEMIAUTO      = BITMASK(27), //!< engine mode
     NETMASK_ENGINE_MODE_MANUAL        = BITMASK(28), //!< engine mode
     NETMASK_ENGINE_MODE_MANUAL_STICK  = BITMASK(29), //!< engine mode
-    NETMASK_ENGINE_MODE_MANUAL_RANGES = BITMASK(30)  //!< engine mode
+    NETMASK_ENGINE_MODE_MANUAL_RANGES = BITMASK(30), //!< engine mode
+
+    NETMASK_NODE_STREAM_DELTA         = BITMASK(31)  //!< node data in the delta format, see NodeStreamCodec.h in the client
 };
 
 // -------------------------------- structs -----------------------------------
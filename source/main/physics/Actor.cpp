@@ -52,6 +52,9 @@
 #include "MeshObject.h"
 #include "MovableText.h"
 #include "Network.h"
+#include "NodeInterpolation.h"
+#include "NodeStreamCodec.h"
+#include "PlatformUtils.h"
 #include "PointColDetector.h"
 #include "Replay.h"
 #include "ActorSpawner.h"
@@ -74,6 +77,12 @@ using namespace RoR;
 
 static const Ogre::Vector3 BOUNDING_BOX_PADDING(0.05f, 0.05f, 0.05f);
 
+// Jitter buffer of remote actors, see `Actor::CalcNetwork()`
+static const float NET_EXTRAPOLATION_LIMIT = 300.f;  //!< ms; dead reckoning past the newest update stops there
+static const float NET_JITTER_MARGIN       = 3.f;    //!< Playout delay headroom, in mean deviations of the transit time
+static const float NET_PLAYOUT_SLEW        = 0.1f;   //!< Max playout clock speed change while adapting the delay (10%)
+static const float NET_PLAYOUT_SNAP        = 1000.f; //!< ms; larger delay changes are applied at once
+
 Actor::~Actor()
 {
     TRIGGER_EVENT(SE_GENERIC_DELETED_TRUCK, ar_instance_id);
@@ -82,6 +91,12 @@ Actor::~Actor()
 
     this->DisjoinInterActorBeams();
 
+    if (m_net_stream_recording != nullptr)
+    {
+        fclose(m_net_stream_recording);
+        m_net_stream_recording = nullptr;
+    }
+
     // delete all classes we might have constructed
     if (ar_dashboard != nullptr)
     {
@@ -114,10 +129,6 @@ Actor::~Actor()
         delete m_fusealge_airfoil;
     m_fusealge_airfoil = 0;
 
-    if (m_replay_handler)
-        delete m_replay_handler;
-    m_replay_handler = nullptr;
-
     if (ar_vehicle_ai)
         delete ar_vehicle_ai;
     ar_vehicle_ai = 0;
@@ -342,37 +353,54 @@ Vector3 Actor::getPosition()
     return m_avg_node_position; //the position is already in absolute position
 }
 
-void Actor::PushNetwork(char* data, int size)
+void Actor::PushNetwork(const char* data, int size)
 {
     NetUpdate update;
 
     update.veh_state.resize(sizeof(RoRnet::VehicleState));
-    update.node_data.resize(m_net_node_buf_size);
-    update.wheel_data.resize(ar_num_wheels * sizeof(float));
+    update.node_pos.resize(3 * GetNodeSoaStride(m_net_first_wheel_node), 0.f);
+    update.wheel_data.resize(ar_num_wheels);
 
+    bool mismatch = false;
+    if ((unsigned int)size >= sizeof(RoRnet::VehicleState) &&
+        (((const RoRnet::VehicleState*)data)->flagmask & RoRnet::NETMASK_NODE_STREAM_DELTA))
+    {
+        if (!this->ReadNodeStreamDelta(data, size, update, mismatch) && !mismatch)
+        {
+            return; // Waiting for a keyframe
+        }
+    }
     // check if the size of the data matches to what we expected
-    if ((unsigned int)size == (m_net_buffer_size + sizeof(RoRnet::VehicleState)))
+    else if ((unsigned int)size == (m_net_buffer_size + sizeof(RoRnet::VehicleState)))
     {
         // we walk through the incoming data and separate it a bit
-        char* ptr = data;
+        const char* ptr = data;
 
         // put the RoRnet::VehicleState in front, describes actor basics, engine state, flares, etc
         memcpy(update.veh_state.data(), ptr, sizeof(RoRnet::VehicleState));
         ptr += sizeof(RoRnet::VehicleState);
 
-        // then copy the node data
-        memcpy(update.node_data.data(), ptr, m_net_node_buf_size);
+        // then decode the node data, once for all frames which interpolate from it
+        float ref[3];
+        memcpy(ref, ptr, sizeof(ref));
+        DecodeNodePositions(ref, (const int16_t*)(ptr + sizeof(ref)), std::max(0, m_net_first_wheel_node - 1),
+            1.f / m_net_node_compression, update.node_pos.data(), GetNodeSoaStride(m_net_first_wheel_node));
         ptr += m_net_node_buf_size;
 
         // then take care of the wheel speeds
         for (int i = 0; i < ar_num_wheels; i++)
         {
-            float wspeed = *(float*)(ptr);
+            float wspeed = *(const float*)(ptr);
             update.wheel_data[i] = wspeed;
             ptr += sizeof(float);
         }
     }
     else
+    {
+        mismatch = true;
+    }
+
+    if (mismatch)
     {
         if (!m_net_initialized)
         {
@@ -403,145 +431,161 @@ void Actor::PushNetwork(char* data, int size)
         return;
     }
 
-    // Required to catch up when joining late (since the StreamRegister time stamp is received delayed)
-    if (!m_net_initialized)
+    update.time = ((RoRnet::VehicleState*)update.veh_state.data())->time;
+    if (!m_net_updates.empty() && update.time <= m_net_updates.back().time)
     {
-        RoRnet::VehicleState* oob = (RoRnet::VehicleState*)update.veh_state.data();
-        int tnow = App::GetGameContext()->GetActorManager()->GetNetTime();
-        int rnow = std::max(0, tnow + App::GetGameContext()->GetActorManager()->GetNetTimeOffset(ar_net_source_id));
-        if (oob->time > rnow + 100)
-        {
-            App::GetGameContext()->GetActorManager()->UpdateNetTimeOffset(ar_net_source_id, oob->time - rnow);
-        }
+        return; // Duplicate or out of order
     }
 
-    m_net_updates.push_back(update);
-}
-
-void Actor::CalcNetwork()
-{
-    using namespace RoRnet;
-
-    if (m_net_updates.size() < 2)
-        return;
-
-    int tnow = App::GetGameContext()->GetActorManager()->GetNetTime();
-    int rnow = std::max(0, tnow + App::GetGameContext()->GetActorManager()->GetNetTimeOffset(ar_net_source_id));
-
-    // Find index offset into the stream data for the current time
-    int index_offset = 0;
-    for (int i = 0; i < m_net_updates.size() - 1; i++)
+    // Jitter buffer statistics; the transit time includes the offset of the sender's clock
+    const double transit = static_cast<double>(App::GetGameContext()->GetActorManager()->GetNetTime()) - update.time;
+    if (m_net_updates.empty() && m_net_playout_delay < 0.0)
     {
-        VehicleState* oob = (VehicleState*)m_net_updates[i].veh_state.data();
-        if (oob->time > rnow)
-            break;
-        index_offset = i;
+        m_net_transit_mean = transit;
+        m_net_transit_jitter = 0.0;
+    }
+    else
+    {
+        m_net_transit_mean += (transit - m_net_transit_mean) / 16.0;
+        m_net_transit_jitter += (std::abs(transit - m_net_transit_mean) - m_net_transit_jitter) / 16.0;
+    }
+    if (!m_net_updates.empty())
+    {
+        m_net_interval_mean += ((update.time - m_net_updates.back().time) - m_net_interval_mean) / 8.f;
     }
 
-    VehicleState* oob1 = (VehicleState*)m_net_updates[index_offset    ].veh_state.data();
-    VehicleState* oob2 = (VehicleState*)m_net_updates[index_offset + 1].veh_state.data();
-    char*        netb1 = (char*)        m_net_updates[index_offset    ].node_data.data();
-    char*        netb2 = (char*)        m_net_updates[index_offset + 1].node_data.data();
-    float*     net_rp1 = (float*)       m_net_updates[index_offset    ].wheel_data.data();
-    float*     net_rp2 = (float*)       m_net_updates[index_offset + 1].wheel_data.data();
+    m_net_updates.push_back(update);
+}
 
-    float tratio = (float)(rnow - oob1->time) / (float)(oob2->time - oob1->time);
+void Actor::UpdateNetPlayoutDelay(int tnow)
+{
+    // Enough delay that the update after the current time has arrived, even if it's late
+    const int interval = (m_net_updates.back().send_interval > 0)
+        ? m_net_updates.back().send_interval : static_cast<int>(m_net_interval_mean);
+    const double target = m_net_transit_mean + NET_JITTER_MARGIN * m_net_transit_jitter + interval;
 
-    if (tratio > 4.0f)
+    if (m_net_playout_delay < 0.0 || std::abs(target - m_net_playout_delay) > NET_PLAYOUT_SNAP)
     {
-        m_net_updates.clear();
-        return; // Wait for new data
+        m_net_playout_delay = target;
     }
-    else if (tratio > 1.0f)
-    {
-        App::GetGameContext()->GetActorManager()->UpdateNetTimeOffset(ar_net_source_id, -std::pow(2, tratio));
-    }
-    else if (index_offset == 0 && (m_net_updates.size() > 5 || (tratio < 0.125f && m_net_updates.size() > 2)))
+    else
     {
-        App::GetGameContext()->GetActorManager()->UpdateNetTimeOffset(ar_net_source_id, +1);
+        // Adapt by playing slightly slower or faster, jumps would be visible
+        const double max_step = NET_PLAYOUT_SLEW * std::max(0, tnow - m_net_playout_last_time);
+        m_net_playout_delay += std::min(std::max(target - m_net_playout_delay, -max_step), max_step);
     }
+    m_net_playout_last_time = tnow;
+}
 
-    short* sp1 = (short*)(netb1 + sizeof(float) * 3);
-    short* sp2 = (short*)(netb2 + sizeof(float) * 3);
-    Vector3 p1ref = Vector3::ZERO;
-    Vector3 p2ref = Vector3::ZERO;
-    Vector3 p1 = Vector3::ZERO;
-    Vector3 p2 = Vector3::ZERO;
+void Actor::CalcNetworkNodes()
+{
+    m_net_playout_valid = false;
+    if (m_net_updates.size() < 2)
+        return;
 
+    // Playout clock: runs behind the sender's clock by the jitter buffer delay
+    const int tnow = App::GetGameContext()->GetActorManager()->GetNetTime();
+    this->UpdateNetPlayoutDelay(tnow);
+    const int rnow = tnow - static_cast<int>(m_net_playout_delay);
+
+    // Find the updates around the current time; u0 and u3 only shape the curve
+    const int num_updates = static_cast<int>(m_net_updates.size());
+    auto next = std::upper_bound(m_net_updates.begin(), m_net_updates.end(), rnow,
+        [](int time, NetUpdate const& update) { return time < update.time; });
+    const int index_offset = std::min(std::max(0, static_cast<int>(next - m_net_updates.begin()) - 1), num_updates - 2);
+
+    NetUpdate const& u1 = m_net_updates[index_offset];
+    NetUpdate const& u2 = m_net_updates[index_offset + 1];
+    NetUpdate const& u0 = (index_offset > 0) ? m_net_updates[index_offset - 1] : u1;
+    NetUpdate const& u3 = (index_offset + 2 < num_updates) ? m_net_updates[index_offset + 2] : u2;
+
+    // Past the newest update (lost or late packets): dead reckoning, but only so far
+    const float span = static_cast<float>(u2.time - u1.time); // > 0, see PushNetwork()
+    float tratio = (rnow - u1.time) / span;
+    float extrapolation = 0.f; // ms
+    if (tratio > 1.0f)
+    {
+        extrapolation = std::min(static_cast<float>(rnow - u2.time), NET_EXTRAPOLATION_LIMIT);
+        tratio = 1.0f;
+    }
+    tratio = std::max(0.0f, tratio);
+
+    // Cubic Hermite segment; tangents are central differences of the neighbouring updates (Catmull-Rom)
+    const NodeHermiteWeights weights = GetNodeHermiteWeights(tratio, span, u0.time, u1.time, u2.time, u3.time, extrapolation);
+    const int stride = GetNodeSoaStride(m_net_first_wheel_node);
+    m_net_interp_pos.resize(3 * stride);
+    m_net_interp_vel.resize(3 * stride);
+    InterpolateNodePositions(u0.node_pos.data(), u1.node_pos.data(), u2.node_pos.data(), u3.node_pos.data(), stride,
+        weights, m_net_interp_pos.data(), m_net_interp_vel.data());
+
+    const float* pos = m_net_interp_pos.data();
+    const float* vel = m_net_interp_vel.data();
     for (int i = 0; i < m_net_first_wheel_node; i++)
     {
-        if (i == 0)
-        {
-            // first node is uncompressed
-            p1.x = ((float*)netb1)[0];
-            p1.y = ((float*)netb1)[1];
-            p1.z = ((float*)netb1)[2];
-            p1ref = p1;
-
-            p2.x = ((float*)netb2)[0];
-            p2.y = ((float*)netb2)[1];
-            p2.z = ((float*)netb2)[2];
-            p2ref = p2;
-        }
-        else
-        {
-            // all other nodes are compressed:
-            // short int compared to previous node
-            p1.x = (float)(sp1[(i - 1) * 3 + 0]) / m_net_node_compression;
-            p1.y = (float)(sp1[(i - 1) * 3 + 1]) / m_net_node_compression;
-            p1.z = (float)(sp1[(i - 1) * 3 + 2]) / m_net_node_compression;
-            p1 = p1 + p1ref;
-
-            p2.x = (float)(sp2[(i - 1) * 3 + 0]) / m_net_node_compression;
-            p2.y = (float)(sp2[(i - 1) * 3 + 1]) / m_net_node_compression;
-            p2.z = (float)(sp2[(i - 1) * 3 + 2]) / m_net_node_compression;
-            p2 = p2 + p2ref;
-        }
-
-        // linear interpolation
-        ar_nodes[i].AbsPosition = p1 + tratio * (p2 - p1);
+        ar_nodes[i].AbsPosition = Vector3(pos[i], pos[stride + i], pos[2 * stride + i]);
         ar_nodes[i].RelPosition = ar_nodes[i].AbsPosition - ar_origin;
-        ar_nodes[i].Velocity    = (p2 - p1) * 1000.0f / (float)(oob2->time - oob1->time);
+        ar_nodes[i].Velocity    = Vector3(vel[i], vel[stride + i], vel[2 * stride + i]);
     }
 
+    const float* net_rp1 = u1.wheel_data.data();
+    const float* net_rp2 = u2.wheel_data.data();
     for (int i = 0; i < ar_num_wheels; i++)
     {
-        float rp = net_rp1[i] + tratio * (net_rp2[i] - net_rp1[i]);
+        wheel_t& wheel = ar_wheels[i];
+        float rp = net_rp1[i] + (tratio + extrapolation / span) * (net_rp2[i] - net_rp1[i]);
         //compute ideal positions
-        Vector3 axis = ar_wheels[i].wh_axis_node_1->RelPosition - ar_wheels[i].wh_axis_node_0->RelPosition;
+        Vector3 axis = wheel.wh_axis_node_1->RelPosition - wheel.wh_axis_node_0->RelPosition;
         axis.normalise();
-        Plane pplan = Plane(axis, ar_wheels[i].wh_axis_node_0->AbsPosition);
-        Vector3 ortho = -pplan.projectVector(ar_wheels[i].wh_near_attach_node->AbsPosition) - ar_wheels[i].wh_axis_node_0->AbsPosition;
+        const Vector3 near_attach = wheel.wh_near_attach_node->AbsPosition;
+        Vector3 ortho = -(near_attach - axis.dotProduct(near_attach) * axis) - wheel.wh_axis_node_0->AbsPosition; // Projected onto the wheel plane
         Vector3 ray = ortho.crossProduct(axis);
         ray.normalise();
-        ray *= ar_wheels[i].wh_radius;
-        float drp = Math::TWO_PI / (ar_wheels[i].wh_num_nodes / 2);
-        for (int j = 0; j < ar_wheels[i].wh_num_nodes / 2; j++)
-        {
-            Vector3 uray = Quaternion(Radian(rp - drp * j), axis) * ray;
-
-            ar_wheels[i].wh_nodes[j * 2 + 0]->AbsPosition = ar_wheels[i].wh_axis_node_0->AbsPosition + uray;
-            ar_wheels[i].wh_nodes[j * 2 + 0]->RelPosition = ar_wheels[i].wh_nodes[j * 2]->AbsPosition - ar_origin;
 
-            ar_wheels[i].wh_nodes[j * 2 + 1]->AbsPosition = ar_wheels[i].wh_axis_node_1->AbsPosition + uray;
-            ar_wheels[i].wh_nodes[j * 2 + 1]->RelPosition = ar_wheels[i].wh_nodes[j * 2 + 1]->AbsPosition - ar_origin;
-        }
-        ray.normalise();
-        ray *= ar_wheels[i].wh_rim_radius;
-        for (int j = 0; j < ar_wheels[i].wh_num_rim_nodes / 2; j++)
+        // Rotate the ray step by step instead of building a quaternion per node
+        const int num_steps = std::max(wheel.wh_num_nodes / 2, wheel.wh_num_rim_nodes / 2);
+        const float drp = Math::TWO_PI / (wheel.wh_num_nodes / 2);
+        const Matrix3 step = Quaternion(Radian(-drp), axis).ToRotationMatrix();
+        Vector3 uray = Quaternion(Radian(rp), axis) * ray;
+        for (int j = 0; j < num_steps; j++, uray = step * uray)
         {
-            Vector3 uray = Quaternion(Radian(rp - drp * j), axis) * ray;
+            if (j < wheel.wh_num_nodes / 2)
+            {
+                wheel.wh_nodes[j * 2 + 0]->AbsPosition = wheel.wh_axis_node_0->AbsPosition + uray * wheel.wh_radius;
+                wheel.wh_nodes[j * 2 + 0]->RelPosition = wheel.wh_nodes[j * 2]->AbsPosition - ar_origin;
 
-            ar_wheels[i].wh_rim_nodes[j * 2 + 0]->AbsPosition = ar_wheels[i].wh_axis_node_0->AbsPosition + uray;
-            ar_wheels[i].wh_rim_nodes[j * 2 + 0]->RelPosition = ar_wheels[i].wh_rim_nodes[j * 2]->AbsPosition - ar_origin;
+                wheel.wh_nodes[j * 2 + 1]->AbsPosition = wheel.wh_axis_node_1->AbsPosition + uray * wheel.wh_radius;
+                wheel.wh_nodes[j * 2 + 1]->RelPosition = wheel.wh_nodes[j * 2 + 1]->AbsPosition - ar_origin;
+            }
+            if (j < wheel.wh_num_rim_nodes / 2)
+            {
+                wheel.wh_rim_nodes[j * 2 + 0]->AbsPosition = wheel.wh_axis_node_0->AbsPosition + uray * wheel.wh_rim_radius;
+                wheel.wh_rim_nodes[j * 2 + 0]->RelPosition = wheel.wh_rim_nodes[j * 2]->AbsPosition - ar_origin;
 
-            ar_wheels[i].wh_rim_nodes[j * 2 + 1]->AbsPosition = ar_wheels[i].wh_axis_node_1->AbsPosition + uray;
-            ar_wheels[i].wh_rim_nodes[j * 2 + 1]->RelPosition = ar_wheels[i].wh_rim_nodes[j * 2 + 1]->AbsPosition - ar_origin;
+                wheel.wh_rim_nodes[j * 2 + 1]->AbsPosition = wheel.wh_axis_node_1->AbsPosition + uray * wheel.wh_rim_radius;
+                wheel.wh_rim_nodes[j * 2 + 1]->RelPosition = wheel.wh_rim_nodes[j * 2 + 1]->AbsPosition - ar_origin;
+            }
         }
     }
     this->UpdateBoundingBoxes();
     this->calculateAveragePosition();
 
+    m_net_playout_index = index_offset;
+    m_net_playout_tratio = tratio;
+    m_net_playout_valid = true;
+}
+
+void Actor::CalcNetwork()
+{
+    using namespace RoRnet;
+
+    if (!m_net_playout_valid)
+        return;
+
+    const int index_offset = m_net_playout_index;
+    const float tratio = m_net_playout_tratio;
+    VehicleState* oob1 = (VehicleState*)m_net_updates[index_offset    ].veh_state.data();
+    VehicleState* oob2 = (VehicleState*)m_net_updates[index_offset + 1].veh_state.data();
+
     float engspeed = oob1->engine_speed + tratio * (oob2->engine_speed - oob1->engine_speed);
     float engforce = oob1->engine_force + tratio * (oob2->engine_force - oob1->engine_force);
     float engclutch = oob1->engine_clutch + tratio * (oob2->engine_clutch - oob1->engine_clutch);
@@ -631,10 +675,12 @@ void Actor::CalcNetwork()
     else
         SOUND_STOP(ar_instance_id, SS_TRIG_REVERSE_GEAR);
 
-    for (int i = 0; i < index_offset; i++)
+    // Keep one update before the current one for the tangents
+    for (int i = 0; i < index_offset - 1; i++)
     {
         m_net_updates.pop_front();
     }
+    m_net_playout_valid = false;
 
     m_net_initialized = true;
 }
@@ -1874,6 +1920,7 @@ void Actor::sendStreamSetup()
         strncpy(reg.skin, m_used_skin_entry->dname.c_str(), 60);
     }
     strncpy(reg.sectionconfig, m_section_config.c_str(), 60);
+    reg.bufferSize = NODE_STREAM_OFFER_DELTA_V1; // Unused so far, see NodeStreamFormat
 
 #ifdef USE_SOCKETW
     App::GetNetwork()->AddLocalStream((RoRnet::StreamRegister *)&reg, sizeof(RoRnet::ActorStreamRegister));
@@ -1883,13 +1930,10 @@ void Actor::sendStreamSetup()
     ar_net_stream_id = reg.origin_streamid;
 }
 
-void Actor::sendStreamData()
+size_t Actor::sendStreamData()
 {
     using namespace RoRnet;
 #ifdef USE_SOCKETW
-    if (ar_net_timer.getMilliseconds() - ar_net_last_update_time < 100)
-        return;
-
     ar_net_last_update_time = ar_net_timer.getMilliseconds();
 
     //look if the packet is too big first
@@ -1998,47 +2042,220 @@ void Actor::sendStreamData()
             send_oob->flagmask += NETMASK_HORN;
     }
 
+    // quantize the nodes relative to the reference node
+    Vector3& refpos = ar_nodes[0].AbsPosition;
+    m_net_send_nodes.resize(std::max(0, m_net_first_wheel_node - 1) * 3);
+    for (int i = 1; i < m_net_first_wheel_node; i++)
+    {
+        Vector3 relpos = ar_nodes[i].AbsPosition - refpos;
+        m_net_send_nodes[(i - 1) * 3 + 0] = (short int)(relpos.x * m_net_node_compression);
+        m_net_send_nodes[(i - 1) * 3 + 1] = (short int)(relpos.y * m_net_node_compression);
+        m_net_send_nodes[(i - 1) * 3 + 2] = (short int)(relpos.z * m_net_node_compression);
+    }
+    this->RecordNodeStream();
+
     // then process the contents
+    bool keyframe = false;
+    if (!this->CanSendNodeStreamDelta() || !this->WriteNodeStreamDelta(send_buffer, sizeof(send_buffer), packet_len, keyframe))
     {
+        keyframe = false;
+        m_net_send_key_valid = false; // Start with a keyframe once deltas are possible again
+
         char* ptr = send_buffer + sizeof(RoRnet::VehicleState);
         float* send_nodes = (float *)ptr;
         packet_len += m_net_buffer_size;
 
-        // copy data into the buffer
-        int i;
-
         // reference node first
-        Vector3& refpos = ar_nodes[0].AbsPosition;
         send_nodes[0] = refpos.x;
         send_nodes[1] = refpos.y;
         send_nodes[2] = refpos.z;
 
         ptr += sizeof(float) * 3;// plus 3 floats from above
 
-        // then copy the other nodes into a compressed short format
-        short* sbuf = (short*)ptr;
-        for (i = 1; i < m_net_first_wheel_node; i++)
-        {
-            Vector3 relpos = ar_nodes[i].AbsPosition - refpos;
-            sbuf[(i - 1) * 3 + 0] = (short int)(relpos.x * m_net_node_compression);
-            sbuf[(i - 1) * 3 + 1] = (short int)(relpos.y * m_net_node_compression);
-            sbuf[(i - 1) * 3 + 2] = (short int)(relpos.z * m_net_node_compression);
-
-            ptr += sizeof(short int) * 3; // increase pointer
-        }
+        // then the other nodes in a compressed short format
+        memcpy(ptr, m_net_send_nodes.data(), m_net_send_nodes.size() * sizeof(int16_t));
+        ptr += m_net_send_nodes.size() * sizeof(int16_t);
 
         // then to the wheels
         float* wfbuf = (float*)ptr;
-        for (i = 0; i < ar_num_wheels; i++)
+        for (int i = 0; i < ar_num_wheels; i++)
         {
             wfbuf[i] = ar_wheels[i].wh_net_rp;
         }
     }
 
-    App::GetNetwork()->AddPacket(ar_net_stream_id, MSG2_STREAM_DATA_DISCARDABLE, packet_len, send_buffer);
+    // Deltas are useless without their keyframe, so keyframes must not be discarded
+    App::GetNetwork()->AddPacket(ar_net_stream_id, keyframe ? MSG2_STREAM_DATA : MSG2_STREAM_DATA_DISCARDABLE, packet_len, send_buffer);
+    return packet_len;
+#else
+    return 0;
 #endif //SOCKETW
 }
 
+void Actor::RecordNodeStream()
+{
+    if (!App::mp_record_node_stream->GetBool())
+    {
+        if (m_net_stream_recording != nullptr)
+        {
+            fclose(m_net_stream_recording);
+            m_net_stream_recording = nullptr;
+        }
+        return;
+    }
+
+    // Raw format of Bench_Network_NodeStream: int32 node count, then int16[3 * count] per packet
+    if (m_net_stream_recording == nullptr)
+    {
+        const std::string path = PathCombine(App::sys_logs_dir->GetStr(), fmt::format("nodestream_{}_{}.raw", ar_instance_id, (int)time(nullptr)));
+        m_net_stream_recording = fopen(path.c_str(), "wb");
+        const int32_t num_nodes = static_cast<int32_t>(m_net_send_nodes.size() / 3);
+        if (m_net_stream_recording == nullptr || fwrite(&num_nodes, sizeof(num_nodes), 1, m_net_stream_recording) != 1)
+        {
+            LOG("[RoR|Network] Cannot record node stream to '" + path + "', disabling 'mp_record_node_stream'");
+            App::mp_record_node_stream->SetVal(false);
+            if (m_net_stream_recording != nullptr)
+            {
+                fclose(m_net_stream_recording);
+                m_net_stream_recording = nullptr;
+            }
+            return;
+        }
+        LOG("[RoR|Network] Recording node stream to '" + path + "'");
+    }
+    fwrite(m_net_send_nodes.data(), sizeof(int16_t), m_net_send_nodes.size(), m_net_stream_recording);
+}
+
+bool Actor::CanSendNodeStreamDelta()
+{
+#ifdef USE_SOCKETW
+    std::vector<RoRnet::UserInfo> users = App::GetNetwork()->GetUserInfos();
+    if (users.empty())
+        return false;
+
+    for (RoRnet::UserInfo const& user: users)
+    {
+        auto result = ar_net_stream_results.find(user.uniqueid);
+        if (result == ar_net_stream_results.end())
+            return false; // Not answered yet, may be an old client
+        if (result->second != 1)
+            continue; // Doesn't receive our stream anyway
+        auto format = ar_net_stream_formats.find(user.uniqueid);
+        if (format == ar_net_stream_formats.end() || format->second != NODE_STREAM_ACCEPT_DELTA_V1)
+            return false;
+    }
+    return true;
+#else
+    return false;
+#endif // USE_SOCKETW
+}
+
+bool Actor::WriteNodeStreamDelta(char* buffer, size_t capacity, unsigned int& packet_len, bool& keyframe)
+{
+    const int num_nodes = static_cast<int>(m_net_send_nodes.size() / 3);
+    const size_t header_len = sizeof(RoRnet::VehicleState) + sizeof(NodeStreamHeader) + ar_num_wheels * sizeof(float);
+    if (num_nodes > UINT16_MAX || header_len >= capacity)
+        return false;
+
+    RoRnet::VehicleState* oob = (RoRnet::VehicleState*)buffer;
+    NodeStreamHeader* header = (NodeStreamHeader*)(buffer + sizeof(RoRnet::VehicleState));
+    float* wfbuf = (float*)(header + 1);
+    uint8_t* bits = (uint8_t*)(buffer + header_len);
+    const size_t bits_capacity = capacity - header_len;
+
+    header->flags = 0;
+    size_t bits_len = 0;
+    keyframe = !m_net_send_key_valid || m_net_packets_since_key >= NODE_STREAM_KEYFRAME_INTERVAL;
+    if (!keyframe)
+    {
+        bits_len = NodeStreamEncode(m_net_send_nodes.data(), m_net_send_key.data(), num_nodes,
+            header->golomb_k, bits, bits_capacity, m_net_codec_scratch);
+        // Too much has changed since the keyframe, a new one is cheaper in the long run
+        keyframe = (bits_len == 0 || bits_len > m_net_send_key_bytes * 3 / 4);
+    }
+    if (keyframe)
+    {
+        bits_len = NodeStreamEncode(m_net_send_nodes.data(), nullptr, num_nodes,
+            header->golomb_k, bits, bits_capacity, m_net_codec_scratch);
+        if (bits_len == 0)
+            return false;
+
+        m_net_send_key = m_net_send_nodes;
+        m_net_send_key_id++;
+        m_net_send_key_bytes = bits_len;
+        m_net_send_key_valid = true;
+        m_net_packets_since_key = 0;
+        header->flags |= NODE_STREAM_FLAG_KEYFRAME;
+    }
+    else
+    {
+        m_net_packets_since_key++;
+    }
+
+    Vector3 const& refpos = ar_nodes[0].AbsPosition;
+    header->ref_pos[0] = refpos.x;
+    header->ref_pos[1] = refpos.y;
+    header->ref_pos[2] = refpos.z;
+    header->key_id = m_net_send_key_id;
+    header->num_nodes = static_cast<uint16_t>(num_nodes);
+    header->send_interval = static_cast<uint16_t>(std::min(ar_net_send_interval, (int)UINT16_MAX));
+
+    for (int i = 0; i < ar_num_wheels; i++)
+    {
+        wfbuf[i] = ar_wheels[i].wh_net_rp;
+    }
+
+    oob->flagmask |= RoRnet::NETMASK_NODE_STREAM_DELTA;
+    packet_len = static_cast<unsigned int>(header_len + bits_len);
+    return true;
+}
+
+bool Actor::ReadNodeStreamDelta(const char* data, int size, NetUpdate& update, bool& mismatch)
+{
+    const size_t header_len = sizeof(RoRnet::VehicleState) + sizeof(NodeStreamHeader) + ar_num_wheels * sizeof(float);
+    const int num_nodes = std::max(0, m_net_first_wheel_node - 1);
+    if ((size_t)size < header_len)
+    {
+        mismatch = true;
+        return false;
+    }
+
+    NodeStreamHeader header;
+    memcpy(&header, data + sizeof(RoRnet::VehicleState), sizeof(NodeStreamHeader));
+    if (header.num_nodes != num_nodes)
+    {
+        mismatch = true;
+        return false;
+    }
+
+    const uint8_t* bits = (const uint8_t*)(data + header_len);
+    const size_t bits_len = size - header_len;
+    m_net_recv_nodes.resize(num_nodes * 3);
+    if (header.flags & NODE_STREAM_FLAG_KEYFRAME)
+    {
+        if (!NodeStreamDecode(bits, bits_len, nullptr, num_nodes, header.golomb_k, m_net_recv_nodes.data()))
+            return false;
+        m_net_recv_key = m_net_recv_nodes;
+        m_net_recv_key_id = header.key_id;
+        m_net_recv_key_valid = true;
+    }
+    else
+    {
+        if (!m_net_recv_key_valid || header.key_id != m_net_recv_key_id)
+            return false; // Joined late or keyframe not received yet
+        if (!NodeStreamDecode(bits, bits_len, m_net_recv_key.data(), num_nodes, header.golomb_k, m_net_recv_nodes.data()))
+            return false;
+    }
+
+    update.send_interval = header.send_interval;
+    memcpy(update.veh_state.data(), data, sizeof(RoRnet::VehicleState));
+    DecodeNodePositions(header.ref_pos, m_net_recv_nodes.data(), num_nodes, 1.f / m_net_node_compression,
+        update.node_pos.data(), GetNodeSoaStride(m_net_first_wheel_node));
+    memcpy(update.wheel_data.data(), data + sizeof(RoRnet::VehicleState) + sizeof(NodeStreamHeader),
+        ar_num_wheels * sizeof(float));
+    return true;
+}
+
 void Actor::CalcAnimators(const int flag_state, float& cstate, int& div, Real timer, const float lower_limit, const float upper_limit, const float option3)
 {
     // ## DEV NOTE:
@@ -4384,6 +4601,7 @@ Actor::Actor(
     , m_inter_point_col_detector(nullptr)
     , m_intra_point_col_detector(nullptr)
     , ar_net_last_update_time(0)
+    , ar_net_send_interval(100)
     , m_avg_node_position_prev(rq.asr_position)
     , ar_left_mirror_angle(0.52)
     , m_avg_node_velocity(Ogre::Vector3::ZERO)
@@ -4409,7 +4627,6 @@ Actor::Actor(
     , m_avg_node_position(rq.asr_position)
     , m_previous_gear(0)
     , m_tyre_pressure(this)
-    , m_replay_handler(nullptr)
     , ar_right_mirror_angle(-0.52)
     , ar_rudder(0)
     , ar_update_physics(false)
@@ -4538,10 +4755,10 @@ Ogre::Real Actor::getMinimalCameraRadius()
 
 Replay* Actor::GetReplay()
 {
-    if (m_replay_handler && m_replay_handler->isValid())
-        return m_replay_handler;
-    else
+    if (ar_sim_state == SimState::NETWORKED_OK)
         return nullptr;
+    else
+        return App::GetGameContext()->GetActorManager()->GetReplay();
 }
 
 Vector3 Actor::getNodePosition(int nodeNumber)
@@ -63,8 +63,9 @@ public:
     ~Actor();
 
     void              ApplyNodeBeamScales();
-    void              PushNetwork(char* data, int size);   //!< Parses network data; fills actor's data buffers and flips them. Called by the network thread.
-    void              CalcNetwork();
+    void              PushNetwork(const char* data, int size);   //!< Parses network data; fills actor's data buffers and flips them. Called by the network thread.
+    void              CalcNetworkNodes();                  //!< Remote actors: node positions from the received updates; touches nothing but this actor
+    void              CalcNetwork();                       //!< Remote actors: the rest of the state; call after CalcNetworkNodes()
     float             getRotation();
     Ogre::Vector3     getDirection();
     Ogre::Vector3     getPosition();
@@ -144,7 +145,7 @@ public:
     void              setBlinkType(BlinkType blink);
     void              setAirbrakeIntensity(float intensity);
     bool              getCustomParticleMode();
-    void              sendStreamData();
+    size_t            sendStreamData();                    //!< Returns bytes queued for sending; timing is up to `ActorManager::UpdateNetSendScheduler()`
     bool              isTied();
     bool              isLocked(); 
     bool              hasSlidenodes() { return !m_slidenodes.empty(); };
@@ -168,7 +169,7 @@ public:
     void              RequestUpdateHudFeatures()        { m_hud_features_ok = false; }
     Ogre::Vector3     getNodePosition(int nodeNumber);     //!< Returns world position of node
     Ogre::Real        getMinimalCameraRadius();
-    Replay*           GetReplay();
+    Replay*           GetReplay(); //!< The scene-wide recorder (see `ActorManager::GetReplay()`), unless networked
     float             GetFFbHydroForces() const         { return m_force_sensors.out_hydros_forces; }
     bool              isPreloadedWithTerrain() const    { return m_preloaded_with_terrain; };
     bool              isBeingReset() const              { return m_ongoing_reset; };
@@ -330,8 +331,10 @@ public:
     int               ar_net_source_id;               //!< Unique ID of remote player who spawned this actor
     int               ar_net_stream_id;
     std::map<int,int> ar_net_stream_results;
+    std::map<int,int> ar_net_stream_formats;          //!< Node stream format accepted by each remote user, see NodeStreamFormat
     Ogre::Timer       ar_net_timer;
     unsigned long     ar_net_last_update_time;
+    int               ar_net_send_interval;           //!< Network state; milliseconds between updates of a local actor, set by ActorManager
     DashBoardManager* ar_dashboard;
     SimState          ar_sim_state;                   //!< Sim state
     float             ar_collision_range;             //!< Physics attr
@@ -373,11 +376,52 @@ public:
 
 private:
 
+    /// Plain beam over its `minmaxposnegstress`; deformation/breaking is finished serially after the parallel pass
+    struct DeferredBeam
+    {
+        int           beam;
+        float         diff;
+        float         slen;
+        float         inv;
+        Ogre::Vector3 dis;
+    };
+
+    /// Force a detacher-group beam added to a private buffer; taken back if the group breaks later in the step
+    struct DetachableBeam
+    {
+        int           beam;
+        int           n1, n2; //!< Relative to `BeamChunk::node_lo`
+        Ogre::Vector3 force;
+    };
+
+    /// Slice of `m_plain_beams` processed by one task of the intra-actor parallel CalcBeams()
+    struct BeamChunk
+    {
+        int                        begin, end;       //!< Range in `m_plain_beams`
+        int                        node_lo, node_hi; //!< Nodes touched by the slice; `forces[0]` belongs to `ar_nodes[node_lo]`
+        std::vector<Ogre::Vector3> forces;           //!< Private force buffer, reduced in chunk order
+        std::vector<DeferredBeam>  deferred;
+        std::vector<DetachableBeam> detachable;      //!< Accumulated beams with a detacher group
+    };
+
+    /// Shared state produced by CalcNodesRange(); folded in chunk order by ApplyNodeChunk()
+    struct NodeChunk
+    {
+        ground_model_t*            fuzzy_ground_model = nullptr;
+        bool                       water_contact = false;
+        bool                       exploded = false;
+    };
+
     bool              CalcForcesEulerPrepare(bool doUpdate); 
     void              CalcAircraftForces(bool doUpdate);   
     void              CalcForcesEulerCompute(bool doUpdate, int num_steps); 
     void              CalcAnimators(const int flag_state, float &cstate, int &div, float timer, const float lower_limit, const float upper_limit, const float option3); 
     void              CalcBeams(bool trigger_hooks);       
+    void              CalcBeamsPlain();                    //!< Vectorized; defined in 'physics/ActorForcesSIMD.cpp'
+    void              CalcBeamsPlainChunk(BeamChunk& chunk); //!< Thread-safe variant of `CalcBeamsPlain()`; defined in 'physics/ActorForcesSIMD.cpp'
+    void              CalcBeamsParallel();                 //!< Plain beams, split across the thread pool; defined in 'physics/ActorForcesParallel.cpp'
+    void              RevokeDetachedForces(int broken_beam); //!< Helper of `CalcBeamsParallel()`
+    void              CalcBeamDeformAndBreak(int i, Ogre::Real k, Ogre::Real difftoBeamL, Ogre::Real &slen); //!< Slow path of the beam kernels
     void              CalcBeamsInterActor();               
     void              CalcBuoyance(bool doUpdate);         
     void              CalcCommands(bool doUpdate);         
@@ -389,7 +433,9 @@ private:
     void              CalcHydros();                        
     void              CalcMouse();                         
     void              CalcNodes();                         
-    void              CalcReplay();                        
+    void              CalcNodesRange(int start, int end, NodeChunk& out, const Ogre::Vector3* turbulence);
+    void              CalcNodesParallel();                 //!< Defined in 'physics/ActorForcesParallel.cpp'
+    void              ApplyNodeChunk(NodeChunk const& chunk);
     void              CalcRopes();                         
     void              CalcShocks(bool doUpdate, int num_steps); 
     void              CalcShocks2(int i, Ogre::Real difftoBeamL, Ogre::Real &k, Ogre::Real &d, Ogre::Real v);
@@ -402,11 +448,17 @@ private:
     void              DetermineLinkedActors();
     void              RecalculateNodeMasses(Ogre::Real total); //!< Previously 'calc_masses2()'
     void              calcNodeConnectivityGraph();
+    void              PartitionBeams();                    //!< Sorts beams into `m_plain_beams`/`m_special_beams`; defined in 'physics/ActorForcesSIMD.cpp'
+    void              SetupParallelChunks();               //!< Fills `m_beam_chunks`/`m_node_chunks`; defined in 'physics/ActorForcesParallel.cpp'
+    bool              CanParallelizeForces() const;        //!< Intra-actor parallelism enabled (cvar 'sim_parallel_forces') and worth it
     void              AddInterActorBeam(beam_t* beam, Actor* a, Actor* b);
     void              RemoveInterActorBeam(beam_t* beam);
     void              DisjoinInterActorBeams();            //!< Destroys all inter-actor beams which are connected with this actor
     void              autoBlinkReset();                    //!< Resets the turn signal when the steering wheel is turned back.
     void              sendStreamSetup();
+    bool              CanSendNodeStreamDelta();            //!< All remote users which loaded this actor accepted the delta node format
+    bool              WriteNodeStreamDelta(char* buffer, size_t capacity, unsigned int& packet_len, bool& keyframe);
+    void              RecordNodeStream();                  //!< Appends `m_net_send_nodes` to a file while cvar 'mp_record_node_stream' is on
     void              UpdateSlideNodeForces(const Ogre::Real delta_time_sec); //!< calculate and apply Corrective forces
     void              resetSlideNodePositions();           //!< Recalculate SlideNode positions
     void              resetSlideNodes();                   //!< Reset all the SlideNodes
@@ -423,7 +475,7 @@ private:
 
     // -------------------- data -------------------- //
 
-    std::vector<std::shared_ptr<Task>> m_flexbody_tasks;   //!< Gfx state
+    std::vector<TaskHandle>            m_flexbody_tasks;   //!< Gfx state
     std::shared_ptr<RigDef::File>      m_definition;
     std::unique_ptr<GfxActor>          m_gfx_actor;
     PerVehicleCameraContext            m_camera_context;
@@ -436,6 +488,12 @@ private:
     int               m_num_proped_wheels;          //!< Physics attr, filled at spawn - Number of propelled wheels.
     float             m_avg_proped_wheel_radius;    //!< Physics attr, filled at spawn - Average proped wheel radius.
     float             m_avionic_chatter_timer;      //!< Sound fx state
+    std::vector<int>  m_plain_beams;                //!< Physics attr, filled at spawn - Indices of beams without `bounded` logic (SIMD kernel)
+    std::vector<int>  m_special_beams;              //!< Physics attr, filled at spawn - Indices of shocks, triggers, supportbeams, ropes
+    std::vector<BeamChunk> m_beam_chunks;           //!< Physics attr, filled at spawn - Slices of `m_plain_beams` for parallel CalcBeams()
+    std::vector<NodeChunk> m_node_chunks;           //!< Physics state - Per-slice results of parallel CalcNodes()
+    std::vector<Ogre::Vector3> m_node_turbulence;   //!< Physics state - Drag turbulence pre-drawn in node order, keeps parallel CalcNodes() deterministic
+    bool              m_parallel_forces = false;    //!< Physics state - Set each step by ActorManager, see `CanParallelizeForces()`
     PointColDetector* m_inter_point_col_detector;   //!< Physics
     PointColDetector* m_intra_point_col_detector;   //!< Physics
     std::vector<Actor*>  m_linked_actors;           //!< Sim state; other actors linked using 'hooks'
@@ -444,7 +502,6 @@ private:
     Ogre::Vector3     m_avg_node_position_prev;
     Ogre::Vector3     m_avg_node_velocity;          //!< average node velocity (compared to the previous frame step)
     float             m_stabilizer_shock_sleep;     //!< Sim state
-    Replay*           m_replay_handler;
     float             m_total_mass;            //!< Physics state; total mass in Kg
     int               m_mouse_grab_node;       //!< Sim state; node currently being dragged by user
     Ogre::Vector3     m_mouse_grab_pos;
@@ -540,11 +597,43 @@ private:
     struct NetUpdate
     {
         std::vector<char> veh_state;   //!< Actor properties (engine, brakes, lights, ...)
-        std::vector<char> node_data;   //!< Compressed node positions
+        std::vector<float> node_pos;   //!< Node positions up to the first wheel node, decoded on arrival; SoA, see NodeInterpolation.h
         std::vector<float> wheel_data; //!< Wheel rotations
+        int send_interval = 0;         //!< Milliseconds until the sender's next update; 0 = not announced (legacy format)
+        int time = 0;                  //!< Sender's clock, copy of `RoRnet::VehicleState::time`
     };
 
-    std::deque<NetUpdate> m_net_updates; //!< Incoming stream of NetUpdates
+    std::deque<NetUpdate> m_net_updates; //!< Incoming stream of NetUpdates, by increasing time
+
+    // Jitter buffer, see CalcNetworkNodes()
+    void                  UpdateNetPlayoutDelay(int tnow);
+    double                m_net_transit_mean = 0.0;     //!< ms; local arrival time minus sender's time, averaged
+    double                m_net_transit_jitter = 0.0;   //!< ms; mean deviation of the transit time
+    float                 m_net_interval_mean = 100.f;  //!< ms; between received updates
+    double                m_net_playout_delay = -1.0;   //!< ms; how far behind the sender's clock updates are played; < 0 until the first update
+    int                   m_net_playout_last_time = 0;
+    int                   m_net_playout_index = 0;      //!< Current update, from CalcNetworkNodes() for CalcNetwork()
+    float                 m_net_playout_tratio = 0.f;
+    bool                  m_net_playout_valid = false;
+    std::vector<float>    m_net_interp_pos;             //!< CalcNetworkNodes() scratch, SoA
+    std::vector<float>    m_net_interp_vel;
+
+    /// Decodes a delta format packet; returns false if it can't be used (no keyframe yet, malformed or `mismatch`-ing actor)
+    bool                  ReadNodeStreamDelta(const char* data, int size, NetUpdate& update, bool& mismatch);
+
+    // Node stream in the delta format, see NodeStreamCodec.h
+    std::vector<int16_t>  m_net_send_nodes;          //!< Quantized node positions of the packet being sent
+    std::vector<int16_t>  m_net_send_key;            //!< Last keyframe sent
+    std::vector<int16_t>  m_net_recv_nodes;          //!< Decoded node positions, scratch
+    std::vector<int16_t>  m_net_recv_key;            //!< Last keyframe received
+    std::vector<uint32_t> m_net_codec_scratch;
+    uint16_t              m_net_send_key_id = 0;
+    bool                  m_net_send_key_valid = false; //!< False until a keyframe is sent, and again after legacy packets
+    FILE*                 m_net_stream_recording = nullptr; //!< See cvar 'mp_record_node_stream'
+    size_t                m_net_send_key_bytes = 0;
+    int                   m_net_packets_since_key = 0;
+    uint16_t              m_net_recv_key_id = 0;
+    bool                  m_net_recv_key_valid = false;
 };
 
 } // namespace RoR
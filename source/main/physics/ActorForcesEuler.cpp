@@ -32,7 +32,6 @@
 #include "EngineSim.h"
 #include "FlexAirfoil.h"
 #include "GameContext.h"
-#include "Replay.h"
 #include "ScrewProp.h"
 #include "SoundScriptManager.h"
 #include "TerrainManager.h"
@@ -44,7 +43,6 @@ using namespace RoR;
 void Actor::CalcForcesEulerCompute(bool doUpdate, int num_steps)
 {
     this->CalcNodes(); // must be done directly after the inter truck collisions are handled
-    this->CalcReplay();
     this->CalcAircraftForces(doUpdate);
     this->CalcFuseDrag();
     this->CalcBuoyance(doUpdate);
@@ -1083,14 +1081,6 @@ void Actor::CalcTruckEngine(bool doUpdate)
     }
 }
 
-void Actor::CalcReplay()
-{
-    if (m_replay_handler && m_replay_handler->isValid())
-    {
-        m_replay_handler->onPhysicsStep();
-    }
-}
-
 bool Actor::CalcForcesEulerPrepare(bool doUpdate)
 {
     if (m_ongoing_reset)
@@ -1127,7 +1117,13 @@ void LogBeamNodes(RoR::Str<L>& msg, beam_t& beam) // Internal helper
 
 void Actor::CalcBeams(bool trigger_hooks)
 {
-    for (int i = 0; i < ar_num_beams; i++)
+    // Plain beams (no `bounded` logic) go through the vectorized kernel, see ActorForcesSIMD.cpp
+    if (m_parallel_forces)
+        this->CalcBeamsParallel();
+    else
+        this->CalcBeamsPlain();
+
+    for (int i: m_special_beams)
     {
         if (!ar_beams[i].bm_disabled && !ar_beams[i].bm_inter_actor)
         {
@@ -1236,144 +1232,150 @@ void Actor::CalcBeams(bool trigger_hooks)
             ar_beams[i].stress = slen;
 
             // Fast test for deformation
-            float len = std::abs(slen);
-            if (len > ar_beams[i].minmaxposnegstress)
+            if (std::abs(slen) > ar_beams[i].minmaxposnegstress)
             {
-                if (ar_beams[i].bm_type == BEAM_NORMAL && ar_beams[i].bounded != SHOCK1 && k != 0.0f)
-                {
-                    // Actual deformation tests
-                    if (slen > ar_beams[i].maxposstress && difftoBeamL < 0.0f) // compression
-                    {
-                        Real yield_length = ar_beams[i].maxposstress / k;
-                        Real deform = difftoBeamL + yield_length * (1.0f - ar_beams[i].plastic_coef);
-                        Real Lold = ar_beams[i].L;
-                        ar_beams[i].L += deform;
-                        ar_beams[i].L = std::max(MIN_BEAM_LENGTH, ar_beams[i].L);
-                        slen = slen - (slen - ar_beams[i].maxposstress) * 0.5f;
-                        len = slen;
-                        if (ar_beams[i].L > 0.0f && Lold > ar_beams[i].L)
-                        {
-                            ar_beams[i].maxposstress *= Lold / ar_beams[i].L;
-                            ar_beams[i].minmaxposnegstress = std::min(ar_beams[i].maxposstress, -ar_beams[i].maxnegstress);
-                            ar_beams[i].minmaxposnegstress = std::min(ar_beams[i].minmaxposnegstress, ar_beams[i].strength);
-                        }
-                        // For the compression case we do not remove any of the beam's
-                        // strength for structure stability reasons
-                        //ar_beams[i].strength += deform * k * 0.5f;
-                        if (m_beam_deform_debug_enabled)
-                        {
-                            RoR::Str<300> msg;
-                            msg << "[RoR|Diag] YYY Beam " << i << " just deformed with extension force "
-                                << len << " / " << ar_beams[i].strength << ". ";
-                            LogBeamNodes(msg, ar_beams[i]);
-                            RoR::Log(msg.ToCStr());
-                        }
-                    }
-                    else if (slen < ar_beams[i].maxnegstress && difftoBeamL > 0.0f) // expansion
-                    {
-                        Real yield_length = ar_beams[i].maxnegstress / k;
-                        Real deform = difftoBeamL + yield_length * (1.0f - ar_beams[i].plastic_coef);
-                        Real Lold = ar_beams[i].L;
-                        ar_beams[i].L += deform;
-                        slen = slen - (slen - ar_beams[i].maxnegstress) * 0.5f;
-                        len = -slen;
-                        if (Lold > 0.0f && ar_beams[i].L > Lold)
-                        {
-                            ar_beams[i].maxnegstress *= ar_beams[i].L / Lold;
-                            ar_beams[i].minmaxposnegstress = std::min(ar_beams[i].maxposstress, -ar_beams[i].maxnegstress);
-                            ar_beams[i].minmaxposnegstress = std::min(ar_beams[i].minmaxposnegstress, ar_beams[i].strength);
-                        }
-                        ar_beams[i].strength -= deform * k;
-                        if (m_beam_deform_debug_enabled)
-                        {
-                            RoR::Str<300> msg;
-                            msg << "[RoR|Diag] YYY Beam " << i << " just deformed with extension force "
-                                << len << " / " << ar_beams[i].strength << ". ";
-                            LogBeamNodes(msg, ar_beams[i]);
-                            RoR::Log(msg.ToCStr());
-                        }
-                    }
-                }
+                this->CalcBeamDeformAndBreak(i, k, difftoBeamL, slen);
+            }
 
-                // Test if the beam should break
-                if (len > ar_beams[i].strength)
-                {
-                    // Sound effect.
-                    // Sound volume depends on springs stored energy
-                    SOUND_MODULATE(ar_instance_id, SS_MOD_BREAK, 0.5 * k * difftoBeamL * difftoBeamL);
-                    SOUND_PLAY_ONCE(ar_instance_id, SS_TRIG_BREAK);
+            // At last update the beam forces
+            Vector3 f = dis;
+            f *= (slen * inverted_dislen);
+            ar_beams[i].p1->Forces += f;
+            ar_beams[i].p2->Forces -= f;
+        }
+    }
+}
 
-                    //Break the beam only when it is not connected to a node
-                    //which is a part of a collision triangle and has 2 "live" beams or less
-                    //connected to it.
-                    if (!((ar_beams[i].p1->nd_cab_node && GetNumActiveConnectedBeams(ar_beams[i].p1->pos) < 3) || (ar_beams[i].p2->nd_cab_node && GetNumActiveConnectedBeams(ar_beams[i].p2->pos) < 3)))
-                    {
-                        slen = 0.0f;
-                        ar_beams[i].bm_broken = true;
-                        ar_beams[i].bm_disabled = true;
+void Actor::CalcBeamDeformAndBreak(int i, Real k, Real difftoBeamL, Real& slen)
+{
+    float len = std::abs(slen);
 
-                        if (m_beam_break_debug_enabled)
-                        {
-                            RoR::Str<200> msg;
-                            msg << "[RoR|Diag] XXX Beam " << i << " just broke with force " << len << " / " << ar_beams[i].strength << ". ";
-                            LogBeamNodes(msg, ar_beams[i]);
-                            RoR::Log(msg.ToCStr());
-                        }
+    if (ar_beams[i].bm_type == BEAM_NORMAL && ar_beams[i].bounded != SHOCK1 && k != 0.0f)
+    {
+        // Actual deformation tests
+        if (slen > ar_beams[i].maxposstress && difftoBeamL < 0.0f) // compression
+        {
+            Real yield_length = ar_beams[i].maxposstress / k;
+            Real deform = difftoBeamL + yield_length * (1.0f - ar_beams[i].plastic_coef);
+            Real Lold = ar_beams[i].L;
+            ar_beams[i].L += deform;
+            ar_beams[i].L = std::max(MIN_BEAM_LENGTH, ar_beams[i].L);
+            slen = slen - (slen - ar_beams[i].maxposstress) * 0.5f;
+            len = slen;
+            if (ar_beams[i].L > 0.0f && Lold > ar_beams[i].L)
+            {
+                ar_beams[i].maxposstress *= Lold / ar_beams[i].L;
+                ar_beams[i].minmaxposnegstress = std::min(ar_beams[i].maxposstress, -ar_beams[i].maxnegstress);
+                ar_beams[i].minmaxposnegstress = std::min(ar_beams[i].minmaxposnegstress, ar_beams[i].strength);
+            }
+            // For the compression case we do not remove any of the beam's
+            // strength for structure stability reasons
+            //ar_beams[i].strength += deform * k * 0.5f;
+            if (m_beam_deform_debug_enabled)
+            {
+                RoR::Str<300> msg;
+                msg << "[RoR|Diag] YYY Beam " << i << " just deformed with extension force "
+                    << len << " / " << ar_beams[i].strength << ". ";
+                LogBeamNodes(msg, ar_beams[i]);
+                RoR::Log(msg.ToCStr());
+            }
+        }
+        else if (slen < ar_beams[i].maxnegstress && difftoBeamL > 0.0f) // expansion
+        {
+            Real yield_length = ar_beams[i].maxnegstress / k;
+            Real deform = difftoBeamL + yield_length * (1.0f - ar_beams[i].plastic_coef);
+            Real Lold = ar_beams[i].L;
+            ar_beams[i].L += deform;
+            slen = slen - (slen - ar_beams[i].maxnegstress) * 0.5f;
+            len = -slen;
+            if (Lold > 0.0f && ar_beams[i].L > Lold)
+            {
+                ar_beams[i].maxnegstress *= ar_beams[i].L / Lold;
+                ar_beams[i].minmaxposnegstress = std::min(ar_beams[i].maxposstress, -ar_beams[i].maxnegstress);
+                ar_beams[i].minmaxposnegstress = std::min(ar_beams[i].minmaxposnegstress, ar_beams[i].strength);
+            }
+            ar_beams[i].strength -= deform * k;
+            if (m_beam_deform_debug_enabled)
+            {
+                RoR::Str<300> msg;
+                msg << "[RoR|Diag] YYY Beam " << i << " just deformed with extension force "
+                    << len << " / " << ar_beams[i].strength << ". ";
+                LogBeamNodes(msg, ar_beams[i]);
+                RoR::Log(msg.ToCStr());
+            }
+        }
+    }
 
-                        // detachergroup check: beam[i] is already broken, check detacher group# == 0/default skip the check ( performance bypass for beams with default setting )
-                        // only perform this check if this is a master detacher beams (positive detacher group id > 0)
-                        if (ar_beams[i].detacher_group > 0)
-                        {
-                            // cycle once through the other beams
-                            for (int j = 0; j < ar_num_beams; j++)
-                            {
-                                // beam[i] detacher group# == checked beams detacher group# -> delete & disable checked beam
-                                // do this with all master(positive id) and minor(negative id) beams of this detacher group
-                                if (abs(ar_beams[j].detacher_group) == ar_beams[i].detacher_group)
-                                {
-                                    ar_beams[j].bm_broken = true;
-                                    ar_beams[j].bm_disabled = true;
-                                    if (m_beam_break_debug_enabled)
-                                    {
-                                        LOG("Deleting Detacher BeamID: " + TOSTRING(j) + ", Detacher Group: " + TOSTRING(ar_beams[i].detacher_group)+ ", actor ID: " + TOSTRING(ar_instance_id));
-                                    }
-                                }
-                            }
-                            // cycle once through all wheels
-                            for (int j = 0; j < ar_num_wheels; j++)
-                            {
-                                if (ar_wheels[j].wh_detacher_group == ar_beams[i].detacher_group)
-                                {
-                                    ar_wheels[j].wh_is_detached = true;
-                                }
-                            }
-                        }
-                    }
-                    else
-                    {
-                        ar_beams[i].strength = 2.0f * ar_beams[i].minmaxposnegstress;
-                    }
+    // Test if the beam should break
+    if (len > ar_beams[i].strength)
+    {
+        // Sound effect.
+        // Sound volume depends on springs stored energy
+        SOUND_MODULATE(ar_instance_id, SS_MOD_BREAK, 0.5 * k * difftoBeamL * difftoBeamL);
+        SOUND_PLAY_ONCE(ar_instance_id, SS_TRIG_BREAK);
+
+        //Break the beam only when it is not connected to a node
+        //which is a part of a collision triangle and has 2 "live" beams or less
+        //connected to it.
+        if (!((ar_beams[i].p1->nd_cab_node && GetNumActiveConnectedBeams(ar_beams[i].p1->pos) < 3) || (ar_beams[i].p2->nd_cab_node && GetNumActiveConnectedBeams(ar_beams[i].p2->pos) < 3)))
+        {
+            slen = 0.0f;
+            ar_beams[i].bm_broken = true;
+            ar_beams[i].bm_disabled = true;
+
+            if (m_beam_break_debug_enabled)
+            {
+                RoR::Str<200> msg;
+                msg << "[RoR|Diag] XXX Beam " << i << " just broke with force " << len << " / " << ar_beams[i].strength << ". ";
+                LogBeamNodes(msg, ar_beams[i]);
+                RoR::Log(msg.ToCStr());
+            }
 
-                    // something broke, check buoyant hull
-                    for (int mk = 0; mk < ar_num_buoycabs; mk++)
+            // detachergroup check: beam[i] is already broken, check detacher group# == 0/default skip the check ( performance bypass for beams with default setting )
+            // only perform this check if this is a master detacher beams (positive detacher group id > 0)
+            if (ar_beams[i].detacher_group > 0)
+            {
+                // cycle once through the other beams
+                for (int j = 0; j < ar_num_beams; j++)
+                {
+                    // beam[i] detacher group# == checked beams detacher group# -> delete & disable checked beam
+                    // do this with all master(positive id) and minor(negative id) beams of this detacher group
+                    if (abs(ar_beams[j].detacher_group) == ar_beams[i].detacher_group)
                     {
-                        int tmpv = ar_buoycabs[mk] * 3;
-                        if (ar_buoycab_types[mk] == Buoyance::BUOY_DRAGONLY)
-                            continue;
-                        if ((ar_beams[i].p1 == &ar_nodes[ar_cabs[tmpv]] || ar_beams[i].p1 == &ar_nodes[ar_cabs[tmpv + 1]] || ar_beams[i].p1 == &ar_nodes[ar_cabs[tmpv + 2]]) &&
-                            (ar_beams[i].p2 == &ar_nodes[ar_cabs[tmpv]] || ar_beams[i].p2 == &ar_nodes[ar_cabs[tmpv + 1]] || ar_beams[i].p2 == &ar_nodes[ar_cabs[tmpv + 2]]))
+                        ar_beams[j].bm_broken = true;
+                        ar_beams[j].bm_disabled = true;
+                        if (m_beam_break_debug_enabled)
                         {
-                            m_buoyance->sink = true;
+                            LOG("Deleting Detacher BeamID: " + TOSTRING(j) + ", Detacher Group: " + TOSTRING(ar_beams[i].detacher_group)+ ", actor ID: " + TOSTRING(ar_instance_id));
                         }
                     }
                 }
+                // cycle once through all wheels
+                for (int j = 0; j < ar_num_wheels; j++)
+                {
+                    if (ar_wheels[j].wh_detacher_group == ar_beams[i].detacher_group)
+                    {
+                        ar_wheels[j].wh_is_detached = true;
+                    }
+                }
             }
+        }
+        else
+        {
+            ar_beams[i].strength = 2.0f * ar_beams[i].minmaxposnegstress;
+        }
 
-            // At last update the beam forces
-            Vector3 f = dis;
-            f *= (slen * inverted_dislen);
-            ar_beams[i].p1->Forces += f;
-            ar_beams[i].p2->Forces -= f;
+        // something broke, check buoyant hull
+        for (int mk = 0; mk < ar_num_buoycabs; mk++)
+        {
+            int tmpv = ar_buoycabs[mk] * 3;
+            if (ar_buoycab_types[mk] == Buoyance::BUOY_DRAGONLY)
+                continue;
+            if ((ar_beams[i].p1 == &ar_nodes[ar_cabs[tmpv]] || ar_beams[i].p1 == &ar_nodes[ar_cabs[tmpv + 1]] || ar_beams[i].p1 == &ar_nodes[ar_cabs[tmpv + 2]]) &&
+                (ar_beams[i].p2 == &ar_nodes[ar_cabs[tmpv]] || ar_beams[i].p2 == &ar_nodes[ar_cabs[tmpv + 1]] || ar_beams[i].p2 == &ar_nodes[ar_cabs[tmpv + 2]]))
+            {
+                m_buoyance->sink = true;
+            }
         }
     }
 }
@@ -1512,23 +1514,75 @@ void Actor::CalcBeamsInterActor()
 }
 
 void Actor::CalcNodes()
+{
+    m_water_contact = false;
+
+    if (m_parallel_forces)
+    {
+        this->CalcNodesParallel();
+    }
+    else
+    {
+        NodeChunk result;
+        this->CalcNodesRange(0, ar_num_nodes, result, nullptr);
+        this->ApplyNodeChunk(result);
+    }
+
+    this->UpdateBoundingBoxes();
+}
+
+void Actor::ApplyNodeChunk(NodeChunk const& chunk)
+{
+    if (chunk.fuzzy_ground_model != nullptr)
+    {
+        ar_last_fuzzy_ground_model = chunk.fuzzy_ground_model;
+    }
+    if (chunk.water_contact)
+    {
+        m_water_contact = true;
+    }
+    if (chunk.exploded && !m_ongoing_reset)
+    {
+        ActorModifyRequest* rq = new ActorModifyRequest; // actor exploded, schedule reset
+        rq->amr_actor = this;
+        rq->amr_type = ActorModifyRequest::Type::RESET_ON_SPOT;
+        App::GetGameContext()->PushMessage(Message(MSG_SIM_MODIFY_ACTOR_REQUESTED, (void*)rq));
+        m_ongoing_reset = true;
+    }
+}
+
+/// @param turbulence Pre-drawn drag turbulence per node, or nullptr to draw it here.
+/// Only touches nodes in [start, end) - shared results go to `out`, see ApplyNodeChunk().
+void Actor::CalcNodesRange(int start, int end, NodeChunk& out, const Vector3* turbulence)
 {
     const auto water = App::GetSimTerrain()->getWater();
     const float gravity = App::GetSimTerrain()->getGravity();
-    m_water_contact = false;
+    Collisions* collisions = App::GetSimTerrain()->GetCollisions();
 
-    for (int i = 0; i < ar_num_nodes; i++)
+    // Ground contact only depends on the node itself, so it's resolved up front for a block of nodes at once
+    bool ground_contact[Collisions::GROUND_BATCH_SIZE];
+    int block_start = start;
+    int block_end = start;
+
+    for (int i = start; i < end; i++)
     {
+        if (i == block_end)
+        {
+            block_start = i;
+            block_end = std::min(i + Collisions::GROUND_BATCH_SIZE, end);
+            collisions->groundCollisionBatch(&ar_nodes[block_start], block_end - block_start, PHYSICS_DT, ground_contact);
+        }
+
         // COLLISION
         if (!ar_nodes[i].nd_no_ground_contact)
         {
             Vector3 oripos = ar_nodes[i].AbsPosition;
-            bool contacted = App::GetSimTerrain()->GetCollisions()->groundCollision(&ar_nodes[i], PHYSICS_DT);
-            contacted = contacted | App::GetSimTerrain()->GetCollisions()->nodeCollision(&ar_nodes[i], PHYSICS_DT, false);
+            bool contacted = ground_contact[i - block_start];
+            contacted = contacted | collisions->nodeCollision(&ar_nodes[i], PHYSICS_DT, false);
             ar_nodes[i].nd_has_ground_contact = contacted;
             if (ar_nodes[i].nd_has_ground_contact || ar_nodes[i].nd_has_mesh_contact)
             {
-                ar_last_fuzzy_ground_model = ar_nodes[i].nd_last_collision_gm;
+                out.fuzzy_ground_model = ar_nodes[i].nd_last_collision_gm;
                 // Reverts: commit/d11a88142f737528638bd357c38d717c85cebba6#diff-4003254e55aec2c60d21228f375f2a2dL1153
                 // Fixes: Gavril Omega Six sliding on ground on the simple2 spawn
                 // ar_nodes[i].AbsPosition - oripos is always zero ... dark floating point magic
@@ -1561,13 +1615,9 @@ void Actor::CalcNodes()
         Real approx_speed = approx_sqrt(ar_nodes[i].Velocity.squaredLength());
 
         // anti-explsion guard (mach 20)
-        if (approx_speed > 6860 && !m_ongoing_reset)
+        if (approx_speed > 6860)
         {
-            ActorModifyRequest* rq = new ActorModifyRequest; // actor exploded, schedule reset
-            rq->amr_actor = this;
-            rq->amr_type = ActorModifyRequest::Type::RESET_ON_SPOT;
-            App::GetGameContext()->PushMessage(Message(MSG_SIM_MODIFY_ACTOR_REQUESTED, (void*)rq));
-            m_ongoing_reset = true;
+            out.exploded = true;
         }
 
         if (m_fusealge_airfoil)
@@ -1582,7 +1632,7 @@ void Actor::CalcNodes()
             Vector3 drag = -defdragxspeed * ar_nodes[i].Velocity;
             // plus: turbulences
             Real maxtur = defdragxspeed * approx_speed * 0.005f;
-            drag += maxtur * Vector3(frand_11(), frand_11(), frand_11());
+            drag += maxtur * ((turbulence != nullptr) ? turbulence[i] : Vector3(frand_11(), frand_11(), frand_11()));
             ar_nodes[i].Forces += drag;
         }
 
@@ -1591,7 +1641,7 @@ void Actor::CalcNodes()
             const bool is_under_water = water->IsUnderWater(ar_nodes[i].AbsPosition);
             if (is_under_water)
             {
-                m_water_contact = true;
+                out.water_contact = true;
                 if (ar_num_buoycabs == 0)
                 {
                     // water drag (turbulent)
@@ -1608,8 +1658,6 @@ void Actor::CalcNodes()
             ar_nodes[i].nd_under_water = is_under_water;
         }
     }
-
-    this->UpdateBoundingBoxes();
 }
 
 void Actor::CalcHooks()
@@ -0,0 +1,178 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2005-2012 Pierre-Michel Ricordel
+    Copyright 2007-2012 Thomas Fischer
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Intra-actor parallelism for `Actor::CalcNodes()` and `Actor::CalcBeams()` (cvar 'sim_parallel_forces').
+///
+/// `ActorManager::UpdatePhysicsSimulation()` only parallelizes across actors, so a single huge
+/// actor would keep one core busy. Here the plain beams are cut into fixed-size slices, each
+/// slice accumulates forces into a private buffer and the buffers are summed per node in slice order.
+/// Slice boundaries don't depend on the number of worker threads, so results are reproducible
+/// on any machine. Anything touching shared state (deformation, breaking, detacher groups,
+/// explosion reset, random turbulence) stays serial.
+
+#include "Actor.h"
+#include "ApproxMath.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+using namespace Ogre;
+using namespace RoR;
+
+namespace {
+
+const int BEAM_CHUNK_SIZE = 4096; //!< Plain beams per task
+const int NODE_CHUNK_SIZE = 1024; //!< Nodes per task (CalcNodes() and the force reduction)
+
+} // namespace
+
+void Actor::SetupParallelChunks()
+{
+    m_beam_chunks.clear();
+    const int num_plain = static_cast<int>(m_plain_beams.size());
+    for (int begin = 0; begin < num_plain; begin += BEAM_CHUNK_SIZE)
+    {
+        BeamChunk chunk;
+        chunk.begin = begin;
+        chunk.end = std::min(begin + BEAM_CHUNK_SIZE, num_plain);
+        chunk.node_lo = ar_num_nodes - 1;
+        chunk.node_hi = 0;
+        for (int pos = chunk.begin; pos < chunk.end; ++pos)
+        {
+            const beam_t& beam = ar_beams[m_plain_beams[pos]];
+            const int n1 = static_cast<int>(beam.p1 - ar_nodes);
+            const int n2 = static_cast<int>(beam.p2 - ar_nodes);
+            chunk.node_lo = std::min(chunk.node_lo, std::min(n1, n2));
+            chunk.node_hi = std::max(chunk.node_hi, std::max(n1, n2));
+        }
+        chunk.node_lo = std::max(chunk.node_lo, 0);
+        chunk.node_hi = std::min(chunk.node_hi, ar_num_nodes - 1);
+        chunk.forces.resize(std::max(chunk.node_hi - chunk.node_lo + 1, 0));
+        m_beam_chunks.push_back(chunk);
+    }
+
+    m_node_chunks.resize((ar_num_nodes + NODE_CHUNK_SIZE - 1) / NODE_CHUNK_SIZE);
+    m_node_turbulence.resize(ar_num_nodes);
+}
+
+bool Actor::CanParallelizeForces() const
+{
+    return App::sim_parallel_forces->GetBool()
+        && m_beam_chunks.size() > 1
+        && App::GetThreadPool()->GetNumWorkers() > 1;
+}
+
+void Actor::CalcBeamsParallel()
+{
+    // Slices of plain beams -> private force buffers
+    App::GetThreadPool()->ParallelFor(0, static_cast<int>(m_beam_chunks.size()), 1, [this](int begin, int end)
+        {
+            for (int c = begin; c < end; ++c)
+            {
+                this->CalcBeamsPlainChunk(m_beam_chunks[c]);
+            }
+        });
+
+    // Deferred beams (overstressed or outside of their slice's node range), in beam order.
+    // Runs before the reduction: when a break disables a detacher group, the forces its later
+    // beams already put in the buffers are taken out again, like the serial loop would skip them.
+    for (BeamChunk& chunk: m_beam_chunks)
+    {
+        for (const DeferredBeam& def: chunk.deferred)
+        {
+            beam_t& beam = ar_beams[def.beam];
+            if (beam.bm_disabled) // Broken by a detacher group
+                continue;
+
+            Real slen = def.slen;
+            if (std::abs(slen) > beam.minmaxposnegstress)
+            {
+                this->CalcBeamDeformAndBreak(def.beam, beam.k, def.diff, slen);
+                if (beam.bm_disabled && beam.detacher_group > 0)
+                {
+                    this->RevokeDetachedForces(def.beam);
+                }
+            }
+
+            const Vector3 f = def.dis * (slen * def.inv);
+            beam.p1->Forces += f;
+            beam.p2->Forces -= f;
+        }
+    }
+
+    // Reduce buffers into nodes; each task owns a node range, slices are always summed in the same order
+    App::GetThreadPool()->ParallelFor(0, ar_num_nodes, NODE_CHUNK_SIZE, [this](int start, int end)
+        {
+            for (const BeamChunk& chunk: m_beam_chunks)
+            {
+                const int lo = std::max(start, chunk.node_lo);
+                const int hi = std::min(end, chunk.node_hi + 1);
+                for (int n = lo; n < hi; ++n)
+                {
+                    ar_nodes[n].Forces += chunk.forces[n - chunk.node_lo];
+                }
+            }
+        });
+}
+
+void Actor::RevokeDetachedForces(int broken_beam)
+{
+    // `m_plain_beams` is in beam order, so only beams after the broken one were added too early
+    const int group = ar_beams[broken_beam].detacher_group;
+    for (BeamChunk& chunk: m_beam_chunks)
+    {
+        for (const DetachableBeam& det: chunk.detachable)
+        {
+            if (det.beam > broken_beam && std::abs(ar_beams[det.beam].detacher_group) == group)
+            {
+                chunk.forces[det.n1] -= det.force;
+                chunk.forces[det.n2] += det.force;
+            }
+        }
+    }
+}
+
+void Actor::CalcNodesParallel()
+{
+    // The RNG is not thread-safe; draw the same sequence the serial loop would
+    const bool turbulent_drag = !m_fusealge_airfoil && !ar_disable_aerodyn_turbulent_drag;
+    if (turbulent_drag)
+    {
+        for (int i = 0; i < ar_num_nodes; i++)
+        {
+            m_node_turbulence[i] = Vector3(frand_11(), frand_11(), frand_11());
+        }
+    }
+
+    // Ranges match `m_node_chunks` (the grain is NODE_CHUNK_SIZE)
+    App::GetThreadPool()->ParallelFor(0, ar_num_nodes, NODE_CHUNK_SIZE, [this](int start, int end)
+        {
+            NodeChunk& chunk = m_node_chunks[start / NODE_CHUNK_SIZE];
+            chunk = NodeChunk();
+            this->CalcNodesRange(start, end, chunk, m_node_turbulence.data());
+        });
+
+    for (NodeChunk const& chunk: m_node_chunks)
+    {
+        this->ApplyNodeChunk(chunk);
+    }
+}
@@ -0,0 +1,371 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2005-2012 Pierre-Michel Ricordel
+    Copyright 2007-2012 Thomas Fischer
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Vectorized force kernel for plain beams (`bounded == NOSHOCK`), see `Actor::CalcBeams()`.
+///
+/// Beams are processed in blocks: node data is gathered into SoA scratch arrays,
+/// the length/stress math runs 8 (AVX2) or 4 (SSE2) beams at a time, then forces are
+/// scattered back in beam order. Beams exceeding `minmaxposnegstress` take the scalar
+/// `Actor::CalcBeamDeformAndBreak()` path, exactly like the special beams do.
+/// The math follows the scalar code operation by operation (including `fast_invSqrt()`),
+/// but release builds use -ffast-math / `/fp:fast`, which lets the compiler reassociate
+/// the scalar path. Results therefore agree within a small tolerance, not bit for bit;
+/// `VerifyBeamMath()` checks this once at startup and falls back to scalar math otherwise.
+/// `Actor::CalcBeamsPlainChunk()` is the same kernel writing to a private force buffer,
+/// used by the intra-actor parallel path (see ActorForcesParallel.cpp).
+
+#include "Actor.h"
+#include "ApproxMath.h"
+#include "PlatformUtils.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#   define ROR_BEAMS_X86
+#   include <immintrin.h>
+#endif
+
+#if defined(ROR_BEAMS_X86) && (defined(__GNUC__) || defined(__clang__))
+#   define ROR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#   define ROR_TARGET_AVX2 // MSVC emits AVX2 intrinsics without extra flags
+#endif
+
+using namespace Ogre;
+using namespace RoR;
+
+namespace {
+
+const int BEAM_BLOCK_SIZE = 128; //!< Beams per gather/scatter block; multiple of the widest vector (8)
+const int BEAM_LANE_PAD   = 8;
+
+/// Scratch space for one block of gathered beams
+struct BeamBlock
+{
+    // Inputs
+    alignas(32) float dx[BEAM_BLOCK_SIZE];  //!< p1 - p2 (RelPosition)
+    alignas(32) float dy[BEAM_BLOCK_SIZE];
+    alignas(32) float dz[BEAM_BLOCK_SIZE];
+    alignas(32) float vx[BEAM_BLOCK_SIZE];  //!< p1 - p2 (Velocity)
+    alignas(32) float vy[BEAM_BLOCK_SIZE];
+    alignas(32) float vz[BEAM_BLOCK_SIZE];
+    alignas(32) float L[BEAM_BLOCK_SIZE];
+    alignas(32) float k[BEAM_BLOCK_SIZE];
+    alignas(32) float d[BEAM_BLOCK_SIZE];
+    // Outputs
+    alignas(32) float inv[BEAM_BLOCK_SIZE]; //!< Inverted beam length
+    alignas(32) float diff[BEAM_BLOCK_SIZE];//!< Deviation from `L`
+    alignas(32) float slen[BEAM_BLOCK_SIZE];//!< Stress
+    int               beam[BEAM_BLOCK_SIZE];//!< Index to Actor::ar_beams
+};
+
+typedef void (*BeamMathFn)(BeamBlock& b, int count);
+
+void BeamMathScalar(BeamBlock& b, int count)
+{
+    for (int j = 0; j < count; ++j)
+    {
+        const float sq   = b.dx[j] * b.dx[j] + b.dy[j] * b.dy[j] + b.dz[j] * b.dz[j];
+        const float inv  = fast_invSqrt(sq);
+        const float diff = sq * inv - b.L[j];
+        const float v    = (b.vx[j] * b.dx[j] + b.vy[j] * b.dy[j] + b.vz[j] * b.dz[j]) * inv;
+        b.inv[j]  = inv;
+        b.diff[j] = diff;
+        b.slen[j] = -b.k[j] * diff - b.d[j] * v;
+    }
+}
+
+#ifdef ROR_BEAMS_X86
+
+void BeamMathSSE2(BeamBlock& b, int count)
+{
+    const __m128  half         = _mm_set1_ps(0.5f);
+    const __m128  three_halves = _mm_set1_ps(1.5f);
+    const __m128  sign_bit     = _mm_set1_ps(-0.0f);
+    const __m128i magic        = _mm_set1_epi32(0x5f3759df);
+
+    for (int j = 0; j < count; j += 4)
+    {
+        const __m128 dx = _mm_load_ps(b.dx + j);
+        const __m128 dy = _mm_load_ps(b.dy + j);
+        const __m128 dz = _mm_load_ps(b.dz + j);
+        const __m128 sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+        // fast_invSqrt(): magic-constant estimate + one Newton-Raphson step
+        __m128 inv = _mm_castsi128_ps(_mm_sub_epi32(magic, _mm_srai_epi32(_mm_castps_si128(sq), 1)));
+        inv = _mm_mul_ps(inv, _mm_sub_ps(three_halves, _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(half, sq), inv), inv)));
+
+        const __m128 diff = _mm_sub_ps(_mm_mul_ps(sq, inv), _mm_load_ps(b.L + j));
+        const __m128 dot  = _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(_mm_load_ps(b.vx + j), dx),
+            _mm_mul_ps(_mm_load_ps(b.vy + j), dy)),
+            _mm_mul_ps(_mm_load_ps(b.vz + j), dz));
+        const __m128 v    = _mm_mul_ps(dot, inv);
+        const __m128 neg_k = _mm_xor_ps(_mm_load_ps(b.k + j), sign_bit);
+
+        _mm_store_ps(b.inv + j, inv);
+        _mm_store_ps(b.diff + j, diff);
+        _mm_store_ps(b.slen + j, _mm_sub_ps(_mm_mul_ps(neg_k, diff), _mm_mul_ps(_mm_load_ps(b.d + j), v)));
+    }
+}
+
+ROR_TARGET_AVX2 void BeamMathAVX2(BeamBlock& b, int count)
+{
+    const __m256  half         = _mm256_set1_ps(0.5f);
+    const __m256  three_halves = _mm256_set1_ps(1.5f);
+    const __m256  sign_bit     = _mm256_set1_ps(-0.0f);
+    const __m256i magic        = _mm256_set1_epi32(0x5f3759df);
+
+    // NOTE: No FMA on purpose - separate mul/add keeps the rounding close to the scalar code.
+    for (int j = 0; j < count; j += 8)
+    {
+        const __m256 dx = _mm256_load_ps(b.dx + j);
+        const __m256 dy = _mm256_load_ps(b.dy + j);
+        const __m256 dz = _mm256_load_ps(b.dz + j);
+        const __m256 sq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+
+        __m256 inv = _mm256_castsi256_ps(_mm256_sub_epi32(magic, _mm256_srai_epi32(_mm256_castps_si256(sq), 1)));
+        inv = _mm256_mul_ps(inv, _mm256_sub_ps(three_halves, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(half, sq), inv), inv)));
+
+        const __m256 diff = _mm256_sub_ps(_mm256_mul_ps(sq, inv), _mm256_load_ps(b.L + j));
+        const __m256 dot  = _mm256_add_ps(_mm256_add_ps(
+            _mm256_mul_ps(_mm256_load_ps(b.vx + j), dx),
+            _mm256_mul_ps(_mm256_load_ps(b.vy + j), dy)),
+            _mm256_mul_ps(_mm256_load_ps(b.vz + j), dz));
+        const __m256 v    = _mm256_mul_ps(dot, inv);
+        const __m256 neg_k = _mm256_xor_ps(_mm256_load_ps(b.k + j), sign_bit);
+
+        _mm256_store_ps(b.inv + j, inv);
+        _mm256_store_ps(b.diff + j, diff);
+        _mm256_store_ps(b.slen + j, _mm256_sub_ps(_mm256_mul_ps(neg_k, diff), _mm256_mul_ps(_mm256_load_ps(b.d + j), v)));
+    }
+}
+
+#endif // ROR_BEAMS_X86
+
+#ifdef ROR_BEAMS_X86
+
+/// Compares `fn` with `BeamMathScalar()` on a fixed set of beams (stiff/soft, stretched/compressed).
+bool VerifyBeamMath(BeamMathFn fn)
+{
+    BeamBlock ref, test;
+    for (int j = 0; j < BEAM_BLOCK_SIZE; ++j)
+    {
+        const float t = static_cast<float>(j);
+        ref.dx[j] = 0.05f + 0.031f * t;
+        ref.dy[j] = (j % 3 == 0) ? -0.4f + 0.007f * t : 0.2f;
+        ref.dz[j] = (j % 2 == 0) ? 0.0f : -0.015f * t;
+        ref.vx[j] = (j % 5) * 0.8f - 1.6f;
+        ref.vy[j] = 0.3f - 0.01f * t;
+        ref.vz[j] = (j % 7) * -0.25f;
+        ref.L[j]  = std::sqrt(ref.dx[j] * ref.dx[j] + ref.dy[j] * ref.dy[j] + ref.dz[j] * ref.dz[j]) * (0.9f + (j % 4) * 0.05f);
+        ref.k[j]  = (j % 2 == 0) ? 9000000.f : 400000.f;
+        ref.d[j]  = (j % 2 == 0) ? 12000.f : 500.f;
+    }
+    test = ref;
+    BeamMathScalar(ref, BEAM_BLOCK_SIZE);
+    fn(test, BEAM_BLOCK_SIZE);
+
+    for (int j = 0; j < BEAM_BLOCK_SIZE; ++j)
+    {
+        // Relative to the magnitude of the terms, since `-k * diff - d * v` may cancel
+        const float v_ref = std::abs(ref.slen[j] + ref.k[j] * ref.diff[j]);
+        const float scale = ref.k[j] * (std::abs(ref.diff[j]) + 1e-3f) + v_ref;
+        if (std::abs(test.inv[j]  - ref.inv[j])  > 1e-5f * ref.inv[j] ||
+            std::abs(test.diff[j] - ref.diff[j]) > 1e-5f * ref.L[j] ||
+            std::abs(test.slen[j] - ref.slen[j]) > 1e-4f * scale)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // ROR_BEAMS_X86
+
+BeamMathFn SelectBeamMath()
+{
+#ifdef ROR_BEAMS_X86
+    if (CpuSupportsAVX2() && VerifyBeamMath(BeamMathAVX2))
+    {
+        RoR::Log("[RoR|Physics] Beam kernel: AVX2");
+        return BeamMathAVX2;
+    }
+    if (VerifyBeamMath(BeamMathSSE2))
+    {
+        RoR::Log("[RoR|Physics] Beam kernel: SSE2");
+        return BeamMathSSE2;
+    }
+    RoR::Log("[RoR|Physics] Beam kernel: scalar (vector kernels failed verification)");
+    return BeamMathScalar;
+#else
+    RoR::Log("[RoR|Physics] Beam kernel: scalar");
+    return BeamMathScalar;
+#endif
+}
+
+/// Gathers active beams from `indices[pos..end)` into the block, pads it to full vectors
+/// and runs the math. Advances `pos`, returns the number of gathered beams.
+int GatherAndCompute(BeamBlock& block, const beam_t* beams, const int* indices, int& pos, int end)
+{
+    static const BeamMathFn beam_math = SelectBeamMath();
+
+    int count = 0;
+    for (; pos < end && count < BEAM_BLOCK_SIZE; ++pos)
+    {
+        const int i = indices[pos];
+        const beam_t& beam = beams[i];
+        if (beam.bm_disabled || beam.bm_inter_actor)
+            continue;
+
+        const node_t& n1 = *beam.p1;
+        const node_t& n2 = *beam.p2;
+        block.dx[count]   = n1.RelPosition.x - n2.RelPosition.x;
+        block.dy[count]   = n1.RelPosition.y - n2.RelPosition.y;
+        block.dz[count]   = n1.RelPosition.z - n2.RelPosition.z;
+        block.vx[count]   = n1.Velocity.x - n2.Velocity.x;
+        block.vy[count]   = n1.Velocity.y - n2.Velocity.y;
+        block.vz[count]   = n1.Velocity.z - n2.Velocity.z;
+        block.L[count]    = beam.L;
+        block.k[count]    = beam.k;
+        block.d[count]    = beam.d;
+        block.beam[count] = i;
+        ++count;
+    }
+
+    // Pad to full vectors with harmless unit-length beams
+    const int padded = (count + BEAM_LANE_PAD - 1) / BEAM_LANE_PAD * BEAM_LANE_PAD;
+    for (int j = count; j < padded; ++j)
+    {
+        block.dx[j] = 1.f; block.dy[j] = 0.f; block.dz[j] = 0.f;
+        block.vx[j] = 0.f; block.vy[j] = 0.f; block.vz[j] = 0.f;
+        block.L[j]  = 1.f; block.k[j]  = 0.f; block.d[j]  = 0.f;
+    }
+
+    beam_math(block, padded);
+    return count;
+}
+
+} // namespace
+
+void Actor::PartitionBeams()
+{
+    m_plain_beams.clear();
+    m_special_beams.clear();
+    for (int i = 0; i < ar_num_beams; i++)
+    {
+        if (ar_beams[i].bounded == NOSHOCK)
+            m_plain_beams.push_back(i);
+        else
+            m_special_beams.push_back(i);
+    }
+}
+
+void Actor::CalcBeamsPlain()
+{
+    BeamBlock block;
+    const int num_plain = static_cast<int>(m_plain_beams.size());
+    int pos = 0;
+    while (pos < num_plain)
+    {
+        const int count = GatherAndCompute(block, ar_beams, m_plain_beams.data(), pos, num_plain);
+
+        // Scatter
+        for (int j = 0; j < count; ++j)
+        {
+            const int i = block.beam[j];
+            if (ar_beams[i].bm_disabled) // Broken by a detacher group earlier in this block
+                continue;
+
+            Real slen = block.slen[j];
+            ar_beams[i].stress = slen;
+
+            // Fast test for deformation
+            if (std::abs(slen) > ar_beams[i].minmaxposnegstress)
+            {
+                this->CalcBeamDeformAndBreak(i, ar_beams[i].k, block.diff[j], slen);
+            }
+
+            // At last update the beam forces
+            const Real scale = slen * block.inv[j];
+            const Vector3 f(block.dx[j] * scale, block.dy[j] * scale, block.dz[j] * scale);
+            ar_beams[i].p1->Forces += f;
+            ar_beams[i].p2->Forces -= f;
+        }
+    }
+}
+
+void Actor::CalcBeamsPlainChunk(BeamChunk& chunk)
+{
+    // Runs on a worker thread: only writes `beam_t::stress` and the chunk's own buffers.
+    std::fill(chunk.forces.begin(), chunk.forces.end(), Vector3::ZERO);
+    chunk.deferred.clear();
+    chunk.detachable.clear();
+
+    BeamBlock block;
+    int pos = chunk.begin;
+    while (pos < chunk.end)
+    {
+        const int count = GatherAndCompute(block, ar_beams, m_plain_beams.data(), pos, chunk.end);
+
+        for (int j = 0; j < count; ++j)
+        {
+            const int i = block.beam[j];
+            const Real slen = block.slen[j];
+            ar_beams[i].stress = slen;
+
+            // Hook beams may be re-attached outside of the slice's node range
+            const int n1 = static_cast<int>(ar_beams[i].p1 - ar_nodes) - chunk.node_lo;
+            const int n2 = static_cast<int>(ar_beams[i].p2 - ar_nodes) - chunk.node_lo;
+            const int span = static_cast<int>(chunk.forces.size());
+
+            if (std::abs(slen) > ar_beams[i].minmaxposnegstress || n1 < 0 || n1 >= span || n2 < 0 || n2 >= span)
+            {
+                // Deformation/breaking touches shared state - finished serially, see `Actor::CalcBeamsParallel()`
+                DeferredBeam def;
+                def.beam = i;
+                def.diff = block.diff[j];
+                def.slen = slen;
+                def.inv  = block.inv[j];
+                def.dis  = Vector3(block.dx[j], block.dy[j], block.dz[j]);
+                chunk.deferred.push_back(def);
+                continue;
+            }
+
+            const Real scale = slen * block.inv[j];
+            const Vector3 f(block.dx[j] * scale, block.dy[j] * scale, block.dz[j] * scale);
+            chunk.forces[n1] += f;
+            chunk.forces[n2] -= f;
+
+            if (ar_beams[i].detacher_group != 0)
+            {
+                DetachableBeam det;
+                det.beam  = i;
+                det.n1    = n1;
+                det.n2    = n2;
+                det.force = f;
+                chunk.detachable.push_back(det);
+            }
+        }
+    }
+}
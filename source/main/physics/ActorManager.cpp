@@ -43,6 +43,7 @@
 #include "Language.h"
 #include "MovableText.h"
 #include "Network.h"
+#include "NodeStreamCodec.h"
 #include "PointColDetector.h"
 #include "Replay.h"
 #include "RigDef_Validator.h"
@@ -54,6 +55,8 @@
 #include "Utils.h"
 #include "VehicleAI.h"
 
+#include <chrono>
+
 using namespace Ogre;
 using namespace RoR;
 
@@ -67,11 +70,14 @@ ActorManager::ActorManager()
 {
     // Create worker thread (used for physics calculations)
     m_sim_thread_pool = std::unique_ptr<ThreadPool>(new ThreadPool(1));
+    m_save_thread_pool = std::unique_ptr<ThreadPool>(new ThreadPool(1));
+    this->SetupSimGraph();
 }
 
 ActorManager::~ActorManager()
 {
     this->SyncWithSimThread(); // Wait for sim task to finish
+    this->WaitForSceneSave();
 }
 
 void ActorManager::SetupActor(Actor* actor, ActorSpawnRequest rq, std::shared_ptr<RigDef::File> def)
@@ -192,6 +198,8 @@ void ActorManager::SetupActor(Actor* actor, ActorSpawnRequest rq, std::shared_pt
 
     //compute node connectivity graph
     actor->calcNodeConnectivityGraph();
+    actor->PartitionBeams();
+    actor->SetupParallelChunks();
 
     actor->UpdateBoundingBoxes();
     actor->calculateAveragePosition();
@@ -258,22 +266,26 @@ void ActorManager::SetupActor(Actor* actor, ActorSpawnRequest rq, std::shared_pt
     actor->updateVisual();
     actor->ToggleLights();
     actor->GetGfxActor()->SetDebugView((GfxActor::DebugViewType)rq.asr_debugview);
+    actor->GetGfxActor()->WriteSimNodeSnapshot(); // Initial fill of sim data buffers, with the final spawn position
 
     // perform full visual update only if the vehicle won't be immediately driven by player.
     if (actor->isPreloadedWithTerrain() ||                         // .tobj file - Spawned sleeping somewhere on terrain
         rq.asr_origin == ActorSpawnRequest::Origin::CONFIG_FILE || // RoR.cfg or commandline - not entered by default
         actor->ar_num_cinecams == 0)                               // Not intended for player-controlling
     {
-        actor->GetGfxActor()->UpdateSimDataBuffer(); // Initial fill of sim data buffers
+        actor->GetGfxActor()->UpdateSimDataBuffer();
 
-        actor->GetGfxActor()->UpdateFlexbodies(); // Push tasks to threadpool
+        std::vector<FlexBodyChunk> flexbody_chunks;
+        FlexBodyStats flexbody_stats;
+        actor->GetGfxActor()->UpdateFlexbodies(flexbody_chunks, flexbody_stats);
         actor->GetGfxActor()->UpdateWheelVisuals(); // Push tasks to threadpool
+        GfxActor::ComputeFlexbodyChunks(flexbody_chunks);
         actor->GetGfxActor()->UpdateCabMesh();
         actor->GetGfxActor()->UpdateWingMeshes();
         actor->GetGfxActor()->UpdateProps(0.f, false);
         actor->GetGfxActor()->UpdateRods(); // beam visuals
         actor->GetGfxActor()->FinishWheelUpdates(); // Sync tasks from threadpool
-        actor->GetGfxActor()->FinishFlexbodyTasks(); // Sync tasks from threadpool
+        actor->GetGfxActor()->FinishFlexbodyUpdates();
     }
 
     App::GetGfxScene()->RegisterGfxActor(actor->GetGfxActor());
@@ -329,9 +341,9 @@ void ActorManager::SetupActor(Actor* actor, ActorSpawnRequest rq, std::shared_pt
         actor->m_net_label_node->setVisible(true);
         actor->m_deletion_scene_nodes.emplace_back(actor->m_net_label_node);
     }
-    else if (App::sim_replay_enabled->GetBool())
+    else if (App::sim_replay_enabled->GetBool() && !m_replay)
     {
-        actor->m_replay_handler = new Replay(actor, App::sim_replay_length->GetInt());
+        m_replay = std::unique_ptr<Replay>(new Replay());
     }
 
     LOG(" ===== DONE LOADING VEHICLE");
@@ -371,8 +383,12 @@ void ActorManager::RemoveStreamSource(int sourceid)
 }
 
 #ifdef USE_SOCKETW
-void ActorManager::HandleActorStreamData(std::vector<RoR::NetRecvPacket> packet_buffer)
+void ActorManager::HandleActorStreamData(std::vector<RoR::NetRecvPacket> const& packets)
 {
+    // The packets are views into the network receive queue, reordering them is cheap
+    std::vector<RoR::NetRecvPacket>& packet_buffer = m_net_packets;
+    packet_buffer.assign(packets.begin(), packets.end());
+
     // Sort by stream source
     std::stable_sort(packet_buffer.begin(), packet_buffer.end(),
             [](const RoR::NetRecvPacket& a, const RoR::NetRecvPacket& b)
@@ -387,7 +403,11 @@ void ActorManager::HandleActorStreamData(std::vector<RoR::NetRecvPacket> packet_
     {
         if (packet.header.command == RoRnet::MSG2_STREAM_REGISTER)
         {
-            RoRnet::StreamRegister* reg = (RoRnet::StreamRegister *)packet.buffer;
+            // Copy - the received packet is shared with other consumers and we reply with a modified one
+            union { RoRnet::StreamRegister reg; RoRnet::ActorStreamRegister actor_reg; } reg_copy;
+            memset(&reg_copy, 0, sizeof(reg_copy));
+            memcpy(&reg_copy, packet.buffer, std::min(sizeof(reg_copy), size_t(packet.header.size)));
+            RoRnet::StreamRegister* reg = &reg_copy.reg;
             if (reg->type == 0)
             {
                 reg->name[127] = 0;
@@ -425,11 +445,6 @@ void ActorManager::HandleActorStreamData(std::vector<RoR::NetRecvPacket> packet_
                     else
                     {
                         auto actor_reg = reinterpret_cast<RoRnet::ActorStreamRegister*>(reg);
-                        if (m_stream_time_offsets.find(reg->origin_sourceid) == m_stream_time_offsets.end())
-                        {
-                            int offset = actor_reg->time - m_net_timer.getMilliseconds();
-                            m_stream_time_offsets[reg->origin_sourceid] = offset - 100;
-                        }
                         ActorSpawnRequest* rq = new ActorSpawnRequest;
                         rq->asr_origin = ActorSpawnRequest::Origin::NETWORK;
                         // TODO: Look up cache entry early (eliminate asr_filename) and fetch skin by name+guid! ~ 03/2019
@@ -451,6 +466,10 @@ void ActorManager::HandleActorStreamData(std::vector<RoR::NetRecvPacket> packet_
                             MSG_SIM_SPAWN_ACTOR_REQUESTED, (void*)rq));
 
                         reg->status = 1;
+                        if (actor_reg->bufferSize == NODE_STREAM_OFFER_DELTA_V1)
+                        {
+                            actor_reg->bufferSize = NODE_STREAM_ACCEPT_DELTA_V1; // Fits in the StreamRegister reply
+                        }
                     }
                 }
 
@@ -459,13 +478,19 @@ void ActorManager::HandleActorStreamData(std::vector<RoR::NetRecvPacket> packet_
         }
         else if (packet.header.command == RoRnet::MSG2_STREAM_REGISTER_RESULT)
         {
-            RoRnet::StreamRegister* reg = (RoRnet::StreamRegister *)packet.buffer;
+            const RoRnet::StreamRegister* reg = (const RoRnet::StreamRegister *)packet.buffer;
             for (auto actor : m_actors)
             {
                 if (actor->ar_net_source_id == reg->origin_sourceid && actor->ar_net_stream_id == reg->origin_streamid)
                 {
                     int sourceid = packet.header.source;
                     actor->ar_net_stream_results[sourceid] = reg->status;
+                    int32_t format = NODE_STREAM_LEGACY;
+                    if (packet.header.size >= offsetof(RoRnet::ActorStreamRegister, bufferSize) + sizeof(int32_t))
+                    {
+                        memcpy(&format, packet.buffer + offsetof(RoRnet::ActorStreamRegister, bufferSize), sizeof(int32_t));
+                    }
+                    actor->ar_net_stream_formats[sourceid] = format;
 
                     String message = "";
                     switch (reg->status)
@@ -510,24 +535,6 @@ void ActorManager::HandleActorStreamData(std::vector<RoR::NetRecvPacket> packet_
 }
 #endif // USE_SOCKETW
 
-int ActorManager::GetNetTimeOffset(int sourceid)
-{
-    auto search = m_stream_time_offsets.find(sourceid);
-    if (search != m_stream_time_offsets.end())
-    {
-        return search->second;
-    }
-    return 0;
-}
-
-void ActorManager::UpdateNetTimeOffset(int sourceid, int offset)
-{
-    if (m_stream_time_offsets.find(sourceid) != m_stream_time_offsets.end())
-    {
-        m_stream_time_offsets[sourceid] += offset;
-    }
-}
-
 int ActorManager::CheckNetworkStreamsOk(int sourceid)
 {
     if (!m_stream_mismatches[sourceid].empty())
@@ -863,6 +870,7 @@ void ActorManager::CleanUpSimulation() // Called after simulation finishes
         delete actor;
     }
     m_actors.clear();
+    m_replay.reset();
 
     m_total_sim_time = 0.f;
     m_last_simulation_speed = 0.1f;
@@ -884,12 +892,6 @@ void ActorManager::DeleteActorInternal(Actor* actor)
         {
             App::GetNetwork()->AddPacket(actor->ar_net_stream_id, RoRnet::MSG2_STREAM_UNREGISTER, 0, 0);
         }
-        else if (std::count_if(m_actors.begin(), m_actors.end(), [actor](Actor* b)
-                    { return b->ar_net_source_id == actor->ar_net_source_id; }) == 1)
-        {
-            // We're deleting the last actor from this stream source, reset the stream time offset
-            m_stream_time_offsets.erase(actor->ar_net_source_id);
-        }
     }
 #endif // USE_SOCKETW
 
@@ -991,6 +993,10 @@ void ActorManager::UpdateActors(Actor* player_actor)
     m_physics_steps = dt / PHYSICS_DT;
     if (m_physics_steps == 0)
     {
+        // Frame shorter than a physics step: no sim task this frame, but changes made on the main thread should show.
+        // The previous sim task may still be writing nodes and snapshots - wait for it first.
+        this->SyncWithSimThread();
+        this->WriteSimNodeSnapshots();
         return;
     }
 
@@ -1001,6 +1007,24 @@ void ActorManager::UpdateActors(Actor* player_actor)
 
     this->UpdateSleepingState(player_actor, dt);
 
+    if (App::mp_state->GetEnum<MpState>() == RoR::MpState::CONNECTED)
+    {
+        // Node interpolation of remote actors is independent per actor
+        m_net_remote_actors.clear();
+        for (auto actor : m_actors)
+        {
+            if (actor->ar_sim_state == Actor::SimState::NETWORKED_OK)
+                m_net_remote_actors.push_back(actor);
+        }
+        App::GetThreadPool()->ParallelFor(0, static_cast<int>(m_net_remote_actors.size()), 1, [this](int begin, int end)
+            {
+                for (int i = begin; i < end; i++)
+                {
+                    m_net_remote_actors[i]->CalcNetworkNodes();
+                }
+            });
+    }
+
     for (auto actor : m_actors)
     {
         actor->HandleInputEvents(dt);
@@ -1042,11 +1066,14 @@ void ActorManager::UpdateActors(Actor* player_actor)
         {
             if (actor->ar_sim_state == Actor::SimState::NETWORKED_OK)
                 actor->CalcNetwork();
-            else
-                actor->sendStreamData();
         }
     }
 
+    if (App::mp_state->GetEnum<MpState>() == RoR::MpState::CONNECTED)
+    {
+        this->UpdateNetSendScheduler(player_actor);
+    }
+
     if (player_actor != nullptr)
     {
         this->ForwardCommands(player_actor);
@@ -1062,11 +1089,11 @@ void ActorManager::UpdateActors(Actor* player_actor)
         }
 
         player_actor->ForceFeedbackStep(m_physics_steps);
+    }
 
-        if (player_actor->ar_sim_state == Actor::SimState::LOCAL_REPLAY)
-        {
-            player_actor->GetReplay()->replayStepActor();
-        }
+    if (m_replay)
+    {
+        m_replay->replayStepActors(m_actors);
     }
 
     auto func = std::function<void()>([this]()
@@ -1078,7 +1105,91 @@ void ActorManager::UpdateActors(Actor* player_actor)
     m_total_sim_time += dt;
 
     if (!App::app_async_physics->GetBool())
-        m_sim_task->join();
+        m_sim_task.join();
+}
+
+// Send rates of local actors, in milliseconds between updates
+static const int   NET_SEND_INTERVAL_FAST     = 50;    //!< Player-driven or fast-moving actors
+static const int   NET_SEND_INTERVAL_DEFAULT  = 100;
+static const int   NET_SEND_INTERVAL_SLOW     = 250;   //!< Parked, or far from all remote players
+static const int   NET_SEND_INTERVAL_SLEEPING = 1000;  //!< Also the longest any update waits for the budget
+static const float NET_SEND_FAST_SPEED        = 10.f;  //!< m/s
+static const float NET_SEND_PARKED_SPEED      = 0.5f;  //!< m/s
+static const float NET_SEND_INTEREST_RADIUS   = 300.f; //!< m
+
+void ActorManager::UpdateNetSendScheduler(Actor* player_actor)
+{
+    // Refill the upload budget; up to 250ms worth of it can be saved up for bursts
+    const unsigned long now = m_net_timer.getMilliseconds();
+    const float budget_rate = App::mp_send_budget->GetInt() * 1024.f / 1000.f; // Bytes per millisecond; 0 = unlimited
+    if (budget_rate > 0.f)
+    {
+        m_net_send_tokens = std::min(m_net_send_tokens + (now - m_net_send_last_time) * budget_rate, 250.f * budget_rate);
+    }
+    m_net_send_last_time = now;
+
+    // Interest management: actors far from everybody else can be sent slower
+    m_net_interest_points.clear();
+    for (Actor* actor : m_actors)
+    {
+        if (actor->ar_sim_state == Actor::SimState::NETWORKED_OK)
+            m_net_interest_points.push_back(actor->getPosition());
+    }
+    App::GetGameContext()->GetCharacterFactory()->GetRemoteCharacterPositions(m_net_interest_points);
+
+    m_net_send_queue.clear();
+    for (Actor* actor : m_actors)
+    {
+        if (actor->ar_sim_state == Actor::SimState::NETWORKED_OK)
+            continue;
+
+        const float speed = actor->getSpeed();
+        int interval = NET_SEND_INTERVAL_DEFAULT;
+        if (actor->ar_sim_state == Actor::SimState::LOCAL_SLEEPING)
+            interval = NET_SEND_INTERVAL_SLEEPING;
+        else if (speed > NET_SEND_FAST_SPEED || (actor == player_actor && speed > NET_SEND_PARKED_SPEED))
+            interval = NET_SEND_INTERVAL_FAST;
+        else if (speed < NET_SEND_PARKED_SPEED && actor != player_actor)
+            interval = NET_SEND_INTERVAL_SLOW;
+
+        if (interval < NET_SEND_INTERVAL_SLEEPING && !m_net_interest_points.empty())
+        {
+            const Ogre::Vector3 pos = actor->getPosition();
+            bool in_range = false;
+            for (Ogre::Vector3 const& point : m_net_interest_points)
+            {
+                in_range = in_range || (point.squaredDistance(pos) < NET_SEND_INTEREST_RADIUS * NET_SEND_INTEREST_RADIUS);
+            }
+            if (!in_range)
+                interval = std::min(std::max(interval * 2, NET_SEND_INTERVAL_SLOW), NET_SEND_INTERVAL_SLEEPING);
+        }
+
+        // Announced to receivers in the update, see `Actor::CalcNetwork()`
+        actor->ar_net_send_interval = interval;
+
+        const unsigned long elapsed = actor->ar_net_timer.getMilliseconds() - actor->ar_net_last_update_time;
+        if (elapsed >= (unsigned long)interval)
+            m_net_send_queue.push_back(std::make_pair((float)elapsed / interval, actor));
+    }
+
+    // Most overdue first, so that nobody starves while over budget
+    std::sort(m_net_send_queue.begin(), m_net_send_queue.end(),
+        [](std::pair<float, Actor*> const& a, std::pair<float, Actor*> const& b) { return a.first > b.first; });
+    for (auto& entry : m_net_send_queue)
+    {
+        Actor* actor = entry.second;
+        const bool must_send = entry.first * actor->ar_net_send_interval >= NET_SEND_INTERVAL_SLEEPING;
+        if (budget_rate > 0.f && m_net_send_tokens <= 0.f && !must_send)
+        {
+            m_net_send_stats.nss_budget_deferrals++;
+            continue;
+        }
+
+        const size_t bytes = actor->sendStreamData();
+        m_net_send_tokens -= bytes;
+        m_net_send_stats.nss_num_packets++;
+        m_net_send_stats.nss_bytes_sent += bytes;
+    }
 }
 
 Actor* ActorManager::GetActorById(int actor_id)
@@ -1093,65 +1204,153 @@ Actor* ActorManager::GetActorById(int actor_id)
     return 0;
 }
 
+void ActorManager::SetupSimGraph()
+{
+    // One physics step: prepare -> per-actor forces -> inter-actor beams + broadphase -> inter-actor collisions
+    const int prepare = m_sim_graph.AddSerialJob("prepare", [this]()
+        {
+            this->PrepareActorsForStep(m_sim_graph.GetCurrentRun());
+        });
+    const int compute = m_sim_graph.AddParallelJob("compute",
+        [this]() { return static_cast<int>(m_actors.size()); },
+        [this](int index) { this->ComputeActorStep(index, m_sim_graph.GetCurrentRun()); },
+        {prepare});
+    const int inter_beams = m_sim_graph.AddSerialJob("inter-actor beams", [this]()
+        {
+            this->CalcInterActorBeams();
+        },
+        {compute});
+    const int broadphase = m_sim_graph.AddSerialJob("inter-actor broadphase", [this]()
+        {
+            this->UpdateInterActorBroadphase();
+        },
+        {compute});
+    m_sim_graph.AddParallelJob("inter-actor collisions",
+        [this]() { return static_cast<int>(m_actors.size()); },
+        [this](int index) { this->CalcInterActorCollisions(index); },
+        {inter_beams, broadphase});
+    m_sim_graph.Finalize();
+}
+
+void ActorManager::PrepareActorsForStep(int step)
+{
+    if (m_replay)
+    {
+        m_replay->onPhysicsStep(m_actors); // Serial point between steps; actors are done moving
+    }
+
+    for (auto actor : m_actors)
+    {
+        actor->ar_update_physics = actor->CalcForcesEulerPrepare(step == 0);
+        actor->m_parallel_forces = actor->ar_update_physics && actor->CanParallelizeForces();
+    }
+}
+
+void ActorManager::ComputeActorStep(int index, int step)
+{
+    if (m_actors[index]->ar_update_physics)
+    {
+        m_actors[index]->CalcForcesEulerCompute(step == 0, m_physics_steps);
+    }
+}
+
+void ActorManager::CalcInterActorBeams()
+{
+    for (auto actor : m_actors)
+    {
+        if (actor->ar_update_physics)
+        {
+            actor->CalcBeamsInterActor();
+        }
+    }
+}
+
+void ActorManager::UpdateInterActorBroadphase()
+{
+    m_inter_actor_broadphase.Update(m_actors);
+}
+
+void ActorManager::CalcInterActorCollisions(int index)
+{
+    Actor* actor = m_actors[index];
+    if (actor->m_inter_point_col_detector != nullptr && (actor->ar_update_physics ||
+            (App::mp_pseudo_collisions->GetBool() && actor->ar_sim_state == Actor::SimState::NETWORKED_OK)))
+    {
+        actor->m_inter_point_col_detector->UpdateInterPoint();
+        if (actor->ar_collision_relevant)
+        {
+            ResolveInterActorCollisions(PHYSICS_DT,
+                *actor->m_inter_point_col_detector,
+                actor->ar_num_collcabs,
+                actor->ar_collcabs,
+                actor->ar_cabs,
+                actor->ar_inter_collcabrate,
+                actor->ar_nodes,
+                actor->ar_collision_range,
+                *actor->ar_submesh_ground_model);
+        }
+    }
+}
+
 void ActorManager::UpdatePhysicsSimulation()
 {
     for (auto actor : m_actors)
     {
         actor->UpdatePhysicsOrigin();
     }
-    for (int i = 0; i < m_physics_steps; i++)
+
+    const auto start_time = std::chrono::high_resolution_clock::now();
+    if (App::sim_step_pipeline->GetBool())
     {
+        // Pool workers join the step graph for all steps of this frame; phases are separated by spin-then-park barriers.
+        const int num_actors = static_cast<int>(m_actors.size());
+        const int num_helpers = std::min(App::GetThreadPool()->GetNumWorkers() - 1, num_actors - 1);
+        std::vector<TaskHandle> helpers;
+        m_sim_graph.BeginExecution();
+        for (int i = 0; i < num_helpers; i++)
         {
-            std::vector<std::function<void()>> tasks;
-            for (auto actor : m_actors)
-            {
-                if (actor->ar_update_physics = actor->CalcForcesEulerPrepare(i == 0))
-                {
-                    auto func = std::function<void()>([this, i, actor]()
-                        {
-                            actor->CalcForcesEulerCompute(i == 0, m_physics_steps);
-                        });
-                    tasks.push_back(func);
-                }
-            }
-            App::GetThreadPool()->Parallelize(tasks);
-            for (auto actor : m_actors)
-            {
-                if (actor->ar_update_physics)
-                {
-                    actor->CalcBeamsInterActor();
-                }
-            }
+            helpers.push_back(App::GetThreadPool()->RunBlockingTask([this]() { m_sim_graph.Help(); })); // Not on waiting threads, see RunBlockingTask()
         }
+        m_sim_graph.Execute(m_physics_steps);
+        for (auto& helper : helpers)
         {
-            std::vector<std::function<void()>> tasks;
-            for (auto actor : m_actors)
-            {
-                if (actor->m_inter_point_col_detector != nullptr && (actor->ar_update_physics ||
-                        (App::mp_pseudo_collisions->GetBool() && actor->ar_sim_state == Actor::SimState::NETWORKED_OK)))
+            helper.join();
+        }
+    }
+    else
+    {
+        // Fork/join for every phase of every step
+        const int num_actors = static_cast<int>(m_actors.size());
+        for (int i = 0; i < m_physics_steps; i++)
+        {
+            this->PrepareActorsForStep(i);
+            App::GetThreadPool()->ParallelFor(0, num_actors, 1, [this, i](int begin, int end)
                 {
-                    auto func = std::function<void()>([this, actor]()
-                        {
-                            actor->m_inter_point_col_detector->UpdateInterPoint();
-                            if (actor->ar_collision_relevant)
-                            {
-                                ResolveInterActorCollisions(PHYSICS_DT,
-                                    *actor->m_inter_point_col_detector,
-                                    actor->ar_num_collcabs,
-                                    actor->ar_collcabs,
-                                    actor->ar_cabs,
-                                    actor->ar_inter_collcabrate,
-                                    actor->ar_nodes,
-                                    actor->ar_collision_range,
-                                    *actor->ar_submesh_ground_model);
-                            }
-                        });
-                    tasks.push_back(func);
-                }
-            }
-            App::GetThreadPool()->Parallelize(tasks);
+                    for (int j = begin; j < end; j++)
+                    {
+                        this->ComputeActorStep(j, i);
+                    }
+                });
+            this->CalcInterActorBeams();
+            this->UpdateInterActorBroadphase();
+            App::GetThreadPool()->ParallelFor(0, num_actors, 1, [this](int begin, int end)
+                {
+                    for (int j = begin; j < end; j++)
+                    {
+                        this->CalcInterActorCollisions(j);
+                    }
+                });
         }
     }
+    if (m_physics_steps > 0)
+    {
+        const float step_time_us = std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - start_time).count() / m_physics_steps;
+        m_step_stats.pss_num_frames++;
+        m_step_stats.pss_num_steps += m_physics_steps;
+        m_step_stats.pss_total_us += step_time_us * m_physics_steps;
+        m_step_stats.pss_max_us = std::max(m_step_stats.pss_max_us, step_time_us);
+    }
+
     for (auto actor : m_actors)
     {
         actor->m_ongoing_reset = false;
@@ -1168,12 +1367,37 @@ void ActorManager::UpdatePhysicsSimulation()
             actor->ar_top_speed = std::max(actor->ar_top_speed, actor->ar_nodes[0].Velocity.length());
         }
     }
+
+    this->WriteSimNodeSnapshots();
+}
+
+void ActorManager::WriteSimNodeSnapshots()
+{
+    // Picked up by GfxScene::BufferSimulationData() next frame
+    for (auto actor : m_actors)
+    {
+        if (actor->GetGfxActor()->IsActorLive())
+        {
+            actor->GetGfxActor()->WriteSimNodeSnapshot();
+        }
+    }
 }
 
 void ActorManager::SyncWithSimThread()
 {
-    if (m_sim_task)
-        m_sim_task->join();
+    m_sim_task.join();
+}
+
+ActorManager::PhysicsStepStats ActorManager::GetPhysicsStepStats()
+{
+    this->SyncWithSimThread();
+    return m_step_stats;
+}
+
+void ActorManager::ResetPhysicsStepStats()
+{
+    this->SyncWithSimThread();
+    m_step_stats = PhysicsStepStats();
 }
 
 void HandleErrorLoadingFile(std::string type, std::string filename, std::string exception_msg)
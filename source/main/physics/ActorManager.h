@@ -26,10 +26,13 @@
 
 #include "Application.h"
 
+#include "ActorBroadphase.h"
+
 #include "SimData.h"
 #include "CmdKeyInertia.h"
 #include "Network.h"
 #include "RigDef_Prerequisites.h"
+#include "JobGraph.h"
 #include "ThreadPool.h"
 
 #include <string>
@@ -51,11 +54,30 @@ public:
     void           UpdateActors(Actor* player_actor);
     void           SyncWithSimThread();
     void           UpdatePhysicsSimulation();
+
+    /// Wall time of physics steps, see console command 'steptime'
+    struct PhysicsStepStats
+    {
+        size_t     pss_num_frames = 0;
+        size_t     pss_num_steps = 0;
+        double     pss_total_us = 0;
+        float      pss_max_us = 0.f;        //!< Worst per-frame average
+    };
+    PhysicsStepStats GetPhysicsStepStats(); //!< Waits for the sim thread
+    void           ResetPhysicsStepStats();
+
+    /// Outgoing actor updates, see console command 'netstats'
+    struct NetSendStats
+    {
+        size_t     nss_num_packets = 0;
+        size_t     nss_bytes_sent = 0;
+        size_t     nss_budget_deferrals = 0; //!< Updates postponed to a later frame by `mp_send_budget`
+    };
+    NetSendStats   GetNetSendStats() const                 { return m_net_send_stats; }
+    void           ResetNetSendStats()                     { m_net_send_stats = NetSendStats(); }
     void           WakeUpAllActors();
     void           SendAllActorsSleeping();
     unsigned long  GetNetTime()                            { return m_net_timer.getMilliseconds(); };
-    int            GetNetTimeOffset(int sourceid);
-    void           UpdateNetTimeOffset(int sourceid, int offset);
     void           AddStreamMismatch(int sourceid, int streamid) { m_stream_mismatches[sourceid].insert(streamid); };
     int            CheckNetworkStreamsOk(int sourceid);
     int            CheckNetRemoteStreamsOk(int sourceid);
@@ -83,7 +105,7 @@ public:
     std::shared_ptr<RigDef::File>   FetchActorDef(std::string filename, bool predefined_on_terrain = false);
 
 #ifdef USE_SOCKETW
-    void           HandleActorStreamData(std::vector<RoR::NetRecvPacket> packet);
+    void           HandleActorStreamData(std::vector<RoR::NetRecvPacket> const& packet);
 #endif
 
 #ifdef USE_ANGELSCRIPT
@@ -94,11 +116,14 @@ public:
     // Savegames (defined in Savegame.cpp)
 
     bool           LoadScene(Ogre::String filename);
-    bool           SaveScene(Ogre::String filename);
-    void           RestoreSavedState(Actor* actor, rapidjson::Value const& j_entry);
+    bool           SaveScene(Ogre::String filename); //!< Returns once the state is captured; the file is written in background
+    void           WaitForSceneSave();
+    void           RestoreSavedState(Actor* actor, rapidjson::Value const& j_entry, SavedActorBlocks const* blocks = nullptr); //!< `blocks` are given for binary savegames
 
     std::vector<Actor*> GetActors() const                  { return m_actors; };
+    Replay*        GetReplay()                             { return m_replay.get(); } //!< Null unless `sim_replay_enabled` when an actor was spawned
     std::vector<Actor*> GetLocalActors();
+    ActorBroadphase const& GetInterActorBroadphase() const { return m_inter_actor_broadphase; } //!< Valid during the physics step
 
     std::pair<Actor*, float> GetNearestActor(Ogre::Vector3 position);
 
@@ -111,17 +136,36 @@ private:
     bool           CheckActorCollAabbIntersect(int a, int b);    //!< Returns whether or not the bounding boxes of truck a and truck b intersect. Based on the truck collision bounding boxes.
     bool           PredictActorCollAabbIntersect(int a, int b);  //!< Returns whether or not the bounding boxes of truck a and truck b might intersect during the next framestep. Based on the truck collision bounding boxes.
     void           RemoveStreamSource(int sourceid);
+    void           UpdateNetSendScheduler(Actor* player_actor); //!< Sends updates of local actors, rate-limited by `mp_send_budget`
     void           RecursiveActivation(int j, std::vector<bool>& visited);
     void           ForwardCommands(Actor* source_actor); //!< Fowards things to trailers
     void           UpdateTruckFeatures(Actor* vehicle, float dt);
 
+    // Physics step graph (see SetupSimGraph())
+    void           SetupSimGraph();
+    void           PrepareActorsForStep(int step);
+    void           ComputeActorStep(int index, int step);
+    void           CalcInterActorBeams();
+    void           UpdateInterActorBroadphase();
+    void           CalcInterActorCollisions(int index);
+    void           WriteSimNodeSnapshots();     //!< For the renderer, see `GfxActor::WriteSimNodeSnapshot()`
+
     // Networking
     std::map<int, std::set<int>> m_stream_mismatches; //!< Networking: A set of streams without a corresponding actor in the actor-array for each stream source
-    std::map<int, int>  m_stream_time_offsets;       //!< Networking: A network time offset for each stream source
     Ogre::Timer         m_net_timer;
+    unsigned long       m_net_send_last_time = 0;
+    float               m_net_send_tokens = 0.f;         //!< Networking: Upload budget left, in bytes (may go negative)
+    std::vector<Ogre::Vector3> m_net_interest_points;    //!< Networking: Remote players, UpdateNetSendScheduler() scratch
+    std::vector<std::pair<float, Actor*>> m_net_send_queue; //!< Networking: Due actors by overdue ratio, UpdateNetSendScheduler() scratch
+    NetSendStats        m_net_send_stats;
+    std::vector<Actor*> m_net_remote_actors;            //!< Networking: UpdateActors() scratch
+#ifdef USE_SOCKETW
+    std::vector<RoR::NetRecvPacket> m_net_packets;   //!< Networking: HandleActorStreamData() scratch, views only
+#endif // USE_SOCKETW
 
     // Physics
     std::vector<Actor*> m_actors;
+    std::unique_ptr<Replay> m_replay;                     //!< Records all local actors, see PrepareActorsForStep()
     bool                m_forced_awake           = false; //!< disables sleep counters
     int                 m_physics_steps          = 0;
     float               m_dt_remainder           = 0.f;   //!< Keeps track of the rounding error in the time step calculation
@@ -130,10 +174,15 @@ private:
     float               m_simulation_time        = 0.f;   //!< Amount of time the physics simulation is going to be advanced
     bool                m_simulation_paused      = false;
     float               m_total_sim_time         = 0.f;
+    ActorBroadphase     m_inter_actor_broadphase; //!< Rebuilt every physics step, after actors moved
 
     // Utils
     std::unique_ptr<ThreadPool> m_sim_thread_pool;
-    std::shared_ptr<Task>       m_sim_task;
+    TaskHandle                  m_sim_task;
+    std::unique_ptr<ThreadPool> m_save_thread_pool; //!< Serializes and writes savegames, see SaveScene()
+    TaskHandle                  m_save_task;
+    JobGraph                    m_sim_graph;        //!< One physics step; executed `m_physics_steps` times per frame
+    PhysicsStepStats            m_step_stats;
     RoR::CmdKeyInertiaConfig    m_inertia_config;
 };
 
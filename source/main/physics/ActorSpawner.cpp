@@ -579,8 +579,6 @@ void ActorSpawner::FinalizeRig()
     this->UpdateCollcabContacterNodes();
 
     m_flex_factory.SaveFlexbodiesToCache();
-
-    m_actor->GetGfxActor()->SortFlexbodies();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -6515,7 +6513,8 @@ void ActorSpawner::CreateGfxActor()
     m_actor->m_gfx_actor = std::unique_ptr<RoR::GfxActor>(
         new RoR::GfxActor(m_actor, this, m_custom_resource_group, m_gfx_nodes, m_oldstyle_renderdash));
 
-    m_actor->GetGfxActor()->UpdateSimDataBuffer(); // Initial fill (to setup flexing meshes)
+    m_actor->GetGfxActor()->WriteSimNodeSnapshot(); // Initial fill (to setup flexing meshes)
+    m_actor->GetGfxActor()->UpdateSimDataBuffer();
 }
 
 void ActorSpawner::FinalizeGfxSetup()
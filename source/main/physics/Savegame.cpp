@@ -35,12 +35,16 @@
 #include "InputEngine.h"
 #include "Language.h"
 #include "PlatformUtils.h"
+#include "SavegameBinary.h"
 #include "ScrewProp.h"
 #include "Skidmark.h"
 #include "SkyManager.h"
 #include "TerrainManager.h"
 
 #include <rapidjson/rapidjson.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <cstdio>
 #include <fstream>
 
 #define SAVEGAME_FILE_FORMAT 2
@@ -48,6 +52,155 @@
 using namespace Ogre;
 using namespace RoR;
 
+// --------------------------------
+// File IO
+
+/// Reads both formats; `blocks` (optional) receives the node/beam state of binary savegames
+/// and stays empty for JSON ones, which have it inline.
+static bool LoadSavegameFile(std::string const& filename, rapidjson::Document& j_doc, SavedActorBlocksVec* blocks)
+{
+    SavegameBinaryHeader header;
+    std::string json;
+    std::vector<uint8_t> data;
+    bool binary = false;
+    try
+    {
+        Ogre::DataStreamPtr stream = Ogre::ResourceGroupManager::getSingleton().openResource(filename, RGN_SAVEGAMES);
+        binary = stream->read(&header, sizeof(SavegameBinaryHeader)) == sizeof(SavegameBinaryHeader)
+              && SavegameBinaryCheckHeader(header);
+        if (binary)
+        {
+            const size_t remaining = stream->size() - sizeof(SavegameBinaryHeader);
+            if (header.json_size > remaining || header.blocks_size > remaining - header.json_size)
+            {
+                RoR::LogFormat("[RoR|Savegame] File '%s' is truncated", filename.c_str());
+                return false;
+            }
+            json.resize(static_cast<size_t>(header.json_size));
+            stream->read(&json[0], json.size());
+            if (blocks != nullptr)
+            {
+                data.resize(static_cast<size_t>(header.blocks_size));
+                stream->read(data.data(), data.size());
+            }
+        }
+    }
+    catch (Ogre::FileNotFoundException)
+    {
+        return false; // Error already logged by OGRE
+    }
+    catch (std::exception& e)
+    {
+        RoR::LogFormat("[RoR|Savegame] Failed to read '%s', message: '%s'", filename.c_str(), e.what());
+        return false;
+    }
+
+    if (!binary)
+    {
+        return App::GetContentManager()->LoadAndParseJson(filename, RGN_SAVEGAMES, j_doc);
+    }
+
+    j_doc.Parse<rapidjson::kParseNanAndInfFlag>(json.c_str(), json.size());
+    if (j_doc.HasParseError() || !j_doc.IsObject())
+    {
+        RoR::LogFormat("[RoR|Savegame] Error parsing the scene of '%s'", filename.c_str());
+        return false;
+    }
+    if (blocks != nullptr)
+    {
+        const bool has_actors = j_doc.HasMember("actors") && j_doc["actors"].IsArray();
+        if (!SavegameBinaryReadBlocks(data.data(), data.size(), header.num_actors, *blocks) ||
+            !has_actors || j_doc["actors"].Size() != blocks->size())
+        {
+            RoR::LogFormat("[RoR|Savegame] Node/beam data of '%s' are damaged", filename.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Converts the node/beam snapshot to the inline arrays of JSON savegames
+static void AddJsonNodesAndBeams(rapidjson::Document& j_doc, SavedActorBlocksVec const& blocks)
+{
+    rapidjson::Value& j_actors = j_doc["actors"];
+    for (rapidjson::SizeType index = 0; index < j_actors.Size(); index++)
+    {
+        SavedActorBlocks const& actor_blocks = *blocks[index];
+
+        // Nodes
+        rapidjson::Value j_nodes(rapidjson::kArrayType);
+        for (uint32_t i = 0; i < actor_blocks.num_nodes; i++)
+        {
+            rapidjson::Value j_node(rapidjson::kArrayType);
+            for (int field = 0; field < SAVEGAME_NODE_NUM_FIELDS; field++) // Position, velocity, initial position
+            {
+                j_node.PushBack(actor_blocks.NodeField(field)[i], j_doc.GetAllocator());
+            }
+            j_nodes.PushBack(j_node, j_doc.GetAllocator());
+        }
+        j_actors[index].AddMember("nodes", j_nodes, j_doc.GetAllocator());
+
+        // Beams
+        rapidjson::Value j_beams(rapidjson::kArrayType);
+        for (uint32_t i = 0; i < actor_blocks.num_beams; i++)
+        {
+            rapidjson::Value j_beam(rapidjson::kArrayType);
+            for (int field = 0; field < SAVEGAME_BEAM_NUM_FIELDS; field++)
+            {
+                j_beam.PushBack(actor_blocks.BeamField(field)[i], j_doc.GetAllocator());
+            }
+            j_beam.PushBack((actor_blocks.beam_flags[i] & SAVEGAME_BEAM_BROKEN) != 0, j_doc.GetAllocator());
+            j_beam.PushBack((actor_blocks.beam_flags[i] & SAVEGAME_BEAM_DISABLED) != 0, j_doc.GetAllocator());
+            j_beam.PushBack((actor_blocks.beam_flags[i] & SAVEGAME_BEAM_INTER_ACTOR) != 0, j_doc.GetAllocator());
+            j_beam.PushBack(actor_blocks.beam_locked_actors[i], j_doc.GetAllocator());
+            j_beams.PushBack(j_beam, j_doc.GetAllocator());
+        }
+        j_actors[index].AddMember("beams", j_beams, j_doc.GetAllocator());
+    }
+}
+
+/// Runs on the save worker (see `ActorManager::SaveScene()`), so it uses plain file IO rather than
+/// OGRE resource streams. The file is written aside and then renamed, readers never see half of it.
+static bool WriteSavegameFile(std::string const& path, rapidjson::Document& j_doc, SavedActorBlocksVec const& blocks, bool binary)
+{
+    if (!binary)
+    {
+        AddJsonNodesAndBeams(j_doc, blocks);
+    }
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer, rapidjson::UTF8<>, rapidjson::UTF8<>,
+                      rapidjson::CrtAllocator, rapidjson::kWriteNanAndInfFlag>
+                      writer(buffer);
+    j_doc.Accept(writer);
+
+    std::vector<uint8_t> data;
+    if (binary)
+    {
+        SavegameBinaryWrite(std::string(buffer.GetString(), buffer.GetSize()), blocks, data);
+    }
+    const char* bytes = binary ? reinterpret_cast<const char*>(data.data()) : buffer.GetString();
+    const size_t size = binary ? data.size() : buffer.GetSize();
+
+    const std::string tmp_path = path + ".part";
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    file.write(bytes, size);
+    file.close();
+    if (!file)
+    {
+        RoR::LogFormat("[RoR|Savegame] Error writing '%s'", tmp_path.c_str());
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+
+    if (!RenameFileReplacing(tmp_path.c_str(), path.c_str()))
+    {
+        RoR::LogFormat("[RoR|Savegame] Error renaming '%s' to '%s'", tmp_path.c_str(), path.c_str());
+        return false;
+    }
+    return true;
+}
+
 // --------------------------------
 // GameContext functions
 
@@ -70,11 +223,28 @@ void GameContext::SaveScene(std::string const& filename)
     m_actor_manager.SaveScene(filename);
 }
 
+void GameContext::UpdateAutosave(float dt)
+{
+    const int interval = App::sim_autosave_interval->GetInt();
+    if (interval <= 0 || App::mp_state->GetEnum<MpState>() == RoR::MpState::CONNECTED)
+    {
+        m_autosave_timer = 0.f;
+        return;
+    }
+
+    m_autosave_timer += dt;
+    if (m_autosave_timer >= interval)
+    {
+        m_autosave_timer = 0.f;
+        this->SaveScene("autosave.sav");
+    }
+}
+
 std::string GameContext::ExtractSceneName(std::string const& filename)
 {
     // Read from disk
     rapidjson::Document j_doc;
-    if (!App::GetContentManager()->LoadAndParseJson(filename, RGN_SAVEGAMES, j_doc) ||
+    if (!LoadSavegameFile(filename, j_doc, nullptr) ||
         !j_doc.IsObject() || !j_doc.HasMember("format_version") || !j_doc["format_version"].IsNumber() ||
         !j_doc.HasMember("scene_name") || !j_doc["scene_name"].IsString())
         return "";
@@ -86,7 +256,7 @@ std::string GameContext::ExtractSceneTerrain(std::string const& filename)
 {
     // Read from disk
     rapidjson::Document j_doc;
-    if (!App::GetContentManager()->LoadAndParseJson(filename, RGN_SAVEGAMES, j_doc) ||
+    if (!LoadSavegameFile(filename, j_doc, nullptr) ||
         !j_doc.IsObject() || !j_doc.HasMember("format_version") || !j_doc["format_version"].IsNumber() ||
         !j_doc.HasMember("terrain_name") || !j_doc["terrain_name"].IsString())
         return "";
@@ -237,9 +407,12 @@ void GameContext::HandleSavegameHotkeys()
 
 bool ActorManager::LoadScene(Ogre::String filename)
 {
+    this->WaitForSceneSave(); // The file may be just being written
+
     // Read from disk
     rapidjson::Document j_doc;
-    if (!App::GetContentManager()->LoadAndParseJson(filename, RGN_SAVEGAMES, j_doc) ||
+    SavedActorBlocksVec blocks; // Binary savegames only
+    if (!LoadSavegameFile(filename, j_doc, &blocks) ||
         !j_doc.IsObject() || !j_doc.HasMember("format_version") || !j_doc["format_version"].IsNumber())
     {
         App::GetConsole()->putMessage(
@@ -362,6 +535,7 @@ bool ActorManager::LoadScene(Ogre::String filename)
             // Copy saved state
             rq->asr_saved_state = std::shared_ptr<rapidjson::Document>(new rapidjson::Document());
             rq->asr_saved_state->CopyFrom(j_entry, rq->asr_saved_state->GetAllocator());
+            rq->asr_saved_blocks = blocks.empty() ? nullptr : blocks[index];
 
             App::GetGameContext()->PushMessage(Message(MSG_SIM_SPAWN_ACTOR_REQUESTED, (void*)rq));
             actors_changed = true;
@@ -393,7 +567,7 @@ bool ActorManager::LoadScene(Ogre::String filename)
         Actor* actor = actors[index];
         rapidjson::Value& j_entry = j_doc["actors"][index];
 
-        this->RestoreSavedState(actor, j_entry);
+        this->RestoreSavedState(actor, j_entry, blocks.empty() ? nullptr : blocks[index].get());
     }
 
     if (filename != "autosave.sav")
@@ -407,6 +581,12 @@ bool ActorManager::LoadScene(Ogre::String filename)
 
 bool ActorManager::SaveScene(Ogre::String filename)
 {
+    // The scene is captured here, at a sync point: the JSON document and the node/beam blocks are
+    // built on this thread. Only the serialization and file IO run on `m_save_thread_pool`,
+    // which reports back with MSG_SIM_SCENE_SAVED / MSG_SIM_SCENE_SAVE_FAILED.
+    this->SyncWithSimThread();
+    this->WaitForSceneSave(); // One save at a time
+
     std::vector<Actor*> x_actors = GetLocalActors();
 
     if (App::mp_state->GetEnum<MpState>() == RoR::MpState::CONNECTED)
@@ -421,17 +601,22 @@ bool ActorManager::SaveScene(Ogre::String filename)
         }
     }
 
-    rapidjson::Document j_doc;
+    const bool binary = App::sim_savegame_binary->GetBool();
+    SavedActorBlocksVec blocks; // Node/beam snapshot, converted to JSON by the worker unless `binary`
+
+    // Strings must be copies, the document outlives this function
+    std::shared_ptr<rapidjson::Document> j_doc_ptr = std::make_shared<rapidjson::Document>();
+    rapidjson::Document& j_doc = *j_doc_ptr;
     j_doc.SetObject();
     j_doc.AddMember("format_version", SAVEGAME_FILE_FORMAT, j_doc.GetAllocator());
 
     // Pretty name
     String pretty_name = App::GetCacheSystem()->GetPrettyName(App::sim_terrain_name->GetStr());
     String scene_name = StringUtil::format("%s [%d]", pretty_name.c_str(), x_actors.size());
-    j_doc.AddMember("scene_name", rapidjson::StringRef(scene_name.c_str()), j_doc.GetAllocator());
+    j_doc.AddMember("scene_name", rapidjson::Value(scene_name.c_str(), j_doc.GetAllocator()).Move(), j_doc.GetAllocator());
 
     // Terrain
-    j_doc.AddMember("terrain_name", rapidjson::StringRef(App::sim_terrain_name->GetStr().c_str()), j_doc.GetAllocator());
+    j_doc.AddMember("terrain_name", rapidjson::Value(App::sim_terrain_name->GetStr().c_str(), j_doc.GetAllocator()).Move(), j_doc.GetAllocator());
 
 #ifdef USE_CAELUM
     if (App::gfx_sky_mode->GetEnum<GfxSkyMode>() == GfxSkyMode::CAELUM)
@@ -470,7 +655,7 @@ bool ActorManager::SaveScene(Ogre::String filename)
     {
         rapidjson::Value j_entry(rapidjson::kObjectType);
 
-        j_entry.AddMember("filename", rapidjson::StringRef(actor->ar_filename.c_str()), j_doc.GetAllocator());
+        j_entry.AddMember("filename", rapidjson::Value(actor->ar_filename.c_str(), j_doc.GetAllocator()).Move(), j_doc.GetAllocator());
         rapidjson::Value j_actor_position(rapidjson::kArrayType);
         j_actor_position.PushBack(actor->ar_nodes[0].AbsPosition.x, j_doc.GetAllocator());
         j_actor_position.PushBack(actor->ar_nodes[0].AbsPosition.y, j_doc.GetAllocator());
@@ -487,10 +672,10 @@ bool ActorManager::SaveScene(Ogre::String filename)
 
         if (actor->m_used_skin_entry)
         {
-            j_entry.AddMember("skin", rapidjson::StringRef(actor->m_used_skin_entry->dname.c_str()), j_doc.GetAllocator());
+            j_entry.AddMember("skin", rapidjson::Value(actor->m_used_skin_entry->dname.c_str(), j_doc.GetAllocator()).Move(), j_doc.GetAllocator());
         }
 
-        j_entry.AddMember("section_config", rapidjson::StringRef(actor->m_section_config.c_str()), j_doc.GetAllocator());
+        j_entry.AddMember("section_config", rapidjson::Value(actor->m_section_config.c_str(), j_doc.GetAllocator()).Move(), j_doc.GetAllocator());
 
         // Engine, anti-lock brake, traction control
         if (actor->ar_engine)
@@ -680,75 +865,57 @@ bool ActorManager::SaveScene(Ogre::String filename)
 
         j_entry.AddMember("slidenodes_locked", actor->m_slidenodes_locked, j_doc.GetAllocator());
 
-        // Nodes
-        rapidjson::Value j_nodes(rapidjson::kArrayType);
+        // Nodes and beams, see SavegameBinary.h
+        std::shared_ptr<SavedActorBlocks> actor_blocks = std::make_shared<SavedActorBlocks>();
+        actor_blocks->Resize(actor->ar_num_nodes, actor->ar_num_beams);
         for (int i = 0; i < actor->ar_num_nodes; i++)
         {
-            rapidjson::Value j_node(rapidjson::kArrayType);
-
-            // Position
-            j_node.PushBack(actor->ar_nodes[i].AbsPosition.x, j_doc.GetAllocator());
-            j_node.PushBack(actor->ar_nodes[i].AbsPosition.y, j_doc.GetAllocator());
-            j_node.PushBack(actor->ar_nodes[i].AbsPosition.z, j_doc.GetAllocator());
-
-            // Velocity
-            j_node.PushBack(actor->ar_nodes[i].Velocity.x, j_doc.GetAllocator());
-            j_node.PushBack(actor->ar_nodes[i].Velocity.y, j_doc.GetAllocator());
-            j_node.PushBack(actor->ar_nodes[i].Velocity.z, j_doc.GetAllocator());
-
-            // Initial Position
-            j_node.PushBack(actor->ar_initial_node_positions[i].x, j_doc.GetAllocator());
-            j_node.PushBack(actor->ar_initial_node_positions[i].y, j_doc.GetAllocator());
-            j_node.PushBack(actor->ar_initial_node_positions[i].z, j_doc.GetAllocator());
-
-            j_nodes.PushBack(j_node, j_doc.GetAllocator());
+            actor_blocks->NodeField(SAVEGAME_NODE_POS_X)[i]  = actor->ar_nodes[i].AbsPosition.x;
+            actor_blocks->NodeField(SAVEGAME_NODE_POS_Y)[i]  = actor->ar_nodes[i].AbsPosition.y;
+            actor_blocks->NodeField(SAVEGAME_NODE_POS_Z)[i]  = actor->ar_nodes[i].AbsPosition.z;
+            actor_blocks->NodeField(SAVEGAME_NODE_VEL_X)[i]  = actor->ar_nodes[i].Velocity.x;
+            actor_blocks->NodeField(SAVEGAME_NODE_VEL_Y)[i]  = actor->ar_nodes[i].Velocity.y;
+            actor_blocks->NodeField(SAVEGAME_NODE_VEL_Z)[i]  = actor->ar_nodes[i].Velocity.z;
+            actor_blocks->NodeField(SAVEGAME_NODE_INIT_X)[i] = actor->ar_initial_node_positions[i].x;
+            actor_blocks->NodeField(SAVEGAME_NODE_INIT_Y)[i] = actor->ar_initial_node_positions[i].y;
+            actor_blocks->NodeField(SAVEGAME_NODE_INIT_Z)[i] = actor->ar_initial_node_positions[i].z;
         }
-        j_entry.AddMember("nodes", j_nodes, j_doc.GetAllocator());
-
-        // Beams
-        rapidjson::Value j_beams(rapidjson::kArrayType);
         for (int i = 0; i < actor->ar_num_beams; i++)
         {
-            rapidjson::Value j_beam(rapidjson::kArrayType);
-
-            j_beam.PushBack(actor->ar_beams[i].maxposstress, j_doc.GetAllocator());
-            j_beam.PushBack(actor->ar_beams[i].maxnegstress, j_doc.GetAllocator());
-            j_beam.PushBack(actor->ar_beams[i].minmaxposnegstress, j_doc.GetAllocator());
-            j_beam.PushBack(actor->ar_beams[i].strength, j_doc.GetAllocator());
-            j_beam.PushBack(actor->ar_beams[i].L, j_doc.GetAllocator());
-            j_beam.PushBack(actor->ar_beams[i].bm_broken, j_doc.GetAllocator());
-            j_beam.PushBack(actor->ar_beams[i].bm_disabled, j_doc.GetAllocator());
-            j_beam.PushBack(actor->ar_beams[i].bm_inter_actor, j_doc.GetAllocator());
-            Actor* locked_actor = actor->ar_beams[i].bm_locked_actor;
-            j_beam.PushBack(locked_actor ? vector_index_lookup[locked_actor->ar_vector_index] : -1, j_doc.GetAllocator());
-
-            j_beams.PushBack(j_beam, j_doc.GetAllocator());
+            beam_t const& beam = actor->ar_beams[i];
+            actor_blocks->BeamField(SAVEGAME_BEAM_MAXPOSSTRESS)[i]       = beam.maxposstress;
+            actor_blocks->BeamField(SAVEGAME_BEAM_MAXNEGSTRESS)[i]       = beam.maxnegstress;
+            actor_blocks->BeamField(SAVEGAME_BEAM_MINMAXPOSNEGSTRESS)[i] = beam.minmaxposnegstress;
+            actor_blocks->BeamField(SAVEGAME_BEAM_STRENGTH)[i]           = beam.strength;
+            actor_blocks->BeamField(SAVEGAME_BEAM_L)[i]                  = beam.L;
+            actor_blocks->beam_flags[i] = (beam.bm_broken ? SAVEGAME_BEAM_BROKEN : 0)
+                                        | (beam.bm_disabled ? SAVEGAME_BEAM_DISABLED : 0)
+                                        | (beam.bm_inter_actor ? SAVEGAME_BEAM_INTER_ACTOR : 0);
+            actor_blocks->beam_locked_actors[i] = beam.bm_locked_actor ? vector_index_lookup[beam.bm_locked_actor->ar_vector_index] : -1;
         }
-        j_entry.AddMember("beams", j_beams, j_doc.GetAllocator());
+        blocks.push_back(actor_blocks);
 
         j_actors.PushBack(j_entry, j_doc.GetAllocator());
     }
     j_doc.AddMember("actors", j_actors, j_doc.GetAllocator());
 
     // Write to disk
-    if (!App::GetContentManager()->SerializeAndWriteJson(filename, RGN_SAVEGAMES, j_doc))
-    {
-        // Error already logged
-        App::GetConsole()->putMessage(
-            Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_ERROR, _L("Error while saving scene"));
-        return false;
-    }
-
-    if (filename != "autosave.sav")
-    {
-        App::GetConsole()->putMessage(
-            Console::CONSOLE_MSGTYPE_INFO, Console::CONSOLE_SYSTEM_NOTICE, _L("Scene saved"));
-    }
+    const std::string path = PathCombine(App::sys_savegames_dir->GetStr(), filename);
+    m_save_task = m_save_thread_pool->RunTask([j_doc_ptr, blocks, binary, path, filename]()
+        {
+            const bool written = WriteSavegameFile(path, *j_doc_ptr, blocks, binary);
+            App::GetGameContext()->PushMessage(Message(written ? MSG_SIM_SCENE_SAVED : MSG_SIM_SCENE_SAVE_FAILED, filename));
+        });
 
     return true;
 }
 
-void ActorManager::RestoreSavedState(Actor* actor, rapidjson::Value const& j_entry)
+void ActorManager::WaitForSceneSave()
+{
+    m_save_task.join();
+}
+
+void ActorManager::RestoreSavedState(Actor* actor, rapidjson::Value const& j_entry, SavedActorBlocks const* blocks)
 {
     actor->m_spawn_rotation = j_entry["spawn_rotation"].GetFloat();
     actor->ar_sim_state = static_cast<Actor::SimState>(j_entry["sim_state"].GetInt());
@@ -893,36 +1060,83 @@ void ActorManager::RestoreSavedState(Actor* actor, rapidjson::Value const& j_ent
         }
     }
 
-    auto nodes = j_entry["nodes"].GetArray();
-    for (rapidjson::SizeType i = 0; i < nodes.Size(); i++)
+    std::vector<Actor*> actors = this->GetLocalActors();
+
+    if (blocks != nullptr)
     {
-        auto data = nodes[i].GetArray();
-        actor->ar_nodes[i].AbsPosition      = Vector3(data[0].GetFloat(), data[1].GetFloat(), data[2].GetFloat());
-        actor->ar_nodes[i].RelPosition      = actor->ar_nodes[i].AbsPosition - actor->ar_origin;
-        actor->ar_nodes[i].Velocity         = Vector3(data[3].GetFloat(), data[4].GetFloat(), data[5].GetFloat());
-        actor->ar_initial_node_positions[i] = Vector3(data[6].GetFloat(), data[7].GetFloat(), data[8].GetFloat());
-    }
+        // Binary savegame, see SavegameBinary.h
+        if (blocks->num_nodes != static_cast<uint32_t>(actor->ar_num_nodes) ||
+            blocks->num_beams != static_cast<uint32_t>(actor->ar_num_beams))
+        {
+            RoR::LogFormat("[RoR|Savegame] Node/beam count of '%s' changed since saving, its state is not restored", actor->ar_filename.c_str());
+        }
+        else
+        {
+            for (int i = 0; i < actor->ar_num_nodes; i++)
+            {
+                actor->ar_nodes[i].AbsPosition = Vector3(blocks->NodeField(SAVEGAME_NODE_POS_X)[i],
+                                                         blocks->NodeField(SAVEGAME_NODE_POS_Y)[i],
+                                                         blocks->NodeField(SAVEGAME_NODE_POS_Z)[i]);
+                actor->ar_nodes[i].RelPosition = actor->ar_nodes[i].AbsPosition - actor->ar_origin;
+                actor->ar_nodes[i].Velocity    = Vector3(blocks->NodeField(SAVEGAME_NODE_VEL_X)[i],
+                                                         blocks->NodeField(SAVEGAME_NODE_VEL_Y)[i],
+                                                         blocks->NodeField(SAVEGAME_NODE_VEL_Z)[i]);
+                actor->ar_initial_node_positions[i] = Vector3(blocks->NodeField(SAVEGAME_NODE_INIT_X)[i],
+                                                              blocks->NodeField(SAVEGAME_NODE_INIT_Y)[i],
+                                                              blocks->NodeField(SAVEGAME_NODE_INIT_Z)[i]);
+            }
 
-    std::vector<Actor*> actors = this->GetLocalActors();
+            for (int i = 0; i < actor->ar_num_beams; i++)
+            {
+                actor->ar_beams[i].maxposstress       = blocks->BeamField(SAVEGAME_BEAM_MAXPOSSTRESS)[i];
+                actor->ar_beams[i].maxnegstress       = blocks->BeamField(SAVEGAME_BEAM_MAXNEGSTRESS)[i];
+                actor->ar_beams[i].minmaxposnegstress = blocks->BeamField(SAVEGAME_BEAM_MINMAXPOSNEGSTRESS)[i];
+                actor->ar_beams[i].strength           = blocks->BeamField(SAVEGAME_BEAM_STRENGTH)[i];
+                actor->ar_beams[i].L                  = blocks->BeamField(SAVEGAME_BEAM_L)[i];
+                actor->ar_beams[i].bm_broken          = (blocks->beam_flags[i] & SAVEGAME_BEAM_BROKEN) != 0;
+                actor->ar_beams[i].bm_disabled        = (blocks->beam_flags[i] & SAVEGAME_BEAM_DISABLED) != 0;
+                actor->ar_beams[i].bm_inter_actor     = (blocks->beam_flags[i] & SAVEGAME_BEAM_INTER_ACTOR) != 0;
+                int locked_actor                      = blocks->beam_locked_actors[i];
+                if (locked_actor >= 0 &&
+                    locked_actor < (int)actors.size() &&
+                    actors[locked_actor] != nullptr)
+                {
+                    actor->AddInterActorBeam(&actor->ar_beams[i], actor, actors[locked_actor]);
+                }
+            }
+        }
+    }
+    else
+    {
+        auto nodes = j_entry["nodes"].GetArray();
+        for (rapidjson::SizeType i = 0; i < nodes.Size(); i++)
+        {
+            auto data = nodes[i].GetArray();
+            actor->ar_nodes[i].AbsPosition      = Vector3(data[0].GetFloat(), data[1].GetFloat(), data[2].GetFloat());
+            actor->ar_nodes[i].RelPosition      = actor->ar_nodes[i].AbsPosition - actor->ar_origin;
+            actor->ar_nodes[i].Velocity         = Vector3(data[3].GetFloat(), data[4].GetFloat(), data[5].GetFloat());
+            actor->ar_initial_node_positions[i] = Vector3(data[6].GetFloat(), data[7].GetFloat(), data[8].GetFloat());
+        }
 
-    auto beams = j_entry["beams"].GetArray();
-    for (rapidjson::SizeType i = 0; i < beams.Size(); i++)
-    {
-        auto data = beams[i].GetArray();
-        actor->ar_beams[i].maxposstress       = data[0].GetFloat();
-        actor->ar_beams[i].maxnegstress       = data[1].GetFloat();
-        actor->ar_beams[i].minmaxposnegstress = data[2].GetFloat();
-        actor->ar_beams[i].strength           = data[3].GetFloat();
-        actor->ar_beams[i].L                  = data[4].GetFloat();
-        actor->ar_beams[i].bm_broken          = data[5].GetBool();
-        actor->ar_beams[i].bm_disabled        = data[6].GetBool();
-        actor->ar_beams[i].bm_inter_actor     = data[7].GetBool();
-        int locked_actor                      = data[8].GetInt();
-        if (locked_actor != -1 &&
-            locked_actor < (int)actors.size() &&
-            actors[locked_actor] != nullptr)
+        auto beams = j_entry["beams"].GetArray();
+        for (rapidjson::SizeType i = 0; i < beams.Size(); i++)
         {
-            actor->AddInterActorBeam(&actor->ar_beams[i], actor, actors[locked_actor]);
+            auto data = beams[i].GetArray();
+            actor->ar_beams[i].maxposstress       = data[0].GetFloat();
+            actor->ar_beams[i].maxnegstress       = data[1].GetFloat();
+            actor->ar_beams[i].minmaxposnegstress = data[2].GetFloat();
+            actor->ar_beams[i].strength           = data[3].GetFloat();
+            actor->ar_beams[i].L                  = data[4].GetFloat();
+            actor->ar_beams[i].bm_broken          = data[5].GetBool();
+            actor->ar_beams[i].bm_disabled        = data[6].GetBool();
+            actor->ar_beams[i].bm_inter_actor     = data[7].GetBool();
+            int locked_actor                      = data[8].GetInt();
+            if (locked_actor != -1 &&
+                locked_actor < (int)actors.size() &&
+                actors[locked_actor] != nullptr)
+            {
+                actor->AddInterActorBeam(&actor->ar_beams[i], actor, actors[locked_actor]);
+            }
         }
     }
 
@@ -0,0 +1,131 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SavegameBinary.h"
+
+#include <cstring>
+
+using namespace RoR;
+
+namespace {
+
+inline size_t GetBlockSize(uint32_t num_nodes, uint32_t num_beams)
+{
+    const size_t size = sizeof(SavegameActorBlockHeader)
+        + size_t(num_nodes) * SAVEGAME_NODE_NUM_FIELDS * sizeof(float)
+        + size_t(num_beams) * (SAVEGAME_BEAM_NUM_FIELDS * sizeof(float) + sizeof(int32_t) + sizeof(uint8_t));
+    return (size + 3) & ~size_t(3);
+}
+
+inline uint8_t* Append(uint8_t* dst, const void* src, size_t size)
+{
+    if (size > 0)
+        std::memcpy(dst, src, size);
+    return dst + size;
+}
+
+inline const uint8_t* Extract(void* dst, const uint8_t* src, size_t size)
+{
+    if (size > 0)
+        std::memcpy(dst, src, size);
+    return src + size;
+}
+
+} // namespace
+
+void SavedActorBlocks::Resize(uint32_t nodes, uint32_t beams)
+{
+    num_nodes = nodes;
+    num_beams = beams;
+    node_data.resize(size_t(nodes) * SAVEGAME_NODE_NUM_FIELDS);
+    beam_data.resize(size_t(beams) * SAVEGAME_BEAM_NUM_FIELDS);
+    beam_locked_actors.resize(beams);
+    beam_flags.resize(beams);
+}
+
+void RoR::SavegameBinaryWrite(std::string const& json, SavedActorBlocksVec const& actors, std::vector<uint8_t>& out)
+{
+    SavegameBinaryHeader header;
+    std::memcpy(header.magic, SAVEGAME_BINARY_MAGIC, sizeof(SAVEGAME_BINARY_MAGIC));
+    header.version = SAVEGAME_BINARY_VERSION;
+    header.num_actors = static_cast<uint32_t>(actors.size());
+    header.json_size = json.size();
+    header.blocks_size = 0;
+    for (auto& blocks: actors)
+    {
+        header.blocks_size += GetBlockSize(blocks->num_nodes, blocks->num_beams);
+    }
+
+    // Sized once, the arrays are copied as they are
+    out.assign(sizeof(SavegameBinaryHeader) + json.size() + header.blocks_size, 0);
+    uint8_t* dst = out.data();
+    dst = Append(dst, &header, sizeof(SavegameBinaryHeader));
+    dst = Append(dst, json.data(), json.size());
+    for (auto& blocks: actors)
+    {
+        uint8_t* block_start = dst;
+        SavegameActorBlockHeader block_header;
+        block_header.num_nodes = blocks->num_nodes;
+        block_header.num_beams = blocks->num_beams;
+        dst = Append(dst, &block_header, sizeof(SavegameActorBlockHeader));
+        dst = Append(dst, blocks->node_data.data(), blocks->node_data.size() * sizeof(float));
+        dst = Append(dst, blocks->beam_data.data(), blocks->beam_data.size() * sizeof(float));
+        dst = Append(dst, blocks->beam_locked_actors.data(), blocks->beam_locked_actors.size() * sizeof(int32_t));
+        dst = Append(dst, blocks->beam_flags.data(), blocks->beam_flags.size());
+        dst = block_start + GetBlockSize(blocks->num_nodes, blocks->num_beams); // Padding is zeroed already
+    }
+}
+
+bool RoR::SavegameBinaryCheckHeader(SavegameBinaryHeader const& header)
+{
+    return std::memcmp(header.magic, SAVEGAME_BINARY_MAGIC, sizeof(SAVEGAME_BINARY_MAGIC)) == 0
+        && header.version == SAVEGAME_BINARY_VERSION;
+}
+
+bool RoR::SavegameBinaryReadBlocks(const uint8_t* data, size_t size, uint32_t num_actors, SavedActorBlocksVec& out)
+{
+    out.clear();
+    size_t offset = 0;
+    for (uint32_t i = 0; i < num_actors; i++)
+    {
+        SavegameActorBlockHeader block_header;
+        if (size - offset < sizeof(SavegameActorBlockHeader))
+            return false;
+        std::memcpy(&block_header, data + offset, sizeof(SavegameActorBlockHeader));
+
+        // Bound the counts before computing the size, so that it can't overflow
+        if (block_header.num_nodes > size || block_header.num_beams > size ||
+            GetBlockSize(block_header.num_nodes, block_header.num_beams) > size - offset)
+        {
+            return false;
+        }
+
+        std::shared_ptr<SavedActorBlocks> blocks = std::make_shared<SavedActorBlocks>();
+        blocks->Resize(block_header.num_nodes, block_header.num_beams);
+        const uint8_t* src = data + offset + sizeof(SavegameActorBlockHeader);
+        src = Extract(blocks->node_data.data(), src, blocks->node_data.size() * sizeof(float));
+        src = Extract(blocks->beam_data.data(), src, blocks->beam_data.size() * sizeof(float));
+        src = Extract(blocks->beam_locked_actors.data(), src, blocks->beam_locked_actors.size() * sizeof(int32_t));
+        src = Extract(blocks->beam_flags.data(), src, blocks->beam_flags.size());
+
+        out.push_back(blocks);
+        offset += GetBlockSize(block_header.num_nodes, block_header.num_beams);
+    }
+    return true;
+}
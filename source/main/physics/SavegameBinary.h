@@ -0,0 +1,120 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Binary savegames (cvar `sim_savegame_binary`); the scene and actor metadata stay JSON
+///        (see Savegame.cpp), only the bulk node and beam state is stored raw, one array per field.
+///
+/// Layout: SavegameBinaryHeader, `json_size` bytes of JSON text, then for each entry of the JSON "actors":
+/// - SavegameActorBlockHeader
+/// - SAVEGAME_NODE_NUM_FIELDS float arrays of `num_nodes`
+/// - SAVEGAME_BEAM_NUM_FIELDS float arrays of `num_beams`
+/// - int32 array of `num_beams`: locked actor index (-1 = none)
+/// - uint8 array of `num_beams`: SAVEGAME_BEAM_* flags, then zero padding to 4 bytes
+/// All values are little-endian, like every platform we run on.
+/// Standard library only, so that microbenchmarks can include it.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace RoR {
+
+static const char     SAVEGAME_BINARY_MAGIC[8] = {'R', 'O', 'R', 'S', 'A', 'V', 'E', '\0'};
+static const uint32_t SAVEGAME_BINARY_VERSION = 1;
+
+static const uint8_t  SAVEGAME_BEAM_BROKEN      = 0x1;
+static const uint8_t  SAVEGAME_BEAM_DISABLED    = 0x2;
+static const uint8_t  SAVEGAME_BEAM_INTER_ACTOR = 0x4;
+
+enum SavegameNodeField
+{
+    SAVEGAME_NODE_POS_X,
+    SAVEGAME_NODE_POS_Y,
+    SAVEGAME_NODE_POS_Z,
+    SAVEGAME_NODE_VEL_X,
+    SAVEGAME_NODE_VEL_Y,
+    SAVEGAME_NODE_VEL_Z,
+    SAVEGAME_NODE_INIT_X,   //!< `Actor::ar_initial_node_positions`
+    SAVEGAME_NODE_INIT_Y,
+    SAVEGAME_NODE_INIT_Z,
+    SAVEGAME_NODE_NUM_FIELDS
+};
+
+enum SavegameBeamField
+{
+    SAVEGAME_BEAM_MAXPOSSTRESS,
+    SAVEGAME_BEAM_MAXNEGSTRESS,
+    SAVEGAME_BEAM_MINMAXPOSNEGSTRESS,
+    SAVEGAME_BEAM_STRENGTH,
+    SAVEGAME_BEAM_L,
+    SAVEGAME_BEAM_NUM_FIELDS
+};
+
+#pragma pack(push, 1)
+
+struct SavegameBinaryHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t num_actors;
+    uint64_t json_size;
+    uint64_t blocks_size;  //!< Bytes after the JSON text
+};
+
+struct SavegameActorBlockHeader
+{
+    uint32_t num_nodes;
+    uint32_t num_beams;
+};
+
+#pragma pack(pop)
+
+/// Node and beam state of one actor, as saved; see `ActorManager::RestoreSavedState()`
+struct SavedActorBlocks
+{
+    void           Resize(uint32_t nodes, uint32_t beams);
+    float*         NodeField(int field)       { return node_data.data() + field * num_nodes; }
+    const float*   NodeField(int field) const { return node_data.data() + field * num_nodes; }
+    float*         BeamField(int field)       { return beam_data.data() + field * num_beams; }
+    const float*   BeamField(int field) const { return beam_data.data() + field * num_beams; }
+
+    uint32_t             num_nodes = 0;
+    uint32_t             num_beams = 0;
+    std::vector<float>   node_data;           //!< SavegameNodeField arrays
+    std::vector<float>   beam_data;           //!< SavegameBeamField arrays
+    std::vector<int32_t> beam_locked_actors;
+    std::vector<uint8_t> beam_flags;          //!< SAVEGAME_BEAM_*
+};
+
+typedef std::vector<std::shared_ptr<SavedActorBlocks>> SavedActorBlocksVec;
+
+/// Whole file, header included
+void SavegameBinaryWrite(std::string const& json, SavedActorBlocksVec const& actors, std::vector<uint8_t>& out);
+
+bool SavegameBinaryCheckHeader(SavegameBinaryHeader const& header);
+
+/// Parses what follows the JSON text; returns false if it's truncated or inconsistent.
+bool SavegameBinaryReadBlocks(const uint8_t* data, size_t size, uint32_t num_actors, SavedActorBlocksVec& out);
+
+} // namespace RoR
@@ -669,6 +669,8 @@ struct ActorSpawnRequest
     bool                asr_terrn_machine = false;   //!< This is a fixed machinery
     std::shared_ptr<rapidjson::Document>
                         asr_saved_state;             //!< Pushes msg MODIFY_ACTOR (type RESTORE_SAVED) after spawn.
+    std::shared_ptr<SavedActorBlocks>
+                        asr_saved_blocks;            //!< Nodes and beams of binary savegames; JSON ones have them in `asr_saved_state`
 };
 
 struct ActorModifyRequest
@@ -688,6 +690,8 @@ struct ActorModifyRequest
     Type                amr_type;
     std::shared_ptr<rapidjson::Document>
                         amr_saved_state;
+    std::shared_ptr<SavedActorBlocks>
+                        amr_saved_blocks;
 };
 
 } // namespace RoR
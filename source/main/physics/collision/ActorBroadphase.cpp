@@ -0,0 +1,146 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ActorBroadphase.h"
+
+#include "Actor.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace Ogre;
+using namespace RoR;
+
+void ActorBroadphase::Update(std::vector<Actor*> const& actors)
+{
+    m_actors = actors;
+    m_boxes.resize(actors.size());
+    m_cells.clear();
+    m_oversized.clear();
+
+    for (int i = 0; i < static_cast<int>(actors.size()); ++i)
+    {
+        const AxisAlignedBox& aabb = actors[i]->ar_bounding_box;
+        Box& box = m_boxes[i];
+        box.valid = !aabb.isNull();
+        if (!box.valid)
+            continue;
+
+        if (aabb.isInfinite())
+        {
+            box.min = Vector3(-std::numeric_limits<float>::max());
+            box.max = Vector3(std::numeric_limits<float>::max());
+            m_oversized.push_back(i);
+            continue;
+        }
+
+        box.min = aabb.getMinimum();
+        box.max = aabb.getMaximum();
+        const int x0 = GetCellCoord(box.min.x), x1 = GetCellCoord(box.max.x);
+        const int z0 = GetCellCoord(box.min.z), z1 = GetCellCoord(box.max.z);
+        if ((x1 - x0 + 1) * (z1 - z0 + 1) > MAX_ACTOR_CELLS)
+        {
+            m_oversized.push_back(i);
+            continue;
+        }
+
+        for (int cx = x0; cx <= x1; ++cx)
+        {
+            for (int cz = z0; cz <= z1; ++cz)
+            {
+                m_cells.push_back(CellEntry{GetCellKey(cx, cz), i});
+            }
+        }
+    }
+
+    std::sort(m_cells.begin(), m_cells.end());
+}
+
+bool ActorBroadphase::Intersects(Box const& a, Box const& b)
+{
+    // Same as `Ogre::AxisAlignedBox::intersects()` - touching boxes intersect
+    return a.max.x >= b.min.x && a.min.x <= b.max.x
+        && a.max.y >= b.min.y && a.min.y <= b.max.y
+        && a.max.z >= b.min.z && a.min.z <= b.max.z;
+}
+
+bool ActorBroadphase::QueryActor(const Actor* actor, std::vector<Actor*>& out) const
+{
+    out.clear();
+    const int self = static_cast<int>(actor->ar_vector_index);
+    if (self >= static_cast<int>(m_actors.size()) || m_actors[self] != actor)
+        return false;
+
+    const Box& box = m_boxes[self];
+    if (!box.valid)
+        return true;
+
+    const bool oversized = std::find(m_oversized.begin(), m_oversized.end(), self) != m_oversized.end();
+    if (oversized)
+    {
+        // Too big for the grid - test everyone
+        for (int i = 0; i < static_cast<int>(m_actors.size()); ++i)
+        {
+            if (i != self && m_boxes[i].valid && Intersects(box, m_boxes[i]))
+            {
+                out.push_back(m_actors[i]);
+            }
+        }
+        return true;
+    }
+
+    const int x0 = GetCellCoord(box.min.x), x1 = GetCellCoord(box.max.x);
+    const int z0 = GetCellCoord(box.min.z), z1 = GetCellCoord(box.max.z);
+    for (int cx = x0; cx <= x1; ++cx)
+    {
+        for (int cz = z0; cz <= z1; ++cz)
+        {
+            const int64_t key = GetCellKey(cx, cz);
+            auto itor = std::lower_bound(m_cells.begin(), m_cells.end(), CellEntry{key, -1});
+            for (; itor != m_cells.end() && itor->key == key; ++itor)
+            {
+                const int other = itor->actor;
+                if (other == self)
+                    continue;
+
+                // A pair of actors may share several cells; only report it from the first shared one
+                const Box& other_box = m_boxes[other];
+                if (cx != std::max(x0, GetCellCoord(other_box.min.x)) || cz != std::max(z0, GetCellCoord(other_box.min.z)))
+                    continue;
+
+                if (Intersects(box, other_box))
+                {
+                    out.push_back(m_actors[other]);
+                }
+            }
+        }
+    }
+
+    for (int other: m_oversized)
+    {
+        if (other != self && Intersects(box, m_boxes[other]))
+        {
+            out.push_back(m_actors[other]);
+        }
+    }
+
+    // Keep the order of `ActorManager::GetActors()`, the detector's point list depends on it
+    std::sort(out.begin(), out.end(), [](const Actor* a, const Actor* b) { return a->ar_vector_index < b->ar_vector_index; });
+    return true;
+}
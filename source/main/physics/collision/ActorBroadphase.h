@@ -0,0 +1,73 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "ForwardDeclarations.h"
+
+#include <OgreVector3.h>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace RoR {
+
+/// Inter-actor broadphase: a uniform grid (XZ plane) of actor bounding boxes.
+/// Rebuilt once per physics step by the ActorManager, then queried concurrently
+/// by every actor's inter-actor PointColDetector instead of testing all actor pairs.
+class ActorBroadphase
+{
+public:
+    static constexpr float CELL_SIZE = 16.f;     //!< Meters; roughly a truck's length
+    static const int       MAX_ACTOR_CELLS = 64; //!< Actors spanning more cells are tested against every query
+
+    /// Snapshots `ar_bounding_box` of all actors; `actors` must be indexed by `ar_vector_index`.
+    void Update(std::vector<Actor*> const& actors);
+
+    /// Finds actors (other than `actor`) whose bounding box intersects `actor`'s, ordered by `ar_vector_index`.
+    /// Thread-safe; returns false if `actor` was not part of the last Update() and nothing was searched.
+    bool QueryActor(const Actor* actor, std::vector<Actor*>& out) const;
+
+private:
+    struct CellEntry
+    {
+        int64_t key;
+        int     actor;
+
+        bool operator<(CellEntry const& other) const { return (key != other.key) ? key < other.key : actor < other.actor; }
+    };
+
+    struct Box
+    {
+        Ogre::Vector3 min;
+        Ogre::Vector3 max;
+        bool          valid;
+    };
+
+    static int     GetCellCoord(float pos) { return static_cast<int>(std::floor(pos / CELL_SIZE)); }
+    static int64_t GetCellKey(int cx, int cz) { return (static_cast<int64_t>(cx) << 32) | static_cast<uint32_t>(cz); }
+    static bool    Intersects(Box const& a, Box const& b);
+
+    std::vector<Actor*>    m_actors;
+    std::vector<Box>       m_boxes;      //!< Indexed like `m_actors`
+    std::vector<CellEntry> m_cells;      //!< Sorted by cell key, then actor index
+    std::vector<int>       m_oversized;  //!< Actors too big for the grid
+};
+
+} // namespace RoR
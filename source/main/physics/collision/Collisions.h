@@ -24,6 +24,7 @@
 
 #include "Application.h"
 #include "SimData.h" // for collision_box_t
+#include "StaticCollisionGrid.h"
 
 #include <mutex>
 #include <Ogre.h>
@@ -62,43 +63,37 @@ private:
     /// Static collision object lookup system
     /// -------------------------------------
     /// Terrain is split into equal-size 'cells' of dimension CELL_SIZE, identified by CellID
-    /// A hash table aggregates elements from multiple cells in one entry
-    struct hash_coll_element_t
-    {
-        static const int ELEMENT_TRI_BASE_INDEX = 1000000; // Effectively a maximum number of collision boxes
-
-        inline hash_coll_element_t(unsigned int cell_id_, int value): cell_id(cell_id_), element_index(value) {}
-
-        inline bool IsCollisionBox() const { return element_index < ELEMENT_TRI_BASE_INDEX; }
-        inline bool IsCollisionTri() const { return element_index >= ELEMENT_TRI_BASE_INDEX; }
+    /// Each cell lists its elements in the StaticCollisionGrid (m_collision_grid):
+    ///    values below ELEMENT_TRI_BASE_INDEX are collision box indices (Collisions::m_collision_boxes),
+    ///    values above are collision tri indices (Collisions::m_collision_tris).
+    static const int ELEMENT_TRI_BASE_INDEX = 1000000; // Effectively a maximum number of collision boxes
 
-        unsigned int cell_id;
-
-        /// Values below ELEMENT_TRI_BASE_INDEX are collision box indices (Collisions::m_collision_boxes),
-        ///    values above are collision tri indices (Collisions::m_collision_tris).
-        int element_index;
-    };
+    static inline bool IsCollisionBox(int element) { return element < ELEMENT_TRI_BASE_INDEX; }
+    static inline unsigned int GetCellID(int cell_x, int cell_z) { return (cell_x << 16) + cell_z; }
 
     struct collision_tri_t
     {
         Ogre::Vector3 a;
+        Ogre::Matrix3 forward;
         Ogre::Vector3 b;
         Ogre::Vector3 c;
         Ogre::AxisAlignedBox aab;
-        Ogre::Matrix3 forward;
         Ogre::Matrix3 reverse;
         ground_model_t* gm;
         bool enabled;
     };
 
+    /// Tightly packed tri bounds for the per-node tests, indexed like `m_collision_tris`
+    struct collision_tri_bounds_t
+    {
+        float lo[3];
+        float hi[3];
+    };
+
     static const int LATEST_GROUND_MODEL_VERSION = 3;
     static const int MAX_EVENT_SOURCE = 500;
 
-    // this is a power of two, change with caution
-    static const int HASH_POWER = 20;
-    static const int HASH_SIZE = 1 << HASH_POWER;
-
-    // how many elements per cell? power of 2 minus 2 is better
+    // how many elements per cell are considered crowded (debug visualization)
     static const int CELL_BLOCKSIZE = 126;
 
     // terrain size is limited to 327km x 327km:
@@ -111,12 +106,12 @@ private:
 
     // collision tris pool;
     std::vector<collision_tri_t> m_collision_tris; // Formerly MAX_COLLISION_TRIS = 100000
+    std::vector<collision_tri_bounds_t> m_collision_tri_bounds;
 
     Ogre::AxisAlignedBox m_collision_aab; // Tight bounding box around all collision meshes
 
-    // collision hashtable
-    Ogre::Real hashtable_height[HASH_SIZE];
-    std::vector<hash_coll_element_t> hashtable[HASH_SIZE];
+    // collision lookup
+    StaticCollisionGrid m_collision_grid;
 
     // ground models
     std::map<Ogre::String, ground_model_t> ground_models;
@@ -134,19 +129,19 @@ private:
     int collision_version;
     inline int GetNumCollisionTris() const { return static_cast<int>(m_collision_tris.size()); }
     inline int GetNumCollisionBoxes() const { return static_cast<int>(m_collision_boxes.size()); }
-    unsigned int hashmask;
 
     const Ogre::Vector3 m_terrain_size;
 
-    void hash_add(int cell_x, int cell_z, int value, float h);
-    int hash_find(int cell_x, int cell_z); /// Returns index to 'hashtable'
-    unsigned int hashfunc(unsigned int cellid);
+    void grid_add(const Ogre::Vector3& lo, const Ogre::Vector3& hi, int value);
+    void grid_remove(const Ogre::Vector3& lo, const Ogre::Vector3& hi, int value);
     void parseGroundConfig(Ogre::ConfigFile* cfg, Ogre::String groundModel = "");
 
     Ogre::Vector3 calcCollidedSide(const Ogre::Vector3& pos, const Ogre::Vector3& lo, const Ogre::Vector3& hi);
 
 public:
 
+    static const int GROUND_BATCH_SIZE = 256;
+
     std::mutex m_scriptcallback_mutex;
 
     bool forcecam;
@@ -163,6 +158,9 @@ public:
     float getSurfaceHeightBelow(float x, float z, float height);
     bool collisionCorrect(Ogre::Vector3* refpos, bool envokeScriptCallbacks = true);
     bool groundCollision(node_t* node, float dt);
+    /// Batched groundCollision() for up to GROUND_BATCH_SIZE consecutive nodes; thread-safe.
+    /// Nodes with `nd_no_ground_contact` are skipped; `contacted[i]` receives the result for `nodes[i]`.
+    void groundCollisionBatch(node_t* nodes, int count, float dt, bool* contacted);
     bool isInside(Ogre::Vector3 pos, const Ogre::String& inst, const Ogre::String& box, float border = 0);
     bool isInside(Ogre::Vector3 pos, collision_box_t* cbox, float border = 0);
     bool nodeCollision(node_t* node, float dt, bool envokeScriptCallbacks = true);
@@ -120,6 +120,8 @@ void RoR::ResolveInterActorCollisions(const float dt, PointColDetector &interPoi
         const float collrange,
         ground_model_t &submesh_ground_model)
 {
+    // Gather the cabs due for a check this step and query them all in one tree traversal
+    interPointCD.BeginBatchQuery(free_collcab);
     for (int i=0; i<free_collcab; i++)
     {
         if (inter_collcabrate[i].rate > 0)
@@ -131,23 +133,34 @@ void RoR::ResolveInterActorCollisions(const float dt, PointColDetector &interPoi
         inter_collcabrate[i].rate = std::min(inter_collcabrate[i].distance, 12);
         inter_collcabrate[i].distance = 0;
 
+        int tmpv = collcabs[i]*3;
+        interPointCD.SetBatchQuery(i, nodes[cabs[tmpv]].AbsPosition
+                , nodes[cabs[tmpv+1]].AbsPosition
+                , nodes[cabs[tmpv+2]].AbsPosition, collrange);
+    }
+    interPointCD.RunBatchQuery();
+
+    for (int i=0; i<free_collcab; i++)
+    {
+        if (!interPointCD.IsBatchQueryActive(i))
+            continue;
+
         int tmpv = collcabs[i]*3;
         const auto no = &nodes[cabs[tmpv]];
         const auto na = &nodes[cabs[tmpv+1]];
         const auto nb = &nodes[cabs[tmpv+2]];
 
-        interPointCD.query(no->AbsPosition
-                , na->AbsPosition
-                , nb->AbsPosition, collrange);
-
-        if (!interPointCD.hit_list.empty())
+        const int hits_begin = interPointCD.batch_hit_offsets[i];
+        const int hits_end = interPointCD.batch_hit_offsets[i + 1];
+        if (hits_begin != hits_end)
         {
             // setup transformation of points to triangle local coordinates
             const Triangle triangle(na->AbsPosition, nb->AbsPosition, no->AbsPosition);
             const CartesianToTriangleTransform transform(triangle);
 
-            for (auto h : interPointCD.hit_list)
+            for (int hit = hits_begin; hit < hits_end; ++hit)
             {
+                const auto h = interPointCD.batch_hit_list[hit];
                 const auto hit_actor = h->actor;
                 const auto hitnode = &hit_actor->ar_nodes[h->node_id];
 
@@ -203,6 +216,8 @@ void RoR::ResolveIntraActorCollisions(const float dt, PointColDetector &intraPoi
         const float collrange,
         ground_model_t &submesh_ground_model)
 {
+    // Gather the cabs due for a check this step and query them all in one tree traversal
+    intraPointCD.BeginBatchQuery(free_collcab);
     for (int i=0; i<free_collcab; i++)
     {
         if (intra_collcabrate[i].rate > 0)
@@ -217,25 +232,36 @@ void RoR::ResolveIntraActorCollisions(const float dt, PointColDetector &intraPoi
             intra_collcabrate[i].distance = 0;
         }
 
+        int tmpv = collcabs[i]*3;
+        intraPointCD.SetBatchQuery(i, nodes[cabs[tmpv]].AbsPosition
+                , nodes[cabs[tmpv+1]].AbsPosition
+                , nodes[cabs[tmpv+2]].AbsPosition, collrange);
+    }
+    intraPointCD.RunBatchQuery();
+
+    for (int i=0; i<free_collcab; i++)
+    {
+        if (!intraPointCD.IsBatchQueryActive(i))
+            continue;
+
         int tmpv = collcabs[i]*3;
         const auto no = &nodes[cabs[tmpv]];
         const auto na = &nodes[cabs[tmpv+1]];
         const auto nb = &nodes[cabs[tmpv+2]];
 
-        intraPointCD.query(no->AbsPosition
-                , na->AbsPosition
-                , nb->AbsPosition, collrange);
-
         bool collision = false;
 
-        if (!intraPointCD.hit_list.empty())
+        const int hits_begin = intraPointCD.batch_hit_offsets[i];
+        const int hits_end = intraPointCD.batch_hit_offsets[i + 1];
+        if (hits_begin != hits_end)
         {
             // setup transformation of points to triangle local coordinates
             const Triangle triangle(na->AbsPosition, nb->AbsPosition, no->AbsPosition);
             const CartesianToTriangleTransform transform(triangle);
 
-            for (auto h : intraPointCD.hit_list)
+            for (int hit = hits_begin; hit < hits_end; ++hit)
             {
+                const auto h = intraPointCD.batch_hit_list[hit];
                 const auto hitnode = &nodes[h->node_id];
 
                 //ignore wheel/chassis self contact
@@ -24,6 +24,8 @@
 #include "ActorManager.h"
 #include "GameContext.h"
 
+#include <algorithm>
+
 using namespace Ogre;
 using namespace RoR;
 
@@ -38,24 +40,38 @@ void PointColDetector::UpdateIntraPoint(bool contactables)
         update_structures_for_contacters(contactables);
     }
 
-    m_kdtree[0].ref = NULL;
-    m_kdtree[0].begin = 0;
-    m_kdtree[0].end = -m_object_list_size;
+    this->update_kdtree();
 }
 
 void PointColDetector::UpdateInterPoint(bool ignorestate)
 {
     m_linked_actors = m_actor->GetAllLinkedActors();
+    std::sort(m_linked_actors.begin(), m_linked_actors.end());
+
+    // Candidates from the per-step broadphase; outside of the physics step (i.e. spawn
+    // placement, `ignorestate`) the broadphase may be stale, so all actors are tested.
+    ActorManager* actor_mgr = App::GetGameContext()->GetActorManager();
+    if (ignorestate || !actor_mgr->GetInterActorBroadphase().QueryActor(m_actor, m_candidates))
+    {
+        m_candidates.clear();
+        for (auto actor : actor_mgr->GetActors())
+        {
+            if (actor != m_actor && m_actor->ar_bounding_box.intersects(actor->ar_bounding_box))
+            {
+                m_candidates.push_back(actor);
+            }
+        }
+    }
 
     int contacters_size = 0;
-    std::vector<Actor*> collision_partners;
-    for (auto actor : App::GetGameContext()->GetActorManager()->GetActors())
+    std::vector<Actor*>& collision_partners = m_candidates_filtered;
+    collision_partners.clear();
+    for (auto actor : m_candidates)
     {
-        if (actor != m_actor && (ignorestate || actor->ar_update_physics) &&
-                m_actor->ar_bounding_box.intersects(actor->ar_bounding_box))
+        if (ignorestate || actor->ar_update_physics)
         {
             collision_partners.push_back(actor);
-            bool is_linked = std::find(m_linked_actors.begin(), m_linked_actors.end(), actor) != m_linked_actors.end();
+            bool is_linked = std::binary_search(m_linked_actors.begin(), m_linked_actors.end(), actor);
             contacters_size += is_linked ? actor->ar_num_contacters : actor->ar_num_contactable_nodes;
             if (m_actor->ar_nodes[0].Velocity.squaredDistance(actor->ar_nodes[0].Velocity) > 16)
             {
@@ -82,9 +98,7 @@ void PointColDetector::UpdateInterPoint(bool ignorestate)
         update_structures_for_contacters(false);
     }
 
-    m_kdtree[0].ref = NULL;
-    m_kdtree[0].begin = 0;
-    m_kdtree[0].end = -m_object_list_size;
+    this->update_kdtree();
 }
 
 void PointColDetector::update_structures_for_contacters(bool ignoreinternal)
@@ -96,7 +110,7 @@ void PointColDetector::update_structures_for_contacters(bool ignoreinternal)
     int refi = 0;
     for (auto actor : m_collision_partners)
     {
-        bool is_linked = std::find(m_linked_actors.begin(), m_linked_actors.end(), actor) != m_linked_actors.end();
+        bool is_linked = std::binary_search(m_linked_actors.begin(), m_linked_actors.end(), actor);
         bool internal_collision = !ignoreinternal && ((actor == m_actor) || is_linked);
         for (int i = 0; i < actor->ar_num_nodes; i++)
         {
@@ -112,218 +126,218 @@ void PointColDetector::update_structures_for_contacters(bool ignoreinternal)
     }
 
     m_kdtree.resize(std::max(1.0, std::pow(2, std::ceil(std::log2(m_object_list_size)) + 1)));
+    m_needs_rebuild = true;
 }
 
-void PointColDetector::query(const Vector3 &vec1, const Vector3 &vec2, const Vector3 &vec3, float enlargeBB)
+void PointColDetector::update_kdtree()
 {
-    m_bbmin = vec1;
-
-    m_bbmin.x = std::min(vec2.x, m_bbmin.x);
-    m_bbmin.x = std::min(vec3.x, m_bbmin.x);
-
-    m_bbmin.y = std::min(vec2.y, m_bbmin.y);
-    m_bbmin.y = std::min(vec3.y, m_bbmin.y);
-
-    m_bbmin.z = std::min(vec2.z, m_bbmin.z);
-    m_bbmin.z = std::min(vec3.z, m_bbmin.z);
-
-    m_bbmin -= enlargeBB;
-
-    m_bbmax = vec1;
-
-    m_bbmax.x = std::max(m_bbmax.x, vec2.x);
-    m_bbmax.x = std::max(m_bbmax.x, vec3.x);
-
-    m_bbmax.y = std::max(m_bbmax.y, vec2.y);
-    m_bbmax.y = std::max(m_bbmax.y, vec3.y);
-
-    m_bbmax.z = std::max(m_bbmax.z, vec2.z);
-    m_bbmax.z = std::max(m_bbmax.z, vec3.z);
-
-    m_bbmax += enlargeBB;
-
-    hit_list.clear();
-    queryrec(0, 0);
-}
+    if (!m_needs_rebuild)
+    {
+        // Nodes only moved a bit since last step; keep the tree, update the boxes
+        const float cost = this->refit_kdtree();
+        m_needs_rebuild = (cost > REBUILD_COST_RATIO * m_built_cost + 1.f);
+    }
 
-void PointColDetector::queryrec(int kdindex, int axis)
-{
-    for (;;)
+    if (m_needs_rebuild)
     {
-        if (m_kdtree[kdindex].end < 0)
+        for (kdnode_t& node : m_kdtree)
         {
-            build_kdtree_incr(axis, kdindex);
+            node.ref = NULL;
+            node.begin = 0;
+            node.end = 0;
         }
-
-        if (m_kdtree[kdindex].ref != NULL)
+        if (m_object_list_size > 0)
         {
-            const float *point = m_kdtree[kdindex].ref->point;
-            if (point[0] >= m_bbmin.x && point[0] <= m_bbmax.x &&
-                point[1] >= m_bbmin.y && point[1] <= m_bbmax.y &&
-                point[2] >= m_bbmin.z && point[2] <= m_bbmax.z)
-            {
-                hit_list.push_back(m_kdtree[kdindex].ref->pidref);
-            }
-            return;
+            this->build_kdtree(0, 0, m_object_list_size, 0);
         }
+        m_built_cost = this->refit_kdtree();
+        m_needs_rebuild = false;
+    }
+}
 
-        if (m_bbmax[axis] >= m_kdtree[kdindex].middle)
-        {
-            if (m_bbmin[axis] > m_kdtree[kdindex].max)
-            {
-                return;
-            }
+void PointColDetector::build_kdtree(int index, int begin, int end, int axis)
+{
+    kdnode_t& node = m_kdtree[index];
+    node.begin = begin;
+    node.end = end;
+    if (end - begin == 1)
+    {
+        node.ref = &m_ref_list[begin];
+        return;
+    }
 
-            int newaxis = axis + 1;
+    node.ref = NULL;
+    const int median = begin + (end - begin) / 2;
+    std::nth_element(m_ref_list.begin() + begin, m_ref_list.begin() + median, m_ref_list.begin() + end,
+        [axis](const refelem_t& a, const refelem_t& b) { return a.point[axis] < b.point[axis]; });
 
-            if (newaxis >= 3)
-            {
-                newaxis = 0;
-            }
+    const int next_axis = (axis + 1) % 3;
+    this->build_kdtree(2 * index + 1, begin, median, next_axis);
+    this->build_kdtree(2 * index + 2, median, end, next_axis);
+}
 
-            int newindex = kdindex + kdindex + 1;
+float PointColDetector::refit_kdtree()
+{
+    // Children always have higher indices than their parent, so a reverse sweep is bottom-up
+    float cost = 0.f;
+    for (int i = static_cast<int>(m_kdtree.size()) - 1; i >= 0; --i)
+    {
+        kdnode_t& node = m_kdtree[i];
+        if (node.end <= node.begin)
+            continue;
 
-            if (m_bbmin[axis] <= m_kdtree[kdindex].middle)
+        if (node.ref != NULL)
+        {
+            for (int axis = 0; axis < 3; ++axis)
             {
-                queryrec(newindex, newaxis);
+                node.bbmin[axis] = node.ref->point[axis];
+                node.bbmax[axis] = node.ref->point[axis];
             }
-
-            kdindex = newindex + 1;
-            axis = newaxis;
         }
         else
         {
-            if (m_bbmax[axis] < m_kdtree[kdindex].min)
+            const kdnode_t& left = m_kdtree[2 * i + 1];
+            const kdnode_t& right = m_kdtree[2 * i + 2];
+            for (int axis = 0; axis < 3; ++axis)
             {
-                return;
-            }
-
-            kdindex = 2 * kdindex + 1;
-            axis++;
-
-            if (axis >= 3)
-            {
-                axis = 0;
+                node.bbmin[axis] = std::min(left.bbmin[axis], right.bbmin[axis]);
+                node.bbmax[axis] = std::max(left.bbmax[axis], right.bbmax[axis]);
+                cost += node.bbmax[axis] - node.bbmin[axis];
             }
         }
     }
+    return cost;
 }
 
-void PointColDetector::build_kdtree_incr(int axis, int index)
+void PointColDetector::query(const Vector3 &vec1, const Vector3 &vec2, const Vector3 &vec3, float enlargeBB)
 {
-    int end = -m_kdtree[index].end;
-    m_kdtree[index].end = end;
-    int begin = m_kdtree[index].begin;
-    int median;
-    int slice_size = end - begin;
-    if (slice_size != 1)
+    m_bbmin = vec1;
+    m_bbmin.makeFloor(vec2);
+    m_bbmin.makeFloor(vec3);
+    m_bbmin -= enlargeBB;
+
+    m_bbmax = vec1;
+    m_bbmax.makeCeil(vec2);
+    m_bbmax.makeCeil(vec3);
+    m_bbmax += enlargeBB;
+
+    hit_list.clear();
+    if (m_kdtree[0].end > m_kdtree[0].begin)
     {
-        int newindex=index+index+1;
-        if (slice_size == 2)
-        {
-            median = begin+1;
-            if (m_ref_list[begin].point[axis] > m_ref_list[median].point[axis])
-            {
-                std::swap(m_ref_list[begin], m_ref_list[median]);
-            }
+        this->queryrec(0);
+    }
+}
 
-            m_kdtree[index].min = m_ref_list[begin].point[axis];
-            m_kdtree[index].max = m_ref_list[median].point[axis];
-            m_kdtree[index].middle = m_kdtree[index].max;
-            m_kdtree[index].ref = NULL;
+void PointColDetector::queryrec(int kdindex)
+{
+    const kdnode_t& node = m_kdtree[kdindex];
+    if (node.bbmax[0] < m_bbmin.x || node.bbmin[0] > m_bbmax.x ||
+        node.bbmax[1] < m_bbmin.y || node.bbmin[1] > m_bbmax.y ||
+        node.bbmax[2] < m_bbmin.z || node.bbmin[2] > m_bbmax.z)
+    {
+        return;
+    }
 
-            axis++;
-            if (axis >= 3)
-            {
-                axis = 0;
-            }
+    if (node.ref != NULL)
+    {
+        hit_list.push_back(node.ref->pidref);
+        return;
+    }
 
-            m_kdtree[newindex].ref = &m_ref_list[begin];
-            m_kdtree[newindex].middle = m_kdtree[newindex].ref->point[axis];
-            m_kdtree[newindex].min = m_kdtree[newindex].middle;
-            m_kdtree[newindex].max = m_kdtree[newindex].middle;
-            m_kdtree[newindex].end = median;
-            newindex++;
-
-            m_kdtree[newindex].ref = &m_ref_list[median];
-            m_kdtree[newindex].middle = m_kdtree[newindex].ref->point[axis];
-            m_kdtree[newindex].min = m_kdtree[newindex].middle;
-            m_kdtree[newindex].max = m_kdtree[newindex].middle;
-            m_kdtree[newindex].end = end;
-            return;
-        }
-        else
-        {
-            median = begin + (slice_size / 2);
-            partintwo(begin, median, end, axis, m_kdtree[index].min, m_kdtree[index].max);
-        }
+    this->queryrec(2 * kdindex + 1);
+    this->queryrec(2 * kdindex + 2);
+}
 
-        m_kdtree[index].middle = m_ref_list[median].point[axis];
-        m_kdtree[index].ref = NULL;
+void PointColDetector::BeginBatchQuery(int num_queries)
+{
+    m_batch_queries.resize(num_queries);
+    for (querybox_t& q : m_batch_queries)
+    {
+        q.active = false;
+    }
+}
 
-        m_kdtree[newindex].begin = begin;
-        m_kdtree[newindex].end = -median;
+void PointColDetector::SetBatchQuery(int index, const Vector3 &vec1, const Vector3 &vec2, const Vector3 &vec3, float enlargeBB)
+{
+    querybox_t& q = m_batch_queries[index];
+    q.bbmin = vec1;
+    q.bbmin.makeFloor(vec2);
+    q.bbmin.makeFloor(vec3);
+    q.bbmin -= enlargeBB;
+    q.bbmax = vec1;
+    q.bbmax.makeCeil(vec2);
+    q.bbmax.makeCeil(vec3);
+    q.bbmax += enlargeBB;
+    q.active = true;
+}
 
-        newindex++;
-        m_kdtree[newindex].begin = median;
-        m_kdtree[newindex].end = -end;
+void PointColDetector::RunBatchQuery()
+{
+    m_batch_pairs.clear();
+    m_batch_active.clear();
+    for (int q = 0; q < static_cast<int>(m_batch_queries.size()); ++q)
+    {
+        if (m_batch_queries[q].active)
+        {
+            m_batch_active.push_back(q);
+        }
+    }
+    if (m_kdtree[0].end > m_kdtree[0].begin)
+    {
+        this->batchqueryrec(0, 0, static_cast<int>(m_batch_active.size()));
+    }
 
+    // Group hits by query, keeping the traversal order (same as `query()`)
+    batch_hit_offsets.assign(m_batch_queries.size() + 1, 0);
+    for (auto& pair : m_batch_pairs)
+    {
+        batch_hit_offsets[pair.first + 1]++;
     }
-    else
+    for (size_t q = 1; q < batch_hit_offsets.size(); ++q)
     {
-        m_kdtree[index].ref = &m_ref_list[begin];
-        m_kdtree[index].middle = m_kdtree[index].ref->point[axis];
-        m_kdtree[index].min = m_kdtree[index].middle;
-        m_kdtree[index].max = m_kdtree[index].middle;
+        batch_hit_offsets[q] += batch_hit_offsets[q - 1];
+    }
+    batch_hit_list.resize(m_batch_pairs.size());
+    m_batch_active.assign(batch_hit_offsets.begin(), batch_hit_offsets.end() - 1); // Reused as write cursors
+    for (auto& pair : m_batch_pairs)
+    {
+        batch_hit_list[m_batch_active[pair.first]++] = pair.second;
     }
 }
 
-void PointColDetector::partintwo(const int start, const int median, const int end, const int axis, float &minex, float &maxex)
+void PointColDetector::batchqueryrec(int kdindex, int active_begin, int active_end)
 {
-    int i, j, l, m;
-    int k = median;
-    l = start;
-    m = end - 1;
+    // Narrow down the parent's queries to those overlapping this node
+    const kdnode_t& node = m_kdtree[kdindex];
+    const int first = static_cast<int>(m_batch_active.size());
+    for (int a = active_begin; a < active_end; ++a)
+    {
+        const int q = m_batch_active[a];
+        const querybox_t& box = m_batch_queries[q];
+        if (node.bbmax[0] >= box.bbmin.x && node.bbmin[0] <= box.bbmax.x &&
+            node.bbmax[1] >= box.bbmin.y && node.bbmin[1] <= box.bbmax.y &&
+            node.bbmax[2] >= box.bbmin.z && node.bbmin[2] <= box.bbmax.z)
+        {
+            m_batch_active.push_back(q);
+        }
+    }
+    const int last = static_cast<int>(m_batch_active.size());
 
-    float x = m_ref_list[k].point[axis];
-    while (l < m)
+    if (first != last)
     {
-        i = l;
-        j = m;
-        while (!(j < k || k < i))
+        if (node.ref != NULL)
         {
-            while (m_ref_list[i].point[axis] < x)
+            for (int a = first; a < last; ++a)
             {
-                i++;
+                m_batch_pairs.push_back(std::make_pair(m_batch_active[a], node.ref->pidref));
             }
-            while (x < m_ref_list[j].point[axis])
-            {
-                j--;
-            }
-
-            std::swap(m_ref_list[i], m_ref_list[j]);
-            i++;
-            j--;
         }
-        if (j < k)
-        {
-            l = i;
-        }
-        if (k < i)
+        else
         {
-            m = j;
+            this->batchqueryrec(2 * kdindex + 1, first, last);
+            this->batchqueryrec(2 * kdindex + 2, first, last);
         }
-        x = m_ref_list[k].point[axis];
     }
 
-    minex = x;
-    maxex = x;
-    for (int i = start; i < median; ++i)
-    {
-        minex = std::min(m_ref_list[i].point[axis], minex);
-    }
-    for (int i = median+1; i < end; ++i)
-    {
-        maxex = std::max(maxex, m_ref_list[i].point[axis]);
-    }
+    m_batch_active.resize(first);
 }
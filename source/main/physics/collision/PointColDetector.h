@@ -23,6 +23,10 @@
 
 namespace RoR {
 
+/// Finds contacter/contactable nodes within triangle bounding boxes.
+/// The points are kept in a kd-ordered tree of bounding boxes. Between steps the boxes are
+/// only refitted to the new node positions; the tree is rebuilt when the point set changes
+/// or when the refitted boxes grew too loose.
 class PointColDetector : public ZeroedMemoryAllocator
 {
 public:
@@ -33,7 +37,11 @@ public:
         short node_id;
     };
 
+    static constexpr float REBUILD_COST_RATIO = 1.5f; //!< Rebuild when refitted boxes are this much larger than freshly built ones
+
     std::vector<pointid_t*> hit_list;
+    std::vector<pointid_t*> batch_hit_list;    //!< Hits of batch query `i` are [batch_hit_offsets[i], batch_hit_offsets[i+1])
+    std::vector<int>        batch_hit_offsets;
 
     PointColDetector(Actor* actor): m_actor(actor), m_object_list_size(-1) {};
 
@@ -41,6 +49,12 @@ public:
     void UpdateInterPoint(bool ignorestate = false);
     void query(const Ogre::Vector3& vec1, const Ogre::Vector3& vec2, const Ogre::Vector3& vec3, const float enlargeBB);
 
+    // Batched queries - all triangles in a single tree traversal
+    void BeginBatchQuery(int num_queries); //!< All queries start inactive (no hits)
+    void SetBatchQuery(int index, const Ogre::Vector3& vec1, const Ogre::Vector3& vec2, const Ogre::Vector3& vec3, const float enlargeBB);
+    bool IsBatchQueryActive(int index) const { return m_batch_queries[index].active; }
+    void RunBatchQuery();
+
 private:
 
     struct refelem_t
@@ -51,27 +65,43 @@ private:
 
     struct kdnode_t
     {
-        float min;
+        float bbmin[3];
+        float bbmax[3];
+        refelem_t* ref; //!< Leaf nodes only
+        int begin;      //!< Range in `m_ref_list`; empty for unused slots
         int end;
-        float max;
-        refelem_t* ref;
-        float middle;
-        int begin;
+    };
+
+    struct querybox_t
+    {
+        Ogre::Vector3 bbmin;
+        Ogre::Vector3 bbmax;
+        bool active;
     };
 
     Actor*                 m_actor;
     std::vector<Actor*>    m_linked_actors;
     std::vector<Actor*>    m_collision_partners;
+    std::vector<Actor*>    m_candidates;           //!< Broadphase result, reused between steps
+    std::vector<Actor*>    m_candidates_filtered;
     std::vector<refelem_t> m_ref_list;
     std::vector<pointid_t> m_pointid_list;
     std::vector<kdnode_t>  m_kdtree;
     Ogre::Vector3          m_bbmin;
     Ogre::Vector3          m_bbmax;
     int                    m_object_list_size;
-
-    void queryrec(int kdindex, int axis);
-    void build_kdtree_incr(int axis, int index);
-    void partintwo(const int start, const int median, const int end, const int axis, float& minex, float& maxex);
+    bool                   m_needs_rebuild = true;
+    float                  m_built_cost = 0.f;     //!< Sum of inner box sizes right after the last rebuild
+
+    std::vector<querybox_t>                     m_batch_queries;
+    std::vector<int>                            m_batch_active;  //!< Stack of query index lists, one per tree level
+    std::vector<std::pair<int, pointid_t*>>     m_batch_pairs;   //!< (query, hit) in traversal order
+
+    void queryrec(int kdindex);
+    void batchqueryrec(int kdindex, int active_begin, int active_end);
+    void build_kdtree(int index, int begin, int end, int axis);
+    float refit_kdtree();
+    void update_kdtree();
     void update_structures_for_contacters(bool ignoreinternal);
 };
 
@@ -0,0 +1,201 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "StaticCollisionGrid.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace RoR;
+
+namespace {
+
+const size_t   INITIAL_SLOTS = 1024;
+const uint16_t MIN_CAPACITY  = 4;
+
+} // namespace
+
+StaticCollisionGrid::StaticCollisionGrid()
+{
+    this->Rehash(INITIAL_SLOTS);
+}
+
+bool StaticCollisionGrid::Add(uint32_t cell_id, int element, float height)
+{
+    Cell& cell = this->FindOrInsert(cell_id);
+    if (cell.count == std::numeric_limits<uint16_t>::max())
+        return false;
+
+    if (cell.count == cell.capacity)
+    {
+        // Relocate the range to the end of the pool; the old one is reclaimed by Compact()
+        const uint32_t new_begin = static_cast<uint32_t>(m_elements.size());
+        const int new_capacity = std::min<int>(std::max<int>(cell.capacity * 2, MIN_CAPACITY), std::numeric_limits<uint16_t>::max());
+        m_elements.resize(new_begin + new_capacity);
+        m_element_heights.resize(new_begin + new_capacity);
+        std::copy(m_elements.begin() + cell.begin, m_elements.begin() + cell.begin + cell.count, m_elements.begin() + new_begin);
+        std::copy(m_element_heights.begin() + cell.begin, m_element_heights.begin() + cell.begin + cell.count, m_element_heights.begin() + new_begin);
+        cell.begin = new_begin;
+        cell.capacity = static_cast<uint16_t>(new_capacity);
+    }
+
+    m_elements[cell.begin + cell.count] = element;
+    m_element_heights[cell.begin + cell.count] = height;
+    cell.count++;
+    cell.max_height = std::max(cell.max_height, height);
+    return true;
+}
+
+void StaticCollisionGrid::Remove(uint32_t cell_id, int element)
+{
+    Cell* cell = const_cast<Cell*>(this->Find(cell_id));
+    if (cell == nullptr)
+        return;
+
+    // Shift the rest of the range to keep the insertion order
+    int* elements = m_elements.data() + cell->begin;
+    float* heights = m_element_heights.data() + cell->begin;
+    int* found = std::find(elements, elements + cell->count, element);
+    if (found == elements + cell->count)
+        return;
+
+    const size_t pos = found - elements;
+    std::copy(elements + pos + 1, elements + cell->count, elements + pos);
+    std::copy(heights + pos + 1, heights + cell->count, heights + pos);
+    cell->count--;
+    this->UpdateMaxHeight(*cell);
+}
+
+void StaticCollisionGrid::Compact()
+{
+    // Cells in id order (x-major), ranges back-to-back without spare capacity
+    std::vector<Cell*> cells;
+    cells.reserve(m_num_cells);
+    for (Cell& cell : m_slots)
+    {
+        if (cell.cell_id != EMPTY_CELL)
+        {
+            cells.push_back(&cell);
+        }
+    }
+    std::sort(cells.begin(), cells.end(), [](const Cell* a, const Cell* b) { return a->cell_id < b->cell_id; });
+
+    std::vector<int> elements;
+    std::vector<float> heights;
+    elements.reserve(this->GetNumElements());
+    heights.reserve(this->GetNumElements());
+    for (Cell* cell : cells)
+    {
+        const uint32_t begin = static_cast<uint32_t>(elements.size());
+        elements.insert(elements.end(), m_elements.begin() + cell->begin, m_elements.begin() + cell->begin + cell->count);
+        heights.insert(heights.end(), m_element_heights.begin() + cell->begin, m_element_heights.begin() + cell->begin + cell->count);
+        cell->begin = begin;
+        cell->capacity = cell->count;
+    }
+    m_elements.swap(elements);
+    m_element_heights.swap(heights);
+}
+
+size_t StaticCollisionGrid::GetNumElements() const
+{
+    size_t num_elements = 0;
+    for (const Cell& cell : m_slots)
+    {
+        if (cell.cell_id != EMPTY_CELL)
+        {
+            num_elements += cell.count;
+        }
+    }
+    return num_elements;
+}
+
+size_t StaticCollisionGrid::GetMemoryUsage() const
+{
+    return m_slots.capacity() * sizeof(Cell)
+        + m_elements.capacity() * sizeof(int)
+        + m_element_heights.capacity() * sizeof(float);
+}
+
+StaticCollisionGrid::Cell& StaticCollisionGrid::FindOrInsert(uint32_t cell_id)
+{
+    // Keep the load factor under 1/2, so that lookups of empty cells terminate quickly
+    if ((m_num_cells + 1) * 2 > m_slots.size())
+    {
+        this->Rehash(m_slots.size() * 2);
+    }
+
+    uint32_t slot = this->Hash(cell_id);
+    while (m_slots[slot].cell_id != cell_id)
+    {
+        if (m_slots[slot].cell_id == EMPTY_CELL)
+        {
+            Cell& cell = m_slots[slot];
+            cell.cell_id = cell_id;
+            cell.begin = 0;
+            cell.count = 0;
+            cell.capacity = 0;
+            cell.max_height = -std::numeric_limits<float>::max();
+            m_num_cells++;
+            return cell;
+        }
+        slot = (slot + 1) & m_slot_mask;
+    }
+    return m_slots[slot];
+}
+
+void StaticCollisionGrid::Rehash(size_t num_slots)
+{
+    Cell empty;
+    empty.cell_id = EMPTY_CELL;
+    empty.begin = 0;
+    empty.count = 0;
+    empty.capacity = 0;
+    empty.max_height = -std::numeric_limits<float>::max();
+
+    std::vector<Cell> old_slots(num_slots, empty);
+    old_slots.swap(m_slots);
+    m_slot_mask = static_cast<uint32_t>(num_slots - 1);
+    m_slot_shift = 32;
+    for (size_t n = num_slots; n > 1; n >>= 1) // `num_slots` is a power of two
+    {
+        m_slot_shift--;
+    }
+
+    for (const Cell& cell : old_slots)
+    {
+        if (cell.cell_id != EMPTY_CELL)
+        {
+            uint32_t slot = this->Hash(cell.cell_id);
+            while (m_slots[slot].cell_id != EMPTY_CELL)
+            {
+                slot = (slot + 1) & m_slot_mask;
+            }
+            m_slots[slot] = cell;
+        }
+    }
+}
+
+void StaticCollisionGrid::UpdateMaxHeight(Cell& cell)
+{
+    cell.max_height = -std::numeric_limits<float>::max();
+    for (uint32_t i = cell.begin; i < cell.begin + cell.count; ++i)
+    {
+        cell.max_height = std::max(cell.max_height, m_element_heights[i]);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RoR {
+
+/// Lookup table of static collision elements (boxes, tris) by terrain cell, see `Collisions`.
+///
+/// Cells live in an open-addressing table (4 per cache line), each pointing to a contiguous
+/// range of element indices in a shared pool (CSR layout). While the terrain loads, ranges
+/// grow by relocating to the end of the pool; Compact() then packs them back-to-back in cell
+/// order, so that neighbouring cells are also neighbours in memory.
+class StaticCollisionGrid
+{
+public:
+    struct Cell
+    {
+        uint32_t cell_id;
+        uint32_t begin;      //!< First element in the pool
+        uint16_t count;
+        uint16_t capacity;
+        float    max_height; //!< Top of the highest element in the cell
+    };
+
+    static const uint32_t EMPTY_CELL = 0xFFFFFFFF;
+
+    StaticCollisionGrid();
+
+    bool        Add(uint32_t cell_id, int element, float height);   //!< Returns false if the cell is full
+    void        Remove(uint32_t cell_id, int element);
+    void        Compact();
+
+    /// Returns nullptr if no element was ever added to the cell.
+    inline const Cell* Find(uint32_t cell_id) const
+    {
+        uint32_t slot = this->Hash(cell_id);
+        for (;;)
+        {
+            const Cell& cell = m_slots[slot];
+            if (cell.cell_id == cell_id)
+                return &cell;
+            if (cell.cell_id == EMPTY_CELL)
+                return nullptr;
+            slot = (slot + 1) & m_slot_mask;
+        }
+    }
+
+    inline const int* GetElements(const Cell& cell) const { return m_elements.data() + cell.begin; }
+
+    size_t      GetNumCells() const { return m_num_cells; }
+    size_t      GetNumElements() const;
+    size_t      GetMemoryUsage() const; //!< Bytes
+
+private:
+    /// Fibonacci hashing: the top log2(slot count) bits of the product are the best mixed ones.
+    inline uint32_t Hash(uint32_t cell_id) const { return (cell_id * 2654435761u) >> m_slot_shift; }
+
+    Cell&       FindOrInsert(uint32_t cell_id);
+    void        Rehash(size_t num_slots);
+    void        UpdateMaxHeight(Cell& cell);
+
+    std::vector<Cell>   m_slots;
+    uint32_t            m_slot_mask = 0;
+    uint32_t            m_slot_shift = 32; //!< 32 - log2(slot count)
+    size_t              m_num_cells = 0;
+    std::vector<int>    m_elements;        //!< Element indices, ranges per cell
+    std::vector<float>  m_element_heights; //!< Parallel to `m_elements`; only needed to update `max_height` on removal
+};
+
+} // namespace RoR
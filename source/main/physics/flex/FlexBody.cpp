@@ -25,8 +25,10 @@
 #include "ApproxMath.h"
 #include "SimData.h"
 #include "FlexFactory.h"
+#include "FlexNodeTree.h"
 #include "GfxActor.h"
 #include "GfxScene.h"
+#include "PlatformUtils.h"
 #include "RigDef_File.h"
 
 #include <Ogre.h>
@@ -34,6 +36,38 @@
 using namespace Ogre;
 using namespace RoR;
 
+static const int LOCATOR_BINDING_GRAIN = 1024; //!< Vertices per thread pool work item
+
+static FlexDeformFn SelectFlexDeform()
+{
+#ifdef ROR_FLEX_DEFORM_X86
+    if (CpuSupportsAVX2())
+    {
+        RoR::Log("[RoR|Flexbody] Deformation kernel: AVX2");
+        return DeformFlexVerticesAVX2;
+    }
+#endif
+    RoR::Log("[RoR|Flexbody] Deformation kernel: scalar");
+    return DeformFlexVerticesScalar;
+}
+
+/// Positions and normals share one interleaved vertex buffer, see the vertex declaration in `FlexBody::FlexBody()`
+static void ReadPositionsAndNormals(const Ogre::VertexData* vertex_data, Ogre::HardwareVertexBufferSharedPtr& out_vbuf, Vector3* out_pos, Vector3* out_normals)
+{
+    const VertexElement* pos_elem = vertex_data->vertexDeclaration->findElementBySemantic(VES_POSITION);
+    const VertexElement* norm_elem = vertex_data->vertexDeclaration->findElementBySemantic(VES_NORMAL);
+    out_vbuf = vertex_data->vertexBufferBinding->getBuffer(pos_elem->getSource());
+
+    const size_t vertex_size = out_vbuf->getVertexSize();
+    std::vector<char> data(vertex_data->vertexCount * vertex_size);
+    out_vbuf->readData(0, data.size(), data.data());
+    for (size_t i = 0; i < vertex_data->vertexCount; i++)
+    {
+        memcpy(&out_pos[i], &data[i * vertex_size + pos_elem->getOffset()], sizeof(Vector3));
+        memcpy(&out_normals[i], &data[i * vertex_size + norm_elem->getOffset()], sizeof(Vector3));
+    }
+}
+
 FlexBody::FlexBody(
     RigDef::Flexbody* def,
     RoR::FlexBodyCacheData* preloaded_from_cache,
@@ -58,7 +92,6 @@ FlexBody::FlexBody(
     , m_blend_changed(false)
     , m_locators(nullptr)
     , m_src_normals(nullptr)
-    , m_dst_normals(nullptr)
     , m_dst_pos(nullptr)
     , m_src_colors(nullptr)
     , m_gfx_actor(gfx_actor)
@@ -146,7 +179,7 @@ FlexBody::FlexBody(
     //create optimal VertexDeclaration
     VertexDeclaration* optimalVD=HardwareBufferManager::getSingleton().createVertexDeclaration();
     optimalVD->addElement(0, 0, VET_FLOAT3, VES_POSITION);
-    optimalVD->addElement(1, 0, VET_FLOAT3, VES_NORMAL);
+    optimalVD->addElement(0, VertexElement::getTypeSize(VET_FLOAT3), VET_FLOAT3, VES_NORMAL); // Interleaved, uploaded in one go
     if (m_has_texture_blend) optimalVD->addElement(2, 0, VET_COLOUR_ARGB, VES_DIFFUSE);
     if (m_has_texture) optimalVD->addElement(3, 0, VET_FLOAT2, VES_TEXTURE_COORDINATES);
     optimalVD->sort();
@@ -256,7 +289,6 @@ FlexBody::FlexBody(
         m_dst_pos     = preloaded_from_cache->dst_pos;
         m_src_normals = preloaded_from_cache->src_normals;
         m_locators    = preloaded_from_cache->locators;
-        m_dst_normals = (Vector3*)malloc(sizeof(Vector3)*m_vertex_count); // Use malloc() for compatibility
 
         if (m_has_texture_blend)
         {
@@ -267,12 +299,9 @@ FlexBody::FlexBody(
         {
             m_shared_buf_num_verts=(int)mesh->sharedVertexData->vertexCount;
 
-            //vertices
+            //vertices + normals
             int source=mesh->sharedVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION)->getSource();
-            m_shared_vbuf_pos=mesh->sharedVertexData->vertexBufferBinding->getBuffer(source);
-            //normals
-            source=mesh->sharedVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL)->getSource();
-            m_shared_vbuf_norm=mesh->sharedVertexData->vertexBufferBinding->getBuffer(source);
+            m_shared_vbuf_pos_norm=mesh->sharedVertexData->vertexBufferBinding->getBuffer(source);
             //colors
             if (m_has_texture_blend)
             {
@@ -292,9 +321,7 @@ FlexBody::FlexBody(
             m_submesh_vbufs_vertex_counts[curr_submesh_idx] = (int)vertex_data->vertexCount;
 
             int source_pos  = vertex_data->vertexDeclaration->findElementBySemantic(VES_POSITION)->getSource();
-            int source_norm = vertex_data->vertexDeclaration->findElementBySemantic(VES_NORMAL)->getSource();
-            m_submesh_vbufs_pos [curr_submesh_idx] = vertex_data->vertexBufferBinding->getBuffer(source_pos);
-            m_submesh_vbufs_norm[curr_submesh_idx] = vertex_data->vertexBufferBinding->getBuffer(source_norm);
+            m_submesh_vbufs_pos_norm[curr_submesh_idx] = vertex_data->vertexBufferBinding->getBuffer(source_pos);
 
             if (m_has_texture_blend)
             {
@@ -309,7 +336,6 @@ FlexBody::FlexBody(
         vertices=(Vector3*)malloc(sizeof(Vector3)*m_vertex_count);
         m_dst_pos=(Vector3*)malloc(sizeof(Vector3)*m_vertex_count);
         m_src_normals=(Vector3*)malloc(sizeof(Vector3)*m_vertex_count);
-        m_dst_normals=(Vector3*)malloc(sizeof(Vector3)*m_vertex_count);
         if (m_has_texture_blend)
         {
             m_src_colors=(ARGB*)malloc(sizeof(ARGB)*m_vertex_count);
@@ -320,20 +346,14 @@ FlexBody::FlexBody(
         if (mesh->sharedVertexData)
         {
             m_shared_buf_num_verts=(int)mesh->sharedVertexData->vertexCount;
-            //vertices
-            int source=mesh->sharedVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION)->getSource();
-            m_shared_vbuf_pos=mesh->sharedVertexData->vertexBufferBinding->getBuffer(source);
-            m_shared_vbuf_pos->readData(0, mesh->sharedVertexData->vertexCount*sizeof(Vector3), (void*)vpt);
+            //vertices + normals
+            ReadPositionsAndNormals(mesh->sharedVertexData, m_shared_vbuf_pos_norm, vpt, npt);
             vpt+=mesh->sharedVertexData->vertexCount;
-            //normals
-            source=mesh->sharedVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL)->getSource();
-            m_shared_vbuf_norm=mesh->sharedVertexData->vertexBufferBinding->getBuffer(source);
-            m_shared_vbuf_norm->readData(0, mesh->sharedVertexData->vertexCount*sizeof(Vector3), (void*)npt);
             npt+=mesh->sharedVertexData->vertexCount;
             //colors
             if (m_has_texture_blend)
             {
-                source=mesh->sharedVertexData->vertexDeclaration->findElementBySemantic(VES_DIFFUSE)->getSource();
+                int source=mesh->sharedVertexData->vertexDeclaration->findElementBySemantic(VES_DIFFUSE)->getSource();
                 m_shared_vbuf_color=mesh->sharedVertexData->vertexBufferBinding->getBuffer(source);
                 m_shared_vbuf_color->writeData(0, mesh->sharedVertexData->vertexCount*sizeof(ARGB), (void*)m_src_colors);
             }
@@ -349,20 +369,14 @@ FlexBody::FlexBody(
             const Ogre::VertexData* vertex_data = submesh->vertexData;
             int vertex_count = (int)vertex_data->vertexCount;
             m_submesh_vbufs_vertex_counts[cursubmesh] = vertex_count;
-            //vertices
-            int source = vertex_data->vertexDeclaration->findElementBySemantic(VES_POSITION)->getSource();
-            m_submesh_vbufs_pos[cursubmesh]=vertex_data->vertexBufferBinding->getBuffer(source);
-            m_submesh_vbufs_pos[cursubmesh]->readData(0, vertex_count*sizeof(Vector3), (void*)vpt);
+            //vertices + normals
+            ReadPositionsAndNormals(vertex_data, m_submesh_vbufs_pos_norm[cursubmesh], vpt, npt);
             vpt += vertex_count;
-            //normals
-            source = vertex_data->vertexDeclaration->findElementBySemantic(VES_NORMAL)->getSource();
-            m_submesh_vbufs_norm[cursubmesh]=vertex_data->vertexBufferBinding->getBuffer(source);
-            m_submesh_vbufs_norm[cursubmesh]->readData(0, vertex_count*sizeof(Vector3), (void*)npt);
             npt += vertex_count;
             //colors
             if (m_has_texture_blend)
             {
-                source = vertex_data->vertexDeclaration->findElementBySemantic(VES_DIFFUSE)->getSource();
+                int source = vertex_data->vertexDeclaration->findElementBySemantic(VES_DIFFUSE)->getSource();
                 m_submesh_vbufs_color[cursubmesh] = vertex_data->vertexBufferBinding->getBuffer(source);
                 m_submesh_vbufs_color[cursubmesh]->writeData(0, vertex_count*sizeof(ARGB), (void*)m_src_colors);
             }
@@ -376,95 +390,81 @@ FlexBody::FlexBody(
         }
 
         m_locators = new Locator_t[m_vertex_count];
-        for (int i=0; i<(int)m_vertex_count; i++)
+
+        // Nearest-node searches go through a k-d tree over the forset, duplicates removed
+        // (first occurrence kept, so that ties resolve like a scan of `node_indices` would)
+        std::vector<int> forset;
+        std::vector<float> forset_positions;
+        std::vector<bool> in_forset(m_gfx_actor->FetchNumNodes(), false);
+        for (unsigned int node_index : node_indices)
         {
-            //search nearest node as the local origin
-            float closest_node_distance = std::numeric_limits<float>::max();
-            int closest_node_index = -1;
-            for (auto node_index : node_indices)
-            {
-                float node_distance = vertices[i].squaredDistance(nodes[node_index].AbsPosition);
-                if (node_distance < closest_node_distance)
-                {
-                    closest_node_distance = node_distance;
-                    closest_node_index = node_index;
-                }
-            }
-            if (closest_node_index == -1)
+            if (!in_forset[node_index])
             {
-                LOG("FLEXBODY ERROR on mesh "+def->mesh_name+": REF node not found");
-                closest_node_index = 0;
+                in_forset[node_index] = true;
+                forset.push_back(static_cast<int>(node_index));
+                forset_positions.push_back(nodes[node_index].AbsPosition.x);
+                forset_positions.push_back(nodes[node_index].AbsPosition.y);
+                forset_positions.push_back(nodes[node_index].AbsPosition.z);
             }
-            m_locators[i].ref=closest_node_index;            
+        }
+        FlexNodeTree node_tree;
+        node_tree.Build(forset_positions.data(), static_cast<int>(forset.size()));
 
-            //search the second nearest node as the X vector
-            closest_node_distance = std::numeric_limits<float>::max();
-            closest_node_index = -1;
-            for (auto node_index : node_indices)
+        // Vertices are independent of each other
+        App::GetThreadPool()->ParallelFor(0, static_cast<int>(m_vertex_count), LOCATOR_BINDING_GRAIN, [&](int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
             {
-                if (node_index == m_locators[i].ref)
+                const float* vertex = vertices[i].ptr();
+
+                //search nearest node as the local origin, and the second nearest node as the X vector
+                int closest_ref = -1, closest_x = -1;
+                node_tree.FindNearestTwo(vertex, closest_ref, closest_x);
+                if (closest_ref == -1)
                 {
-                    continue;
+                    LOG("FLEXBODY ERROR on mesh "+def->mesh_name+": REF node not found");
                 }
-                float node_distance = vertices[i].squaredDistance(nodes[node_index].AbsPosition);
-                if (node_distance < closest_node_distance)
+                m_locators[i].ref = (closest_ref == -1) ? 0 : forset[closest_ref];
+                if (closest_x == -1)
                 {
-                    closest_node_distance = node_distance;
-                    closest_node_index = node_index;
+                    LOG("FLEXBODY ERROR on mesh "+def->mesh_name+": VX node not found");
                 }
-            }
-            if (closest_node_index == -1)
-            {
-                LOG("FLEXBODY ERROR on mesh "+def->mesh_name+": VX node not found");
-                closest_node_index = 0;
-            }
-            m_locators[i].nx=closest_node_index;
+                m_locators[i].nx = (closest_x == -1) ? 0 : forset[closest_x];
 
-            //search another close, orthogonal node as the Y vector
-            closest_node_distance = std::numeric_limits<float>::max();
-            closest_node_index = -1;
-            Vector3 vx = (nodes[m_locators[i].nx].AbsPosition - nodes[m_locators[i].ref].AbsPosition).normalisedCopy();
-            for (auto node_index : node_indices)
-            {
-                if (node_index == m_locators[i].ref || node_index == m_locators[i].nx)
+                //search another close, orthogonal node as the Y vector
+                Vector3 vx = (nodes[m_locators[i].nx].AbsPosition - nodes[m_locators[i].ref].AbsPosition).normalisedCopy();
+                const int closest_y = node_tree.FindNearest(vertex, [&](int k)
                 {
-                    continue;
-                }
-                float node_distance = vertices[i].squaredDistance(nodes[node_index].AbsPosition);
-                if (node_distance < closest_node_distance)
-                {
-                    Vector3 vt = (nodes[node_index].AbsPosition - nodes[m_locators[i].ref].AbsPosition).normalisedCopy();
-                    float cost = vx.dotProduct(vt);
-                    if (std::abs(cost) > std::sqrt(2.0f) / 2.0f)
+                    if (k == closest_ref || k == closest_x)
                     {
-                        continue; //rejection, fails the orthogonality criterion (+-45 degree)
+                        return false;
                     }
-                    closest_node_distance = node_distance;
-                    closest_node_index = node_index;
+                    Vector3 vt = (nodes[forset[k]].AbsPosition - nodes[m_locators[i].ref].AbsPosition).normalisedCopy();
+                    float cost = vx.dotProduct(vt);
+                    return std::abs(cost) <= std::sqrt(2.0f) / 2.0f; //orthogonality criterion (+-45 degree)
+                });
+                if (closest_y == -1)
+                {
+                    LOG("FLEXBODY ERROR on mesh "+def->mesh_name+": VY node not found");
                 }
-            }
-            if (closest_node_index == -1)
-            {
-                LOG("FLEXBODY ERROR on mesh "+def->mesh_name+": VY node not found");
-                closest_node_index = 0;
-            }
-            m_locators[i].ny=closest_node_index;
+                m_locators[i].ny = (closest_y == -1) ? 0 : forset[closest_y];
 
-            Matrix3 mat;
-            Vector3 diffX = nodes[m_locators[i].nx].AbsPosition-nodes[m_locators[i].ref].AbsPosition;
-            Vector3 diffY = nodes[m_locators[i].ny].AbsPosition-nodes[m_locators[i].ref].AbsPosition;
+                Matrix3 mat;
+                Vector3 diffX = nodes[m_locators[i].nx].AbsPosition-nodes[m_locators[i].ref].AbsPosition;
+                Vector3 diffY = nodes[m_locators[i].ny].AbsPosition-nodes[m_locators[i].ref].AbsPosition;
 
-            mat.SetColumn(0, diffX);
-            mat.SetColumn(1, diffY);
-            mat.SetColumn(2, (diffX.crossProduct(diffY)).normalisedCopy()); // Old version: mat.SetColumn(2, nodes[loc.nz].AbsPosition-nodes[loc.ref].AbsPosition);
+                mat.SetColumn(0, diffX);
+                mat.SetColumn(1, diffY);
+                mat.SetColumn(2, (diffX.crossProduct(diffY)).normalisedCopy()); // Old version: mat.SetColumn(2, nodes[loc.nz].AbsPosition-nodes[loc.ref].AbsPosition);
 
-            mat = mat.Inverse();
+                mat = mat.Inverse();
 
-            //compute coordinates in the newly formed Euclidean basis
-            m_locators[i].coords = mat * (vertices[i] - nodes[m_locators[i].ref].AbsPosition);
+                //compute coordinates in the newly formed Euclidean basis
+                m_locators[i].coords = mat * (vertices[i] - nodes[m_locators[i].ref].AbsPosition);
 
-            // that's it!
-        }
+                // that's it!
+            }
+        });
 
     } // if (preloaded_from_cache == nullptr)
 
@@ -509,6 +509,44 @@ FlexBody::FlexBody(
         }
     }
 
+    // Deformation works on a sorted SoA copy, see FlexBodyDeform.h
+    std::vector<FlexVertexBinding> bindings(m_vertex_count);
+    for (int i=0; i<(int)m_vertex_count; i++)
+    {
+        bindings[i].ref       = m_locators[i].ref;
+        bindings[i].nx        = m_locators[i].nx;
+        bindings[i].ny        = m_locators[i].ny;
+        bindings[i].coords[0] = m_locators[i].coords.x;
+        bindings[i].coords[1] = m_locators[i].coords.y;
+        bindings[i].coords[2] = m_locators[i].coords.z;
+        bindings[i].normal[0] = m_src_normals[i].x;
+        bindings[i].normal[1] = m_src_normals[i].y;
+        bindings[i].normal[2] = m_src_normals[i].z;
+    }
+    BuildFlexVertexSoa(bindings, sizeof(RoR::GfxActor::SimBuffer::NodeSB) / sizeof(float), m_vertex_soa);
+    m_dst_vertices.resize(m_vertex_count * FLEX_VERTEX_FLOATS);
+
+    // Dirty tracking: every node the deformation reads
+    std::vector<int> snapshot_nodes;
+    snapshot_nodes.reserve(m_vertex_count * 3 + 3);
+    for (int i=0; i<(int)m_vertex_count; i++)
+    {
+        snapshot_nodes.push_back(m_locators[i].ref);
+        snapshot_nodes.push_back(m_locators[i].nx);
+        snapshot_nodes.push_back(m_locators[i].ny);
+    }
+    if (m_node_center >= 0)
+    {
+        snapshot_nodes.push_back(m_node_center);
+        snapshot_nodes.push_back(m_node_x);
+        snapshot_nodes.push_back(m_node_y);
+    }
+    else
+    {
+        snapshot_nodes.push_back(0);
+    }
+    m_node_snapshot.SetNodes(snapshot_nodes, m_has_texture_blend);
+
     if (vertices != nullptr) { free(vertices); }
 
 #ifdef FLEXBODY_LOG_LOADING_TIMES
@@ -538,7 +576,6 @@ FlexBody::~FlexBody()
     if (m_locators != nullptr) { delete[] m_locators; }
     // Stuff using malloc()
     if (m_src_normals != nullptr) { free(m_src_normals); }
-    if (m_dst_normals != nullptr) { free(m_dst_normals); }
     if (m_dst_pos     != nullptr) { free(m_dst_pos    ); }
     if (m_src_colors  != nullptr) { free(m_src_colors ); }
 
@@ -606,12 +643,48 @@ void FlexBody::printMeshInfo(Mesh* mesh)
     }
 }
 
-void FlexBody::ComputeFlexbody()
+bool FlexBody::PrepareFlexbodyUpdate(Ogre::Vector3 const& camera_pos)
 {
-    if (m_has_texture_blend) updateBlend();
-
     RoR::GfxActor::SimBuffer::NodeSB* nodes = m_gfx_actor->GetSimNodeBuffer();
+    this->UpdateReferenceFrame(nodes);
+    this->UpdateLod(m_flexit_center.distance(camera_pos));
+
+    bool deform = true;
+    if (m_lod == Lod::REDUCED_RATE)
+    {
+        deform = (++m_lod_frames_skipped >= App::gfx_flexbody_lod_interval->GetInt());
+    }
+    else if (m_lod == Lod::RIGID)
+    {
+        deform = false;
+    }
+    if (!m_node_snapshot.IsValid())
+    {
+        deform = true; // New or reset; the LODs need one deformation to start from
+    }
+
+    if (!deform)
+    {
+        // Vertices stay relative to the center as of the last deformation - rotate them along with the node triangle
+        m_flexit_orientation = m_flexit_basis * m_deform_basis.Inverse();
+        m_pose_pending = true;
+        return false;
+    }
+
+    m_lod_frames_skipped = 0;
+    if (!m_node_snapshot.Update(nodes))
+    {
+        return false; // Vertex buffers are up to date
+    }
+
+    m_deform_basis = m_flexit_basis;
+    m_flexit_orientation = Ogre::Quaternion::IDENTITY;
+    m_upload_pending = true;
+    return true;
+}
 
+void FlexBody::UpdateReferenceFrame(RoR::GfxActor::SimBuffer::NodeSB* nodes)
+{
     // compute the local center
     Ogre::Vector3 flexit_normal;
 
@@ -623,50 +696,81 @@ void FlexBody::ComputeFlexbody()
 
         m_flexit_center = nodes[m_node_center].AbsPosition + m_center_offset.x * diffX + m_center_offset.y * diffY;
         m_flexit_center += m_center_offset.z * flexit_normal;
+
+        // Exact normalization; the rigid LOD needs an orthonormal basis
+        const Vector3 axis_x = diffX.normalisedCopy();
+        const Vector3 axis_z = diffY.crossProduct(diffX).normalisedCopy();
+        m_flexit_basis = Ogre::Quaternion(axis_x, axis_z.crossProduct(axis_x), axis_z);
     }
     else
     {
         flexit_normal = Vector3::UNIT_Y;
         m_flexit_center = nodes[0].AbsPosition;
+        m_flexit_basis = Ogre::Quaternion::IDENTITY;
     }
+}
 
-    for (int i=0; i<(int)m_vertex_count; i++)
+void FlexBody::UpdateLod(float camera_distance)
+{
+    // A LOD is entered beyond its distance and left only 10% closer, so that bodies at the boundary don't flicker
+    const float rate_distance = App::gfx_flexbody_lod_distance->GetFloat();
+    const float rigid_distance = App::gfx_flexbody_lod_rigid_distance->GetFloat();
+    const float hysteresis = 0.9f;
+
+    const float rigid_limit = (m_lod == Lod::RIGID) ? rigid_distance * hysteresis : rigid_distance;
+    const float rate_limit = (m_lod != Lod::FULL) ? rate_distance * hysteresis : rate_distance;
+    if (rigid_distance > 0.f && camera_distance > rigid_limit)
     {
-        Vector3 diffX = nodes[m_locators[i].nx].AbsPosition - nodes[m_locators[i].ref].AbsPosition;
-        Vector3 diffY = nodes[m_locators[i].ny].AbsPosition - nodes[m_locators[i].ref].AbsPosition;
-        Vector3 nCross = fast_normalise(diffX.crossProduct(diffY)); //nCross.normalise();
-
-        m_dst_pos[i].x = diffX.x * m_locators[i].coords.x + diffY.x * m_locators[i].coords.y + nCross.x * m_locators[i].coords.z;
-        m_dst_pos[i].y = diffX.y * m_locators[i].coords.x + diffY.y * m_locators[i].coords.y + nCross.y * m_locators[i].coords.z;
-        m_dst_pos[i].z = diffX.z * m_locators[i].coords.x + diffY.z * m_locators[i].coords.y + nCross.z * m_locators[i].coords.z;
-
-        m_dst_pos[i] += nodes[m_locators[i].ref].AbsPosition - m_flexit_center;
+        m_lod = Lod::RIGID;
+    }
+    else if (rate_distance > 0.f && camera_distance > rate_limit)
+    {
+        m_lod = Lod::REDUCED_RATE;
+    }
+    else
+    {
+        m_lod = Lod::FULL;
+    }
+}
 
-        m_dst_normals[i].x = diffX.x * m_src_normals[i].x + diffY.x * m_src_normals[i].y + nCross.x * m_src_normals[i].z;
-        m_dst_normals[i].y = diffX.y * m_src_normals[i].x + diffY.y * m_src_normals[i].y + nCross.y * m_src_normals[i].z;
-        m_dst_normals[i].z = diffX.z * m_src_normals[i].x + diffY.z * m_src_normals[i].y + nCross.z * m_src_normals[i].z;
+bool FlexBody::ComputeFlexbodyVertices(int begin, int end)
+{
+    const bool blend_changed = m_has_texture_blend && updateBlend(begin, end);
 
-        m_dst_normals[i] = fast_normalise(m_dst_normals[i]);
-    }
+    // The kernel works in sorted order, blending in vertex order - either way, each range touches its own vertices
+    static const FlexDeformFn deform_vertices = SelectFlexDeform();
+    RoR::GfxActor::SimBuffer::NodeSB* nodes = m_gfx_actor->GetSimNodeBuffer();
+    deform_vertices(m_vertex_soa, nodes[0].AbsPosition.ptr(), m_flexit_center.ptr(), begin, end, m_dst_vertices.data());
+    return blend_changed;
 }
 
 void FlexBody::UpdateFlexbodyVertexBuffers()
 {
-    Vector3 *ppt = m_dst_pos;
-    Vector3 *npt = m_dst_normals;
+    if (m_pose_pending && !m_upload_pending)
+    {
+        m_scene_node->setPosition(m_flexit_center);
+        m_scene_node->setOrientation(m_flexit_orientation);
+        m_pose_pending = false;
+        return;
+    }
+    if (!m_upload_pending)
+    {
+        return;
+    }
+    m_upload_pending = false;
+    m_pose_pending = false;
+
+    // One write per vertex buffer, positions and normals are interleaved already
+    const float* vpt = m_dst_vertices.data();
     if (m_uses_shared_vertex_data)
     {
-        m_shared_vbuf_pos->writeData(0, m_shared_buf_num_verts*sizeof(Vector3), ppt, true);
-        ppt += m_shared_buf_num_verts;
-        m_shared_vbuf_norm->writeData(0, m_shared_buf_num_verts*sizeof(Vector3), npt, true);
-        npt += m_shared_buf_num_verts;
+        m_shared_vbuf_pos_norm->writeData(0, m_shared_buf_num_verts*FLEX_VERTEX_FLOATS*sizeof(float), vpt, true);
+        vpt += m_shared_buf_num_verts*FLEX_VERTEX_FLOATS;
     }
     for (int i=0; i<m_num_submesh_vbufs; i++)
     {
-        m_submesh_vbufs_pos[i]->writeData(0, m_submesh_vbufs_vertex_counts[i]*sizeof(Vector3), ppt, true);
-        ppt += m_submesh_vbufs_vertex_counts[i];
-        m_submesh_vbufs_norm[i]->writeData(0, m_submesh_vbufs_vertex_counts[i]*sizeof(Vector3), npt, true);
-        npt += m_submesh_vbufs_vertex_counts[i];
+        m_submesh_vbufs_pos_norm[i]->writeData(0, m_submesh_vbufs_vertex_counts[i]*FLEX_VERTEX_FLOATS*sizeof(float), vpt, true);
+        vpt += m_submesh_vbufs_vertex_counts[i]*FLEX_VERTEX_FLOATS;
     }
 
     if (m_blend_changed)
@@ -676,6 +780,7 @@ void FlexBody::UpdateFlexbodyVertexBuffers()
     }
 
     m_scene_node->setPosition(m_flexit_center);
+    m_scene_node->setOrientation(m_flexit_orientation);
 }
 
 void FlexBody::reset()
@@ -685,6 +790,7 @@ void FlexBody::reset()
         for (int i=0; i<(int)m_vertex_count; i++) m_src_colors[i]=0x00000000;
         writeBlend();
     }
+    m_node_snapshot.Invalidate(); // Deform even at rest or in rigid LOD; also re-applies blending of nodes still in contact
 }
 
 void FlexBody::writeBlend()
@@ -703,23 +809,25 @@ void FlexBody::writeBlend()
     }
 }
 
-void FlexBody::updateBlend() //so easy!
+bool FlexBody::updateBlend(int begin, int end) //so easy!
 {
+    bool changed = false;
     RoR::GfxActor::SimBuffer::NodeSB* nodes = m_gfx_actor->GetSimNodeBuffer();
-    for (int i=0; i<(int)m_vertex_count; i++)
+    for (int i=begin; i<end; i++)
     {
         RoR::GfxActor::SimBuffer::NodeSB *nd = &nodes[m_locators[i].ref];
         ARGB col = m_src_colors[i];
         if (nd->nd_has_contact && !(col&0xFF000000))
         {
             m_src_colors[i]=col|0xFF000000;
-            m_blend_changed = true;
+            changed = true;
         }
         if (nd->nd_is_wet ^ ((col&0x000000FF)>0))
         {
             m_src_colors[i]=(col&0xFFFFFF00)+0x000000FF*nd->nd_is_wet;
-            m_blend_changed = true;
+            changed = true;
         }
     }
+    return changed;
 }
 
@@ -23,6 +23,8 @@
 
 #include "RigDef_Prerequisites.h"
 #include "Application.h"
+#include "FlexBodyDeform.h"
+#include "FlexNodeSnapshot.h"
 #include "Locator_t.h"
 
 #include <OgreVector3.h>
@@ -52,11 +54,19 @@ class FlexBody
 
 public:
 
+    /// Level of detail by distance from camera, see cvars 'gfx_flexbody_lod_*'
+    enum class Lod
+    {
+        FULL,          //!< Deformed every frame
+        REDUCED_RATE,  //!< Deformed every Nth frame, moved rigidly in between
+        RIGID          //!< Moved rigidly with the reference frame, no per-vertex work
+    };
+
     ~FlexBody();
 
     void printMeshInfo(Ogre::Mesh* mesh);
     void reset();
-    void updateBlend();
+    bool updateBlend(int begin, int end); //!< Returns true if any color changed
     void writeBlend();
 
     /// Visibility control 
@@ -64,26 +74,36 @@ public:
     void setCameraMode(int mode) { m_camera_mode = mode; };
     int getCameraMode() { return m_camera_mode; };
 
-    void ComputeFlexbody(); //!< Updates mesh deformation; works on CPU using local copy of vertex data.
-    void UpdateFlexbodyVertexBuffers();
+    bool PrepareFlexbodyUpdate(Ogre::Vector3 const& camera_pos); //!< Updates the reference frame and LOD; false if `ComputeFlexbodyVertices()` can be skipped this frame.
+    bool ComputeFlexbodyVertices(int begin, int end); //!< Updates mesh deformation; works on CPU using local copy of vertex data. Disjoint ranges may run in parallel. Returns true if blending changed.
+    void SetBlendChanged() { m_blend_changed = true; } //!< Makes `UpdateFlexbodyVertexBuffers()` upload the colors
+    void UpdateFlexbodyVertexBuffers(); //!< Uploads vertices if `PrepareFlexbodyUpdate()` returned true, then places the scene node.
 
     void setVisible(bool visible);
 
     void SetFlexbodyCastShadow(bool val);
 
     int size() { return static_cast<int>(m_vertex_count); };
+    Lod GetLod() const { return m_lod; }
 
 private:
 
+    void UpdateReferenceFrame(RoR::GfxActor::SimBuffer::NodeSB* nodes);
+    void UpdateLod(float camera_distance);
+
     RoR::GfxActor*    m_gfx_actor;
     size_t            m_vertex_count;
     Ogre::Vector3     m_flexit_center; //!< Updated per frame
+    Ogre::Quaternion  m_flexit_basis;  //!< Updated per frame; orientation of the (center, x, y) node triangle
+    Ogre::Quaternion  m_deform_basis;  //!< `m_flexit_basis` as of the last deformation
+    Ogre::Quaternion  m_flexit_orientation = Ogre::Quaternion::IDENTITY; //!< Rigid motion since the last deformation
 
-    Ogre::Vector3*    m_dst_pos;
+    Ogre::Vector3*    m_dst_pos; //!< Only stored in the cache file; deformed vertices go to `m_dst_vertices`
     Ogre::Vector3*    m_src_normals;
-    Ogre::Vector3*    m_dst_normals;
     Ogre::ARGB*       m_src_colors;
     Locator_t*        m_locators; //!< 1 loc per vertex
+    FlexVertexSoa     m_vertex_soa; //!< Locators + normals, sorted for `ComputeFlexbodyVertices()`
+    std::vector<float> m_dst_vertices; //!< Interleaved like the vertex buffers, FLEX_VERTEX_FLOATS per vertex
 
     int               m_node_center;
     int               m_node_x;
@@ -94,20 +114,23 @@ private:
     int               m_camera_mode; //!< Visibility control {-2 = always, -1 = 3rdPerson only, 0+ = cinecam index}
 
     int                                 m_shared_buf_num_verts;
-    Ogre::HardwareVertexBufferSharedPtr m_shared_vbuf_pos;
-    Ogre::HardwareVertexBufferSharedPtr m_shared_vbuf_norm;
+    Ogre::HardwareVertexBufferSharedPtr m_shared_vbuf_pos_norm;
     Ogre::HardwareVertexBufferSharedPtr m_shared_vbuf_color;
 
     int                                 m_num_submesh_vbufs;
     int                                 m_submesh_vbufs_vertex_counts[16];
-    Ogre::HardwareVertexBufferSharedPtr m_submesh_vbufs_pos[16];   //!< positions
-    Ogre::HardwareVertexBufferSharedPtr m_submesh_vbufs_norm[16];  //!< normals
+    Ogre::HardwareVertexBufferSharedPtr m_submesh_vbufs_pos_norm[16]; //!< positions + normals, interleaved
     Ogre::HardwareVertexBufferSharedPtr m_submesh_vbufs_color[16]; //!< colors
 
     bool m_uses_shared_vertex_data;
     bool m_has_texture;
     bool m_has_texture_blend;
-    bool m_blend_changed;
+    bool m_blend_changed; //!< Per-range results OR-ed in after the parallel loop, see `GfxActor::ComputeFlexbodyChunks()`
+    FlexNodeSnapshot  m_node_snapshot;
+    bool              m_upload_pending = false;
+    bool              m_pose_pending = false;
+    Lod               m_lod = Lod::FULL;
+    int               m_lod_frames_skipped = 0;
 };
 
 } // namespace RoR
@@ -0,0 +1,200 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FlexBodyDeform.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef ROR_FLEX_DEFORM_X86
+#   include <immintrin.h>
+#endif
+
+#if defined(ROR_FLEX_DEFORM_X86) && (defined(__GNUC__) || defined(__clang__))
+#   define ROR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#   define ROR_TARGET_AVX2 // MSVC emits AVX2 intrinsics without extra flags
+#endif
+
+using namespace RoR;
+
+namespace {
+
+/// Same as `fast_invSqrt()` from ApproxMath.h, which needs OGRE
+inline float FastInvSqrt(float v)
+{
+    int32_t i;
+    std::memcpy(&i, &v, sizeof(float));
+    i = 0x5f3759df - (i >> 1);
+    float y;
+    std::memcpy(&y, &i, sizeof(float));
+    return y * (1.5f - (0.5f * v * y * y));
+}
+
+} // namespace
+
+void RoR::BuildFlexVertexSoa(std::vector<FlexVertexBinding> const& bindings, int node_stride, FlexVertexSoa& out)
+{
+    const int count = static_cast<int>(bindings.size());
+    std::vector<int32_t> order(count);
+    for (int i = 0; i < count; i++)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&bindings](int32_t a, int32_t b)
+    {
+        FlexVertexBinding const& va = bindings[a];
+        FlexVertexBinding const& vb = bindings[b];
+        if (va.ref != vb.ref) { return va.ref < vb.ref; }
+        if (va.nx != vb.nx)   { return va.nx < vb.nx; }
+        if (va.ny != vb.ny)   { return va.ny < vb.ny; }
+        return a < b;
+    });
+
+    out.count = count;
+    out.ref.resize(count);      out.nx.resize(count);       out.ny.resize(count);
+    out.coord_x.resize(count);  out.coord_y.resize(count);  out.coord_z.resize(count);
+    out.normal_x.resize(count); out.normal_y.resize(count); out.normal_z.resize(count);
+    out.vertex.resize(count);
+    for (int j = 0; j < count; j++)
+    {
+        FlexVertexBinding const& b = bindings[order[j]];
+        out.ref[j]      = b.ref * node_stride;
+        out.nx[j]       = b.nx * node_stride;
+        out.ny[j]       = b.ny * node_stride;
+        out.coord_x[j]  = b.coords[0];
+        out.coord_y[j]  = b.coords[1];
+        out.coord_z[j]  = b.coords[2];
+        out.normal_x[j] = b.normal[0];
+        out.normal_y[j] = b.normal[1];
+        out.normal_z[j] = b.normal[2];
+        out.vertex[j]   = order[j];
+    }
+}
+
+void RoR::DeformFlexVerticesScalar(FlexVertexSoa const& soa, const float* nodes, const float center[3], int begin, int end, float* out)
+{
+    for (int j = begin; j < end; j++)
+    {
+        const float* ref = nodes + soa.ref[j];
+        const float* nx  = nodes + soa.nx[j];
+        const float* ny  = nodes + soa.ny[j];
+        const float x0 = nx[0] - ref[0], x1 = nx[1] - ref[1], x2 = nx[2] - ref[2];
+        const float y0 = ny[0] - ref[0], y1 = ny[1] - ref[1], y2 = ny[2] - ref[2];
+
+        // fast_normalise(diffX.crossProduct(diffY))
+        float c0 = x1 * y2 - x2 * y1;
+        float c1 = x2 * y0 - x0 * y2;
+        float c2 = x0 * y1 - x1 * y0;
+        const float c_inv = FastInvSqrt(c0 * c0 + c1 * c1 + c2 * c2);
+        c0 *= c_inv; c1 *= c_inv; c2 *= c_inv;
+
+        float* dst = out + soa.vertex[j] * FLEX_VERTEX_FLOATS;
+        const float cx = soa.coord_x[j], cy = soa.coord_y[j], cz = soa.coord_z[j];
+        dst[0] = x0 * cx + y0 * cy + c0 * cz + (ref[0] - center[0]);
+        dst[1] = x1 * cx + y1 * cy + c1 * cz + (ref[1] - center[1]);
+        dst[2] = x2 * cx + y2 * cy + c2 * cz + (ref[2] - center[2]);
+
+        const float nx_ = soa.normal_x[j], ny_ = soa.normal_y[j], nz_ = soa.normal_z[j];
+        const float n0 = x0 * nx_ + y0 * ny_ + c0 * nz_;
+        const float n1 = x1 * nx_ + y1 * ny_ + c1 * nz_;
+        const float n2 = x2 * nx_ + y2 * ny_ + c2 * nz_;
+        const float n_inv = FastInvSqrt(n0 * n0 + n1 * n1 + n2 * n2);
+        dst[3] = n0 * n_inv;
+        dst[4] = n1 * n_inv;
+        dst[5] = n2 * n_inv;
+    }
+}
+
+#ifdef ROR_FLEX_DEFORM_X86
+
+ROR_TARGET_AVX2 static inline __m256 FastInvSqrtAVX2(__m256 v)
+{
+    const __m256i magic = _mm256_set1_epi32(0x5f3759df);
+    const __m256 y = _mm256_castsi256_ps(_mm256_sub_epi32(magic, _mm256_srai_epi32(_mm256_castps_si256(v), 1)));
+    return _mm256_mul_ps(y, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), v), y), y)));
+}
+
+ROR_TARGET_AVX2 void RoR::DeformFlexVerticesAVX2(FlexVertexSoa const& soa, const float* nodes, const float center[3], int begin, int end, float* out)
+{
+    const __m256 center_x = _mm256_set1_ps(center[0]);
+    const __m256 center_y = _mm256_set1_ps(center[1]);
+    const __m256 center_z = _mm256_set1_ps(center[2]);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+
+    // NOTE: No FMA on purpose - separate mul/add keeps results identical to the scalar code.
+    int j = begin;
+    for (; j + 8 <= end; j += 8)
+    {
+        const __m256i ref = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(soa.ref.data() + j));
+        const __m256i nx  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(soa.nx.data() + j));
+        const __m256i ny  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(soa.ny.data() + j));
+        const __m256 r0 = _mm256_i32gather_ps(nodes, ref, 4);
+        const __m256 r1 = _mm256_i32gather_ps(nodes, _mm256_add_epi32(ref, one), 4);
+        const __m256 r2 = _mm256_i32gather_ps(nodes, _mm256_add_epi32(ref, two), 4);
+        const __m256 x0 = _mm256_sub_ps(_mm256_i32gather_ps(nodes, nx, 4), r0);
+        const __m256 x1 = _mm256_sub_ps(_mm256_i32gather_ps(nodes, _mm256_add_epi32(nx, one), 4), r1);
+        const __m256 x2 = _mm256_sub_ps(_mm256_i32gather_ps(nodes, _mm256_add_epi32(nx, two), 4), r2);
+        const __m256 y0 = _mm256_sub_ps(_mm256_i32gather_ps(nodes, ny, 4), r0);
+        const __m256 y1 = _mm256_sub_ps(_mm256_i32gather_ps(nodes, _mm256_add_epi32(ny, one), 4), r1);
+        const __m256 y2 = _mm256_sub_ps(_mm256_i32gather_ps(nodes, _mm256_add_epi32(ny, two), 4), r2);
+
+        __m256 c0 = _mm256_sub_ps(_mm256_mul_ps(x1, y2), _mm256_mul_ps(x2, y1));
+        __m256 c1 = _mm256_sub_ps(_mm256_mul_ps(x2, y0), _mm256_mul_ps(x0, y2));
+        __m256 c2 = _mm256_sub_ps(_mm256_mul_ps(x0, y1), _mm256_mul_ps(x1, y0));
+        const __m256 c_inv = FastInvSqrtAVX2(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c0, c0), _mm256_mul_ps(c1, c1)), _mm256_mul_ps(c2, c2)));
+        c0 = _mm256_mul_ps(c0, c_inv);
+        c1 = _mm256_mul_ps(c1, c_inv);
+        c2 = _mm256_mul_ps(c2, c_inv);
+
+        alignas(32) float result[FLEX_VERTEX_FLOATS][8];
+        const __m256 cx = _mm256_loadu_ps(soa.coord_x.data() + j);
+        const __m256 cy = _mm256_loadu_ps(soa.coord_y.data() + j);
+        const __m256 cz = _mm256_loadu_ps(soa.coord_z.data() + j);
+        _mm256_store_ps(result[0], _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x0, cx), _mm256_mul_ps(y0, cy)), _mm256_mul_ps(c0, cz)), _mm256_sub_ps(r0, center_x)));
+        _mm256_store_ps(result[1], _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x1, cx), _mm256_mul_ps(y1, cy)), _mm256_mul_ps(c1, cz)), _mm256_sub_ps(r1, center_y)));
+        _mm256_store_ps(result[2], _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x2, cx), _mm256_mul_ps(y2, cy)), _mm256_mul_ps(c2, cz)), _mm256_sub_ps(r2, center_z)));
+
+        const __m256 nx_ = _mm256_loadu_ps(soa.normal_x.data() + j);
+        const __m256 ny_ = _mm256_loadu_ps(soa.normal_y.data() + j);
+        const __m256 nz_ = _mm256_loadu_ps(soa.normal_z.data() + j);
+        const __m256 n0 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x0, nx_), _mm256_mul_ps(y0, ny_)), _mm256_mul_ps(c0, nz_));
+        const __m256 n1 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x1, nx_), _mm256_mul_ps(y1, ny_)), _mm256_mul_ps(c1, nz_));
+        const __m256 n2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x2, nx_), _mm256_mul_ps(y2, ny_)), _mm256_mul_ps(c2, nz_));
+        const __m256 n_inv = FastInvSqrtAVX2(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(n0, n0), _mm256_mul_ps(n1, n1)), _mm256_mul_ps(n2, n2)));
+        _mm256_store_ps(result[3], _mm256_mul_ps(n0, n_inv));
+        _mm256_store_ps(result[4], _mm256_mul_ps(n1, n_inv));
+        _mm256_store_ps(result[5], _mm256_mul_ps(n2, n_inv));
+
+        // Scatter
+        for (int lane = 0; lane < 8; lane++)
+        {
+            float* dst = out + soa.vertex[j + lane] * FLEX_VERTEX_FLOATS;
+            for (int k = 0; k < FLEX_VERTEX_FLOATS; k++)
+            {
+                dst[k] = result[k][lane];
+            }
+        }
+    }
+
+    DeformFlexVerticesScalar(soa, nodes, center, j, end, out);
+}
+
+#endif // ROR_FLEX_DEFORM_X86
@@ -0,0 +1,72 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Vertex deformation kernel of `FlexBody::ComputeFlexbodyVertices()`.
+///
+/// Vertices are stored SoA, sorted by their locator nodes (ref, nx, ny), so that neighbouring
+/// lanes gather the same node positions. Results are scattered back to vertex order, interleaved
+/// as the vertex buffers want them: position xyz, normal xyz.
+/// The math mirrors the scalar code operation by operation (including `fast_invSqrt()`).
+/// Standard library only, so that microbenchmarks can include it.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#   define ROR_FLEX_DEFORM_X86
+#endif
+
+namespace RoR {
+
+static const int FLEX_VERTEX_FLOATS = 6; //!< Output layout per vertex: position xyz, normal xyz
+
+/// One vertex as bound at spawn, see `Locator_t`
+struct FlexVertexBinding
+{
+    int32_t  ref, nx, ny;   //!< Node indices
+    float    coords[3];     //!< Position in the (nx - ref, ny - ref, normal) basis
+    float    normal[3];     //!< Normal in the same basis
+};
+
+/// All vertices of a flexbody, SoA, sorted by (ref, nx, ny)
+struct FlexVertexSoa
+{
+    std::vector<int32_t>  ref, nx, ny;              //!< Node indices premultiplied by the node stride (in floats)
+    std::vector<float>    coord_x, coord_y, coord_z;
+    std::vector<float>    normal_x, normal_y, normal_z;
+    std::vector<int32_t>  vertex;                   //!< Destination index in vertex order
+    int                   count = 0;
+};
+
+/// `node_stride` = distance between node positions in floats.
+void BuildFlexVertexSoa(std::vector<FlexVertexBinding> const& bindings, int node_stride, FlexVertexSoa& out);
+
+/// Deforms sorted vertices [begin, end) and writes them to `out` (FLEX_VERTEX_FLOATS per vertex, vertex order).
+/// `nodes` points to the x of node 0; positions are written relative to `center`.
+typedef void (*FlexDeformFn)(FlexVertexSoa const& soa, const float* nodes, const float center[3], int begin, int end, float* out);
+
+void DeformFlexVerticesScalar(FlexVertexSoa const& soa, const float* nodes, const float center[3], int begin, int end, float* out);
+#ifdef ROR_FLEX_DEFORM_X86
+void DeformFlexVerticesAVX2(FlexVertexSoa const& soa, const float* nodes, const float center[3], int begin, int end, float* out);
+#endif
+
+} // namespace RoR
@@ -159,6 +159,13 @@ FlexMeshWheel::FlexMeshWheel(
     m_mesh->_setBounds(AxisAlignedBox(-1,-1,0,1,1,0), true);
 
     m_mesh->load();
+
+    std::vector<int> snapshot_nodes = { m_axis_node0_idx, m_axis_node1_idx };
+    for (int i = 0; i < nrays * 2; i++)
+    {
+        snapshot_nodes.push_back(m_start_node_idx + i);
+    }
+    m_node_snapshot.SetNodes(snapshot_nodes, /*track_blend=*/false);
 }
 
 FlexMeshWheel::~FlexMeshWheel()
@@ -236,6 +243,12 @@ void FlexMeshWheel::setVisible(bool visible)
 bool FlexMeshWheel::flexitPrepare()
 {
     RoR::GfxActor::SimBuffer::NodeSB* all_nodes = m_gfx_actor->GetSimNodeBuffer();
+    if (!m_node_snapshot.Update(all_nodes))
+    {
+        return false; // Rim, tire mesh and center are up to date
+    }
+    m_upload_pending = true;
+
     Vector3 center = (all_nodes[m_axis_node0_idx].AbsPosition + all_nodes[m_axis_node1_idx].AbsPosition) / 2.0;
     m_rim_scene_node->setPosition(center);
 
@@ -259,6 +272,10 @@ void FlexMeshWheel::flexitCompute()
 
 Vector3 FlexMeshWheel::flexitFinal()
 {
-    m_hw_vbuf->writeData(0, m_hw_vbuf->getSizeInBytes(), m_vertices, true);
+    if (m_upload_pending)
+    {
+        m_hw_vbuf->writeData(0, m_hw_vbuf->getSizeInBytes(), m_vertices, true);
+        m_upload_pending = false;
+    }
     return m_flexit_center;
 }
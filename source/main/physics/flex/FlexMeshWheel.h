@@ -23,6 +23,7 @@
 
 #include "ForwardDeclarations.h"
 #include "FlexMesh.h"
+#include "FlexNodeSnapshot.h"
 
 #include <Ogre.h>
 #include <string>
@@ -44,7 +45,7 @@ public:
     Ogre::Vector3 updateVertices();
 
     // Flexable
-    bool flexitPrepare();
+    bool flexitPrepare(); //!< False if no node moved since the last compute - nothing to do then.
     void flexitCompute();
     Ogre::Vector3 flexitFinal();
 
@@ -82,6 +83,8 @@ private:
 
     // Meshes
     Ogre::Vector3    m_flexit_center;
+    FlexNodeSnapshot m_node_snapshot;
+    bool             m_upload_pending = false;
     Ogre::MeshPtr    m_mesh;
     Ogre::SubMesh*   m_submesh;
     bool             m_is_rim_reverse;
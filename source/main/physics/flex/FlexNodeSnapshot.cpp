@@ -0,0 +1,68 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FlexNodeSnapshot.h"
+
+#include <algorithm>
+
+using namespace RoR;
+
+static const float POSITION_EPSILON = 0.001f; //!< Meters; smaller movements don't count
+
+void FlexNodeSnapshot::SetNodes(std::vector<int> nodes, bool track_blend)
+{
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    m_nodes = std::move(nodes);
+    m_positions.resize(m_nodes.size());
+    m_blend_flags.resize(track_blend ? m_nodes.size() : 0);
+    m_track_blend = track_blend;
+    m_valid = false;
+}
+
+bool FlexNodeSnapshot::Update(GfxActor::SimBuffer::NodeSB* nodes)
+{
+    const float epsilon_sq = POSITION_EPSILON * POSITION_EPSILON;
+    bool moved = !m_valid;
+    for (size_t i = 0; i < m_nodes.size() && !moved; i++)
+    {
+        GfxActor::SimBuffer::NodeSB const& node = nodes[m_nodes[i]];
+        moved = node.AbsPosition.squaredDistance(m_positions[i]) > epsilon_sq
+            || (m_track_blend && GetBlendFlags(node) != m_blend_flags[i]);
+    }
+
+    if (moved)
+    {
+        for (size_t i = 0; i < m_nodes.size(); i++)
+        {
+            m_positions[i] = nodes[m_nodes[i]].AbsPosition;
+            if (m_track_blend)
+            {
+                m_blend_flags[i] = GetBlendFlags(nodes[m_nodes[i]]);
+            }
+        }
+        m_valid = true;
+    }
+    return moved;
+}
+
+uint8_t FlexNodeSnapshot::GetBlendFlags(GfxActor::SimBuffer::NodeSB const& node)
+{
+    return (node.nd_has_contact ? 0x1 : 0) | (node.nd_is_wet ? 0x2 : 0);
+}
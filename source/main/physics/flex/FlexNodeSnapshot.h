@@ -0,0 +1,57 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Dirty tracking for deformable meshes (`FlexBody`, `FlexMeshWheel`).
+
+#pragma once
+
+#include "GfxActor.h"
+
+#include <OgreVector3.h>
+#include <cstdint>
+#include <vector>
+
+namespace RoR {
+
+/// State of the nodes a mesh is built from, as of its last recomputation.
+/// Parked or sleeping actors don't move their nodes, so their meshes needn't be recomputed nor uploaded.
+class FlexNodeSnapshot
+{
+public:
+    /// `nodes` may contain duplicates. With `track_blend`, contact/wet changes count as well (texture blending).
+    void SetNodes(std::vector<int> nodes, bool track_blend);
+
+    /// True if any node moved by more than 1mm (or the snapshot is new); the snapshot is retaken then.
+    bool Update(GfxActor::SimBuffer::NodeSB* nodes);
+
+    void Invalidate() { m_valid = false; } //!< Forces the next `Update()` to return true
+    bool IsValid() const { return m_valid; }
+
+private:
+    static uint8_t GetBlendFlags(GfxActor::SimBuffer::NodeSB const& node);
+
+    std::vector<int>            m_nodes;
+    std::vector<Ogre::Vector3>  m_positions;
+    std::vector<uint8_t>        m_blend_flags; //!< Empty unless tracked
+    bool                        m_track_blend = false;
+    bool                        m_valid = false;
+};
+
+} // namespace RoR
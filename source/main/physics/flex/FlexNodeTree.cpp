@@ -0,0 +1,129 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FlexNodeTree.h"
+
+#include <algorithm>
+
+using namespace RoR;
+
+void FlexNodeTree::Build(const float* positions, int count)
+{
+    m_cells.clear();
+    m_points.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        m_points[i].pos[0] = positions[i * 3 + 0];
+        m_points[i].pos[1] = positions[i * 3 + 1];
+        m_points[i].pos[2] = positions[i * 3 + 2];
+        m_points[i].index = i;
+    }
+    if (count > 0)
+    {
+        m_cells.reserve(2 * (count / LEAF_SIZE + 1));
+        this->BuildCell(0, count);
+    }
+}
+
+void FlexNodeTree::FindNearestTwo(const float* point, int& out_first, int& out_second) const
+{
+    Result first, second;
+    if (!m_cells.empty())
+    {
+        this->SearchTwo(0, point, first, second);
+    }
+    out_first = first.index;
+    out_second = second.index;
+}
+
+void FlexNodeTree::SearchTwo(int cell_index, const float* point, Result& first, Result& second) const
+{
+    Cell const& cell = m_cells[cell_index];
+    if (cell.axis < 0)
+    {
+        for (int i = cell.begin; i < cell.end; i++)
+        {
+            Point const& p = m_points[i];
+            const float distance = GetSquaredDistance(point, p.pos);
+            if (IsCloser(distance, p.index, first))
+            {
+                second = first;
+                first.distance = distance;
+                first.index = p.index;
+            }
+            else if (IsCloser(distance, p.index, second))
+            {
+                second.distance = distance;
+                second.index = p.index;
+            }
+        }
+        return;
+    }
+
+    const float diff = point[cell.axis] - cell.split;
+    this->SearchTwo((diff <= 0.f) ? cell.left : cell.right, point, first, second);
+    if (second.index == -1 || diff * diff <= second.distance)
+    {
+        this->SearchTwo((diff <= 0.f) ? cell.right : cell.left, point, first, second);
+    }
+}
+
+int FlexNodeTree::BuildCell(int begin, int end)
+{
+    const int cell_index = static_cast<int>(m_cells.size());
+    m_cells.push_back(Cell());
+    m_cells[cell_index].begin = begin;
+    m_cells[cell_index].end = end;
+    m_cells[cell_index].axis = -1;
+
+    if (end - begin <= LEAF_SIZE)
+    {
+        return cell_index;
+    }
+
+    // Split the widest extent at the median
+    float lo[3] = { m_points[begin].pos[0], m_points[begin].pos[1], m_points[begin].pos[2] };
+    float hi[3] = { lo[0], lo[1], lo[2] };
+    for (int i = begin + 1; i < end; i++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            lo[k] = std::min(lo[k], m_points[i].pos[k]);
+            hi[k] = std::max(hi[k], m_points[i].pos[k]);
+        }
+    }
+    int axis = 0;
+    if (hi[1] - lo[1] > hi[axis] - lo[axis]) { axis = 1; }
+    if (hi[2] - lo[2] > hi[axis] - lo[axis]) { axis = 2; }
+
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(m_points.begin() + begin, m_points.begin() + mid, m_points.begin() + end,
+        [axis](Point const& a, Point const& b) { return a.pos[axis] < b.pos[axis]; });
+    const float split = m_points[mid].pos[axis]; // Before the children reorder their ranges
+
+    const int left = this->BuildCell(begin, mid);
+    const int right = this->BuildCell(mid, end);
+
+    Cell& cell = m_cells[cell_index]; // Children may have reallocated the vector
+    cell.axis = axis;
+    cell.split = split;
+    cell.left = left;
+    cell.right = right;
+    return cell_index;
+}
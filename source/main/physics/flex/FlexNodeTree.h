@@ -0,0 +1,128 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Static k-d tree over the forset nodes of a flexbody, for binding mesh vertices
+///        to their locator nodes (see `FlexBody::FlexBody()`).
+///        Standard library only, so that microbenchmarks can include it.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace RoR {
+
+class FlexNodeTree
+{
+public:
+    /// `positions` are `count` xyz triples; queries return indices into them.
+    void Build(const float* positions, int count);
+
+    /// Nearest point for which `accept(index)` holds, or -1 if there's none.
+    /// Ties go to the lowest index, so results match a linear search in input order.
+    template <typename F>
+    int FindNearest(const float* point, F const& accept) const
+    {
+        Result result;
+        if (!m_cells.empty())
+        {
+            this->Search(0, point, accept, result);
+        }
+        return result.index;
+    }
+
+    /// Nearest two points, in the same order as `FindNearest()` would rank them; -1 where there's none.
+    void FindNearestTwo(const float* point, int& out_first, int& out_second) const;
+
+private:
+    static const int LEAF_SIZE = 8;
+
+    struct Cell
+    {
+        float    split;        //!< Inner cells: left child has coords <= split, right child >= split
+        int32_t  axis;         //!< -1 for leaves
+        int32_t  begin, end;   //!< Leaves: range of `m_points`
+        int32_t  left, right;  //!< Inner cells: child cells
+    };
+
+    struct Point
+    {
+        float    pos[3];
+        int32_t  index;
+    };
+
+    struct Result
+    {
+        float    distance = 0.f;
+        int      index = -1;
+    };
+
+    int        BuildCell(int begin, int end);
+    void       SearchTwo(int cell_index, const float* point, Result& first, Result& second) const;
+
+    static bool IsCloser(float distance, int index, Result const& result)
+    {
+        return result.index == -1 || distance < result.distance ||
+            (distance == result.distance && index < result.index);
+    }
+
+    static float GetSquaredDistance(const float* a, const float* b)
+    {
+        // Same formula as `Ogre::Vector3::squaredDistance()`, so that ties resolve identically
+        const float dx = a[0] - b[0];
+        const float dy = a[1] - b[1];
+        const float dz = a[2] - b[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    template <typename F>
+    void Search(int cell_index, const float* point, F const& accept, Result& result) const
+    {
+        Cell const& cell = m_cells[cell_index];
+        if (cell.axis < 0)
+        {
+            for (int i = cell.begin; i < cell.end; i++)
+            {
+                Point const& p = m_points[i];
+                const float distance = GetSquaredDistance(point, p.pos);
+                if (IsCloser(distance, p.index, result) && accept(p.index))
+                {
+                    result.distance = distance;
+                    result.index = p.index;
+                }
+            }
+            return;
+        }
+
+        const float diff = point[cell.axis] - cell.split;
+        const int first = (diff <= 0.f) ? cell.left : cell.right;
+        const int second = (diff <= 0.f) ? cell.right : cell.left;
+        this->Search(first, point, accept, result);
+        if (result.index == -1 || diff * diff <= result.distance)
+        {
+            this->Search(second, point, accept, result);
+        }
+    }
+
+    std::vector<Cell>  m_cells;   //!< Root first
+    std::vector<Point> m_points;
+};
+
+} // namespace RoR
@@ -47,8 +47,10 @@ void Console::CVarSetupBuiltins()
     App::sim_terrain_gui_name    = this->CVarCreate("sim_terrain_gui_name",    "",                           0);
     App::sim_spawn_running       = this->CVarCreate("sim_spawn_running",       "Engines spawn running",      CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "true");
     App::sim_replay_enabled      = this->CVarCreate("sim_replay_enabled",      "Replay mode",                CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
-    App::sim_replay_length       = this->CVarCreate("sim_replay_length",       "Replay length",              CVAR_ARCHIVE | CVAR_TYPE_INT,     "200");
-    App::sim_replay_stepping     = this->CVarCreate("sim_replay_stepping",     "Replay Steps per second",    CVAR_ARCHIVE | CVAR_TYPE_INT,     "1000");
+    App::sim_replay_length       = this->CVarCreate("sim_replay_length",       "Replay length",              CVAR_ARCHIVE | CVAR_TYPE_INT,     "18000");
+    App::sim_replay_stepping     = this->CVarCreate("sim_replay_stepping",     "Replay Steps per second",    CVAR_ARCHIVE | CVAR_TYPE_INT,     "30");
+    App::sim_replay_memory       = this->CVarCreate("sim_replay_memory",       "Replay memory (MiB)",        CVAR_ARCHIVE | CVAR_TYPE_INT,     "64");
+    App::sim_replay_quantization = this->CVarCreate("sim_replay_quantization", "Replay position step (mm)",  CVAR_ARCHIVE | CVAR_TYPE_FLOAT,   "1.0");
     App::sim_realistic_commands  = this->CVarCreate("sim_realistic_commands",  "Realistic forward commands", CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
     App::sim_races_enabled       = this->CVarCreate("sim_races_enabled",       "Races",                      CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "true");
     App::sim_no_collisions       = this->CVarCreate("sim_no_collisions",       "DisableCollisions",          CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
@@ -56,6 +58,10 @@ void Console::CVarSetupBuiltins()
     App::sim_gearbox_mode        = this->CVarCreate("sim_gearbox_mode",        "GearboxMode",                CVAR_ARCHIVE | CVAR_TYPE_INT);
     App::sim_soft_reset_mode     = this->CVarCreate("sim_soft_reset_mode",     "",                                          CVAR_TYPE_BOOL,    "false");
     App::sim_quickload_dialog    = this->CVarCreate("sim_quickload_dialog",    "",                           CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "true");
+    App::sim_savegame_binary     = this->CVarCreate("sim_savegame_binary",     "",                           CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
+    App::sim_autosave_interval   = this->CVarCreate("sim_autosave_interval",   "",                           CVAR_ARCHIVE | CVAR_TYPE_INT,     "0");
+    App::sim_parallel_forces     = this->CVarCreate("sim_parallel_forces",     "",                           CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
+    App::sim_step_pipeline       = this->CVarCreate("sim_step_pipeline",       "",                           CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "true");
 
     App::mp_state                = this->CVarCreate("mp_state",                "",                                          CVAR_TYPE_INT,     "0"/*(int)MpState::DISABLED*/);
     App::mp_join_on_startup      = this->CVarCreate("mp_join_on_startup",      "Auto connect",               CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
@@ -69,6 +75,8 @@ void Console::CVarSetupBuiltins()
     App::mp_player_name          = this->CVarCreate("mp_player_name",          "Nickname",                   CVAR_ARCHIVE,                     "Player");
     App::mp_player_token         = this->CVarCreate("mp_player_token",         "User Token",                 CVAR_ARCHIVE | CVAR_NO_LOG);
     App::mp_api_url              = this->CVarCreate("mp_api_url",              "Online API URL",             CVAR_ARCHIVE,                     "http://api.rigsofrods.org");
+    App::mp_send_budget          = this->CVarCreate("mp_send_budget",          "Upload budget (KiB/s)",      CVAR_ARCHIVE | CVAR_TYPE_INT,     "128");
+    App::mp_record_node_stream   = this->CVarCreate("mp_record_node_stream",   "",                                          CVAR_TYPE_BOOL,    "false");
 
     App::diag_auto_spawner_report= this->CVarCreate("diag_auto_spawner_report","AutoActorSpawnerReport",     CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
     App::diag_camera             = this->CVarCreate("diag_camera",             "Camera Debug",               CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
@@ -106,6 +114,7 @@ void Console::CVarSetupBuiltins()
     App::sys_profiler_dir        = this->CVarCreate("sys_profiler_dir",        "Profiler output dir",        0);
     App::sys_savegames_dir       = this->CVarCreate("sys_savegames_dir",       "",                           0);
     App::sys_screenshot_dir      = this->CVarCreate("sys_screenshot_dir",      "",                           0);
+    App::sys_replays_dir         = this->CVarCreate("sys_replays_dir",         "",                           0);
 
     App::cli_server_host         = this->CVarCreate("cli_server_host",         "",                           0);
     App::cli_server_port         = this->CVarCreate("cli_server_port",         "",                                          CVAR_TYPE_INT,     "0");
@@ -171,6 +180,9 @@ void Console::CVarSetupBuiltins()
     App::gfx_speedo_digital      = this->CVarCreate("gfx_speedo_digital",      "DigitalSpeedo",              CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "true");
     App::gfx_speedo_imperial     = this->CVarCreate("gfx_speedo_imperial",     "gfx_speedo_imperial",        CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
     App::gfx_flexbody_cache      = this->CVarCreate("gfx_flexbody_cache",      "Flexbody_UseCache",          CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
+    App::gfx_flexbody_lod_distance= this->CVarCreate("gfx_flexbody_lod_distance","",                         CVAR_ARCHIVE | CVAR_TYPE_FLOAT,   "80");
+    App::gfx_flexbody_lod_rigid_distance= this->CVarCreate("gfx_flexbody_lod_rigid_distance","",             CVAR_ARCHIVE | CVAR_TYPE_FLOAT,   "250");
+    App::gfx_flexbody_lod_interval= this->CVarCreate("gfx_flexbody_lod_interval","",                         CVAR_ARCHIVE | CVAR_TYPE_INT,     "4");
     App::gfx_reduce_shadows      = this->CVarCreate("gfx_reduce_shadows",      "Shadow optimizations",       CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "true");
     App::gfx_enable_rtshaders    = this->CVarCreate("gfx_enable_rtshaders",    "Use RTShader System",        CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
     App::gfx_classic_shaders     = this->CVarCreate("gfx_classic_shaders",     "Classic material shaders",   CVAR_ARCHIVE | CVAR_TYPE_BOOL,    "false");
@@ -32,11 +32,14 @@
 #include "Language.h"
 #include "Network.h"
 #include "OverlayWrapper.h"
+#include "PlatformUtils.h"
+#include "Replay.h"
 #include "RoRnet.h"
 #include "RoRVersion.h"
 #include "ScriptEngine.h"
 #include "TerrainManager.h"
 #include "TerrainObjectManager.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 
 #include <algorithm>
@@ -583,6 +586,199 @@ public:
     }
 };
 
+class ThreadpoolCmd: public ConsoleCmd
+{
+public:
+    ThreadpoolCmd(): ConsoleCmd("threadpool", "[reset]", _L("threadpool - shows worker thread statistics, 'reset' clears them")) {}
+
+    void Run(Ogre::StringVector const& args) override
+    {
+        Str<200> reply;
+        reply << m_name << ": ";
+        Console::MessageType reply_type = Console::CONSOLE_SYSTEM_REPLY;
+
+        if (args.size() > 1 && args[1] == "reset")
+        {
+            App::GetThreadPool()->ResetStats();
+            reply << _L("statistics cleared");
+        }
+        else
+        {
+            const ThreadPoolStats stats = App::GetThreadPool()->GetStats();
+            reply << stats.tps_num_workers << _L(" workers, ")
+                  << static_cast<size_t>(stats.tps_tasks_run) << _L(" tasks run, ")
+                  << static_cast<size_t>(stats.tps_steals) << _L(" steals, ")
+                  << static_cast<size_t>(stats.tps_helped) << _L(" helped by waiters, ")
+                  << static_cast<float>(stats.tps_idle_us / 1000) / 1000.f << _L("s idle, queue depth ")
+                  << stats.tps_queue_depth << " (" << _L("max ") << stats.tps_max_queue_depth << ")";
+        }
+
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, reply_type, reply.ToCStr());
+    }
+};
+
+class SteptimeCmd: public ConsoleCmd
+{
+public:
+    SteptimeCmd(): ConsoleCmd("steptime", "[reset]", _L("steptime - shows wall time per physics step, 'reset' clears it")) {}
+
+    void Run(Ogre::StringVector const& args) override
+    {
+        Str<200> reply;
+        reply << m_name << ": ";
+        Console::MessageType reply_type = Console::CONSOLE_SYSTEM_REPLY;
+
+        ActorManager* actor_mgr = App::GetGameContext()->GetActorManager();
+        if (args.size() > 1 && args[1] == "reset")
+        {
+            actor_mgr->ResetPhysicsStepStats();
+            reply << _L("statistics cleared");
+        }
+        else
+        {
+            const ActorManager::PhysicsStepStats stats = actor_mgr->GetPhysicsStepStats();
+            const float avg_us = (stats.pss_num_steps > 0) ? static_cast<float>(stats.pss_total_us / stats.pss_num_steps) : 0.f;
+            reply << avg_us << _L("us average, ") << stats.pss_max_us << _L("us worst frame (")
+                  << stats.pss_num_steps << _L(" steps, ") << stats.pss_num_frames << _L(" frames, ")
+                  << (App::sim_step_pipeline->GetBool() ? _L("pipeline") : _L("fork/join")) << ")";
+        }
+
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, reply_type, reply.ToCStr());
+    }
+};
+
+class FlexbodiesCmd: public ConsoleCmd
+{
+public:
+    FlexbodiesCmd(): ConsoleCmd("flexbodies", "[]", _L("flexbodies - shows how many flexbody vertices were deformed last frame")) {}
+
+    void Run(Ogre::StringVector const& args) override
+    {
+        Str<300> reply;
+        reply << m_name << ": ";
+        Console::MessageType reply_type = Console::CONSOLE_SYSTEM_REPLY;
+
+        const FlexBodyStats stats = App::GetGfxScene()->GetFlexbodyStats();
+        reply << stats.fbs_vertices_deformed << _L(" of ") << stats.fbs_vertices_visible
+              << _L(" visible vertices deformed; ") << stats.fbs_num_deformed << _L(" of ") << stats.fbs_num_visible
+              << _L(" visible flexbodies deformed, ") << stats.fbs_num_reduced_rate << _L(" at reduced rate, ")
+              << stats.fbs_num_rigid << _L(" rigid (see 'gfx_flexbody_lod_*')");
+
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, reply_type, reply.ToCStr());
+    }
+};
+
+class ReplayCmd: public ConsoleCmd
+{
+public:
+    ReplayCmd(): ConsoleCmd("replay", "[save [<name>]|stop|load <name>|unload]", _L("replay - saves the replay to 'replays' dir or plays a saved one")) {}
+
+    void Run(Ogre::StringVector const& args) override
+    {
+        Str<500> reply;
+        reply << m_name << ": ";
+        Console::MessageType reply_type = Console::CONSOLE_SYSTEM_REPLY;
+
+        ActorManager* actor_mgr = App::GetGameContext()->GetActorManager();
+        actor_mgr->SyncWithSimThread(); // The recorder runs on the sim thread
+        Replay* replay = actor_mgr->GetReplay();
+        const std::string name = (args.size() > 2) ? args[2] : "replay";
+        const std::string path = PathCombine(App::sys_replays_dir->GetStr(), name + ".rpl");
+
+        if (replay == nullptr)
+        {
+            reply_type = Console::CONSOLE_SYSTEM_ERROR;
+            reply << _L("replay mode is disabled, see 'sim_replay_enabled'");
+        }
+        else if (args.size() > 1 && args[1] == "save")
+        {
+            if (!FolderExists(App::sys_replays_dir->GetStr()))
+                CreateFolder(App::sys_replays_dir->GetStr());
+            if (replay->SaveFile(path))
+            {
+                reply << _L("saving to ") << path;
+            }
+            else
+            {
+                reply_type = Console::CONSOLE_SYSTEM_ERROR;
+                reply << _L("cannot write ") << path;
+            }
+        }
+        else if (args.size() > 1 && args[1] == "stop")
+        {
+            replay->StopSaving();
+            reply << _L("saving stopped");
+        }
+        else if (args.size() > 2 && args[1] == "load")
+        {
+            if (replay->LoadFile(path, actor_mgr->GetActors()))
+            {
+                reply << _L("playing ") << path << ", " << replay->getNumFrames() << _L(" frames");
+            }
+            else
+            {
+                reply_type = Console::CONSOLE_SYSTEM_ERROR;
+                reply << _L("cannot play ") << path << _L(" (see log; the recorded vehicles must be spawned)");
+            }
+        }
+        else if (args.size() > 1 && args[1] == "unload")
+        {
+            replay->UnloadFile();
+            reply << _L("back to live replay");
+        }
+        else
+        {
+            reply << replay->getNumFrames() << _L(" frames, ") << replay->getMemoryUsage() / 1024 << _L(" kB memory");
+            if (replay->IsSaving())
+                reply << _L("; saving to ") << replay->GetFileWriter().GetPath() << " (" << static_cast<size_t>(replay->GetFileWriter().GetNumBytes() / 1024) << _L(" kB)");
+            if (replay->IsFileLoaded())
+                reply << _L("; playing ") << replay->GetLoadedFilePath();
+        }
+
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, reply_type, reply.ToCStr());
+    }
+};
+
+#ifdef USE_SOCKETW
+class NetstatsCmd: public ConsoleCmd
+{
+public:
+    NetstatsCmd(): ConsoleCmd("netstats", "[reset]", _L("netstats - shows multiplayer traffic, 'reset' clears it")) {}
+
+    void Run(Ogre::StringVector const& args) override
+    {
+        Str<500> reply;
+        reply << m_name << ": ";
+        Console::MessageType reply_type = Console::CONSOLE_SYSTEM_REPLY;
+
+        if (args.size() > 1 && args[1] == "reset")
+        {
+            App::GetNetwork()->ResetRecvStats();
+            App::GetGameContext()->GetActorManager()->ResetNetSendStats();
+            reply << _L("statistics cleared");
+        }
+        else
+        {
+            const Network::NetRecvStats stats = App::GetNetwork()->GetRecvStats();
+            reply << _L("last frame ") << stats.nrs_frame_packets << _L(" packets, ")
+                  << stats.nrs_frame_bytes_received << _L(" bytes received, ")
+                  << stats.nrs_frame_bytes_copied << _L(" bytes copied; total ")
+                  << stats.nrs_num_packets << _L(" packets, ") << stats.nrs_bytes_received << _L(" bytes received, ")
+                  << stats.nrs_bytes_copied << _L(" bytes copied (worst frame ") << stats.nrs_max_frame_bytes_copied
+                  << _L("), queue peak ") << stats.nrs_max_queue_bytes << _L(" bytes, ")
+                  << stats.nrs_queue_full_waits << _L(" waits for a full queue");
+
+            const ActorManager::NetSendStats send_stats = App::GetGameContext()->GetActorManager()->GetNetSendStats();
+            reply << _L("; sent ") << send_stats.nss_num_packets << _L(" actor updates, ")
+                  << send_stats.nss_bytes_sent << _L(" bytes, ")
+                  << send_stats.nss_budget_deferrals << _L(" deferred by the upload budget");
+        }
+
+        App::GetConsole()->putMessage(Console::CONSOLE_MSGTYPE_INFO, reply_type, reply.ToCStr());
+    }
+};
+#endif // USE_SOCKETW
+
 // -------------------------------------------------------------------------------------
 // Console integration
 
@@ -604,6 +800,13 @@ void Console::RegBuiltinCommands()
     cmd = new HelpCmd();                  m_commands.insert(std::make_pair(cmd->GetName(), cmd));
     // Additions
     cmd = new ClearCmd();                 m_commands.insert(std::make_pair(cmd->GetName(), cmd));
+    cmd = new ThreadpoolCmd();            m_commands.insert(std::make_pair(cmd->GetName(), cmd));
+    cmd = new SteptimeCmd();              m_commands.insert(std::make_pair(cmd->GetName(), cmd));
+    cmd = new FlexbodiesCmd();            m_commands.insert(std::make_pair(cmd->GetName(), cmd));
+    cmd = new ReplayCmd();                m_commands.insert(std::make_pair(cmd->GetName(), cmd));
+#ifdef USE_SOCKETW
+    cmd = new NetstatsCmd();              m_commands.insert(std::make_pair(cmd->GetName(), cmd));
+#endif // USE_SOCKETW
     // CVars
     cmd = new SetCmd();                   m_commands.insert(std::make_pair(cmd->GetName(), cmd));
     cmd = new SetstringCmd();             m_commands.insert(std::make_pair(cmd->GetName(), cmd));
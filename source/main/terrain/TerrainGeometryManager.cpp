@@ -35,6 +35,11 @@
 #include <OgreLight.h>
 #include <Terrain/OgreTerrainGroup.h>
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#   define ROR_TERRAIN_X86
+#   include <emmintrin.h>
+#endif
+
 using namespace Ogre;
 using namespace RoR;
 
@@ -250,6 +255,152 @@ Ogre::Vector3 TerrainGeometryManager::getNormalAt(float x, float y, float z)
     return normal;
 }
 
+/// Same plane as getHeightAtTerrainPosition(), interpolated within the triangle
+/// instead of solving the plane equation; this form is what getHeightsAt() vectorizes.
+float TerrainGeometryManager::getHeightAtTerrainPositionBarycentric(float x, float y)
+{
+    const float factor = (float)mSize - 1.0f;
+    const int startX = static_cast<int>(x * factor);
+    const int startY = static_cast<int>(y * factor);
+    const float xParam = x * factor - startX;
+    const float yParam = y * factor - startY;
+
+    const float* row = mHeightData + startY * mSize + startX;
+    const float h0 = row[0];         // see getHeightAtTerrainPosition() for the vertex layout
+    const float h1 = row[1];
+    const float h2 = row[mSize + 1];
+    const float h3 = row[mSize];
+
+    if (startY % 2)
+    {
+        if ((1.0f - yParam) > xParam)
+            return h0 + xParam * (h1 - h0) + yParam * (h3 - h0);
+        else
+            return (h1 + h3 - h2) + xParam * (h2 - h3) + yParam * (h2 - h1);
+    }
+    else
+    {
+        if (yParam > xParam)
+            return h0 + xParam * (h2 - h3) + yParam * (h3 - h0);
+        else
+            return h0 + xParam * (h1 - h0) + yParam * (h2 - h1);
+    }
+}
+
+void TerrainGeometryManager::getHeightsAt(const float* x, const float* z, float* heights, int count)
+{
+    if (m_spec->is_flat || mIsFlat)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            heights[i] = this->getHeightAt(x[i], z[i]);
+        }
+        return;
+    }
+
+    const float scale_x = 1.0f / ((mSize - 1) *  mScale);
+    const float scale_z = 1.0f / ((mSize - 1) * -mScale);
+    const float origin_x = mBase + mPos.x;
+    const float origin_z = -mBase + mPos.z;
+    const float outside_height = terrainManager->GetDef().water_bottom_height;
+
+    int i = 0;
+#ifdef ROR_TERRAIN_X86
+    const __m128 zero   = _mm_setzero_ps();
+    const __m128 one    = _mm_set1_ps(1.0f);
+    const __m128 factor = _mm_set1_ps((float)mSize - 1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 tx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(x + i), _mm_set1_ps(origin_x)), _mm_set1_ps(scale_x));
+        const __m128 ty = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(z + i), _mm_set1_ps(origin_z)), _mm_set1_ps(scale_z));
+        const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(tx, zero), _mm_cmpgt_ps(ty, zero)),
+                                         _mm_and_ps(_mm_cmplt_ps(tx, one), _mm_cmplt_ps(ty, one)));
+        const int inside_mask = _mm_movemask_ps(inside);
+        if (inside_mask == 0)
+        {
+            _mm_storeu_ps(heights + i, _mm_set1_ps(outside_height));
+            continue;
+        }
+
+        // Grid cell and position within it; outside lanes are clamped to the first cell
+        const __m128 fx = _mm_and_ps(_mm_mul_ps(tx, factor), inside);
+        const __m128 fy = _mm_and_ps(_mm_mul_ps(ty, factor), inside);
+        const __m128i sx = _mm_cvttps_epi32(fx);
+        const __m128i sy = _mm_cvttps_epi32(fy);
+        const __m128 xp = _mm_sub_ps(fx, _mm_cvtepi32_ps(sx));
+        const __m128 yp = _mm_sub_ps(fy, _mm_cvtepi32_ps(sy));
+
+        alignas(16) int ix[4], iy[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(ix), sx);
+        _mm_store_si128(reinterpret_cast<__m128i*>(iy), sy);
+        alignas(16) float h0[4], h1[4], h2[4], h3[4], odd[4];
+        for (int l = 0; l < 4; l++)
+        {
+            const float* row = mHeightData + iy[l] * mSize + ix[l];
+            h0[l] = row[0];
+            h1[l] = row[1];
+            h2[l] = row[mSize + 1];
+            h3[l] = row[mSize];
+            odd[l] = (iy[l] % 2) ? 1.0f : 0.0f;
+        }
+        const __m128 v0 = _mm_load_ps(h0), v1 = _mm_load_ps(h1), v2 = _mm_load_ps(h2), v3 = _mm_load_ps(h3);
+
+        // All four triangle cases (see getHeightAtTerrainPositionBarycentric()), then select
+        const __m128 even_a = _mm_add_ps(v0, _mm_add_ps(_mm_mul_ps(xp, _mm_sub_ps(v2, v3)), _mm_mul_ps(yp, _mm_sub_ps(v3, v0))));
+        const __m128 even_b = _mm_add_ps(v0, _mm_add_ps(_mm_mul_ps(xp, _mm_sub_ps(v1, v0)), _mm_mul_ps(yp, _mm_sub_ps(v2, v1))));
+        const __m128 odd_a  = _mm_add_ps(v0, _mm_add_ps(_mm_mul_ps(xp, _mm_sub_ps(v1, v0)), _mm_mul_ps(yp, _mm_sub_ps(v3, v0))));
+        const __m128 odd_b  = _mm_add_ps(_mm_sub_ps(_mm_add_ps(v1, v3), v2), _mm_add_ps(_mm_mul_ps(xp, _mm_sub_ps(v2, v3)), _mm_mul_ps(yp, _mm_sub_ps(v2, v1))));
+
+        const __m128 even_sel = _mm_cmpgt_ps(yp, xp);
+        const __m128 odd_sel  = _mm_cmpgt_ps(_mm_sub_ps(one, yp), xp);
+        const __m128 even_h = _mm_or_ps(_mm_and_ps(even_sel, even_a), _mm_andnot_ps(even_sel, even_b));
+        const __m128 odd_h  = _mm_or_ps(_mm_and_ps(odd_sel, odd_a), _mm_andnot_ps(odd_sel, odd_b));
+        const __m128 is_odd = _mm_cmpgt_ps(_mm_load_ps(odd), zero);
+        const __m128 h      = _mm_or_ps(_mm_and_ps(is_odd, odd_h), _mm_andnot_ps(is_odd, even_h));
+
+        _mm_storeu_ps(heights + i, _mm_or_ps(_mm_and_ps(inside, h), _mm_andnot_ps(inside, _mm_set1_ps(outside_height))));
+    }
+#endif // ROR_TERRAIN_X86
+
+    for (; i < count; i++)
+    {
+        const float tx = (x[i] - origin_x) * scale_x;
+        const float ty = (z[i] - origin_z) * scale_z;
+        if (tx <= 0.0f || ty <= 0.0f || tx >= 1.0f || ty >= 1.0f)
+            heights[i] = outside_height;
+        else
+            heights[i] = this->getHeightAtTerrainPositionBarycentric(tx, ty);
+    }
+}
+
+void TerrainGeometryManager::getNormalsAt(const float* x, const float* y, const float* z, Ogre::Vector3* normals, int count)
+{
+    const float precision = 0.1f;
+    const int BLOCK_SIZE = 256;
+
+    for (int begin = 0; begin < count; begin += BLOCK_SIZE)
+    {
+        const int num = std::min(BLOCK_SIZE, count - begin);
+        float x_left[BLOCK_SIZE], z_front[BLOCK_SIZE];
+        for (int i = 0; i < num; i++)
+        {
+            x_left[i] = x[begin + i] - precision;
+            z_front[i] = z[begin + i] + precision;
+        }
+
+        float h_left[BLOCK_SIZE], h_front[BLOCK_SIZE];
+        this->getHeightsAt(x_left, z + begin, h_left, num);
+        this->getHeightsAt(x + begin, z_front, h_front, num);
+
+        for (int i = 0; i < num; i++)
+        {
+            Vector3& normal = normals[begin + i];
+            normal = Vector3(h_left[i] - y[begin + i], precision, y[begin + i] - h_front[i]);
+            normal.normalise();
+        }
+    }
+}
+
 bool TerrainGeometryManager::InitTerrain(std::string otc_filename)
 {
     OTCParser otc_parser;
@@ -46,6 +46,11 @@ public:
 
     Ogre::Vector3 getNormalAt(float x, float y, float z);
 
+    /// Batched getHeightAt(); vectorized, results may differ from getHeightAt() by float rounding.
+    void getHeightsAt(const float* x, const float* z, float* heights, int count);
+    /// Batched getNormalAt(), `y` being the terrain height at each point.
+    void getNormalsAt(const float* x, const float* y, const float* z, Ogre::Vector3* normals, int count);
+
     Ogre::Vector3 getMaxTerrainSize();
 
     bool isFlat() { return mIsFlat; };
@@ -56,6 +61,7 @@ public:
 private:
 
     float getHeightAtTerrainPosition(float x, float z);
+    float getHeightAtTerrainPositionBarycentric(float x, float z);
 
     bool getTerrainImage(int x, int y, Ogre::Image& img);
     bool loadTerrainConfig(Ogre::String filename);
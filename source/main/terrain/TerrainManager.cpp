@@ -508,6 +508,16 @@ Ogre::Vector3 TerrainManager::GetNormalAt(float x, float y, float z)
     return m_geometry_manager->getNormalAt(x, y, z);
 }
 
+void TerrainManager::GetHeightsAt(const float* x, const float* z, float* heights, int count)
+{
+    m_geometry_manager->getHeightsAt(x, z, heights, count);
+}
+
+void TerrainManager::GetNormalsAt(const float* x, const float* y, const float* z, Ogre::Vector3* normals, int count)
+{
+    m_geometry_manager->getNormalsAt(x, y, z, normals, count);
+}
+
 SkyManager* TerrainManager::getSkyManager()
 {
     return m_sky_manager;
@@ -79,6 +79,8 @@ public:
     float                   getGravity() const            { return m_cur_gravity; }
     float                   GetHeightAt(float x, float z);
     Ogre::Vector3           GetNormalAt(float x, float y, float z);
+    void                    GetHeightsAt(const float* x, const float* z, float* heights, int count);
+    void                    GetNormalsAt(const float* x, const float* y, const float* z, Ogre::Vector3* normals, int count);
     Ogre::Vector3           getMaxTerrainSize();
     Ogre::AxisAlignedBox    getTerrainCollisionAAB();
 
@@ -0,0 +1,319 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#   include <emmintrin.h> // _mm_pause()
+#   define ROR_JOBGRAPH_RELAX() _mm_pause()
+#else
+#   define ROR_JOBGRAPH_RELAX() std::this_thread::yield()
+#endif
+
+namespace RoR {
+
+/** \brief Reusable dependency graph of jobs, executed repeatedly by a persistent team of threads.
+ *
+ * Built once (AddSerialJob(), AddParallelJob(), Finalize()), then executed many times in a row
+ * (e.g. once per physics step) by Execute(). Jobs are grouped into stages by their dependencies;
+ * the jobs of one stage run concurrently and the stages are separated by phase barriers which
+ * spin for a while and then park, so the team stays hot through a burst of short stages.
+ *
+ * The thread calling Execute() is the master. Any number of helper threads may call Help()
+ * while the execution runs - they pick up work from the current stage and return when
+ * Execute() finishes. Helpers which arrive late simply join at the next stage.
+ *
+ * \code
+ *  JobGraph graph;
+ *  int a = graph.AddSerialJob("prepare", []{ ... });
+ *  int b = graph.AddParallelJob("compute", []{ return num_items; }, [](int i){ ... }, {a});
+ *  graph.Finalize();
+ *  // For each frame:
+ *  graph.BeginExecution();
+ *  launch helpers calling graph.Help();
+ *  graph.Execute(num_steps);
+ *  wait for helpers;
+ * \endcode
+ */
+class JobGraph
+{
+public:
+    static const int SPIN_COUNT = 4000; //!< Empty polls before a waiting thread parks
+
+    /// Job which runs once per execution, on whichever team thread grabs it.
+    int AddSerialJob(std::string const& name, std::function<void()> const& fn, std::vector<int> const& deps = std::vector<int>())
+    {
+        Job job;
+        job.jb_name = name;
+        job.jb_serial_fn = fn;
+        job.jb_deps = deps;
+        m_jobs.push_back(job);
+        return static_cast<int>(m_jobs.size()) - 1;
+    }
+
+    /// Job of `count()` independent items, spread over the team; `count()` is evaluated by the master when the stage starts.
+    int AddParallelJob(std::string const& name, std::function<int()> const& count, std::function<void(int)> const& fn,
+                       std::vector<int> const& deps = std::vector<int>())
+    {
+        Job job;
+        job.jb_name = name;
+        job.jb_count_fn = count;
+        job.jb_item_fn = fn;
+        job.jb_deps = deps;
+        m_jobs.push_back(job);
+        return static_cast<int>(m_jobs.size()) - 1;
+    }
+
+    /// Sorts jobs into stages; a job's stage is one past the latest stage of its dependencies.
+    void Finalize()
+    {
+        std::vector<int> job_stage(m_jobs.size(), 0);
+        int num_stages = 0;
+        for (size_t i = 0; i < m_jobs.size(); ++i)
+        {
+            for (int dep: m_jobs[i].jb_deps)
+            {
+                // Dependencies must be added first, which also rules out cycles.
+                job_stage[i] = std::max(job_stage[i], job_stage[dep] + 1);
+            }
+            num_stages = std::max(num_stages, job_stage[i] + 1);
+        }
+
+        m_stages.assign(num_stages, Stage());
+        for (size_t i = 0; i < m_jobs.size(); ++i)
+        {
+            m_stages[job_stage[i]].st_jobs.push_back(static_cast<int>(i));
+        }
+        for (Stage& stage: m_stages)
+        {
+            stage.st_first_item.resize(stage.st_jobs.size());
+        }
+    }
+
+    int GetNumStages() const { return static_cast<int>(m_stages.size()); }
+
+    /// Index of the current run within Execute(); valid inside job functions.
+    int GetCurrentRun() const { return m_current_run; }
+
+    /// Lets helpers in; call before launching them.
+    void BeginExecution()
+    {
+        m_active.store(true, std::memory_order_release);
+    }
+
+    /// Runs the whole graph `num_runs` times on the calling thread plus any helpers, then ends the execution.
+    void Execute(int num_runs)
+    {
+        for (m_current_run = 0; m_current_run < num_runs; ++m_current_run)
+        {
+            for (size_t s = 0; s < m_stages.size(); ++s)
+            {
+                this->RunStage(m_stages[s]);
+            }
+        }
+
+        m_active.store(false, std::memory_order_seq_cst);
+        this->WakeHelpers();
+    }
+
+    /// Entry point for helper threads; returns when Execute() finishes.
+    void Help()
+    {
+        uint32_t seen_epoch = 0;
+        while (m_active.load(std::memory_order_acquire))
+        {
+            const uint32_t epoch = m_publish_epoch.load(std::memory_order_acquire);
+            if (epoch != seen_epoch)
+            {
+                seen_epoch = epoch;
+                this->WorkOnStage();
+                continue;
+            }
+
+            // Phase barrier, helper side: wait for the next stage
+            int spins = 0;
+            while (m_publish_epoch.load(std::memory_order_acquire) == seen_epoch && m_active.load(std::memory_order_acquire))
+            {
+                if (++spins < SPIN_COUNT)
+                {
+                    ROR_JOBGRAPH_RELAX();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(m_helper_mutex);
+                m_num_parked_helpers.fetch_add(1, std::memory_order_seq_cst);
+                m_helper_cv.wait(lock, [this, seen_epoch]{
+                    return m_publish_epoch.load(std::memory_order_seq_cst) != seen_epoch || !m_active.load(std::memory_order_seq_cst); });
+                m_num_parked_helpers.fetch_sub(1, std::memory_order_seq_cst);
+            }
+        }
+    }
+
+private:
+
+    struct Job
+    {
+        std::string               jb_name;
+        std::function<void()>     jb_serial_fn;
+        std::function<int()>      jb_count_fn;
+        std::function<void(int)>  jb_item_fn;
+        std::vector<int>          jb_deps;
+    };
+
+    struct Stage
+    {
+        std::vector<int>          st_jobs;
+        std::vector<int>          st_first_item; //!< Per job; item ranges are concatenated in job order
+        int                       st_num_items = 0;
+    };
+
+    // The cursor packs everything a helper needs to claim an item without a lock:
+    // [stage sequence: 20 bits][total items: 22 bits][next item: 22 bits]
+    static const int      CURSOR_ITEM_BITS = 22;
+    static const uint64_t CURSOR_ITEM_MASK = (uint64_t(1) << CURSOR_ITEM_BITS) - 1;
+
+    static uint64_t PackCursor(uint64_t seq, uint64_t total, uint64_t next)
+    {
+        return (seq << (2 * CURSOR_ITEM_BITS)) | (total << CURSOR_ITEM_BITS) | next;
+    }
+
+    void RunStage(Stage& stage)
+    {
+        // Lay out items of all jobs in this stage
+        int num_items = 0;
+        for (size_t j = 0; j < stage.st_jobs.size(); ++j)
+        {
+            const Job& job = m_jobs[stage.st_jobs[j]];
+            stage.st_first_item[j] = num_items;
+            num_items += (job.jb_serial_fn) ? 1 : std::max(job.jb_count_fn(), 0);
+        }
+        stage.st_num_items = num_items;
+        if (num_items == 0)
+            return;
+
+        // Publish
+        m_current_stage = &stage;
+        m_items_done.store(0, std::memory_order_relaxed);
+        m_stage_seq = (m_stage_seq + 1) & ((uint64_t(1) << 20) - 1);
+        m_cursor.store(PackCursor(m_stage_seq, num_items, 0), std::memory_order_release);
+        m_publish_epoch.fetch_add(1, std::memory_order_seq_cst);
+        this->WakeHelpers();
+
+        this->WorkOnStage();
+
+        // Phase barrier, master side: wait for stragglers
+        int spins = 0;
+        while (m_items_done.load(std::memory_order_acquire) < num_items)
+        {
+            if (++spins < SPIN_COUNT)
+            {
+                ROR_JOBGRAPH_RELAX();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_master_mutex);
+            m_master_parked.store(true, std::memory_order_seq_cst);
+            m_master_cv.wait(lock, [this, num_items]{ return m_items_done.load(std::memory_order_seq_cst) >= num_items; });
+            m_master_parked.store(false, std::memory_order_seq_cst);
+        }
+    }
+
+    /// Claims and runs items of the current stage until there are none left.
+    void WorkOnStage()
+    {
+        uint64_t cursor = m_cursor.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const uint64_t next  = cursor & CURSOR_ITEM_MASK;
+            const uint64_t total = (cursor >> CURSOR_ITEM_BITS) & CURSOR_ITEM_MASK;
+            if (next >= total)
+                return;
+            if (!m_cursor.compare_exchange_weak(cursor, cursor + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                continue; // `cursor` was reloaded - possibly a newer stage, which is fine too
+
+            // The stage can't advance before this item is reported done, so its layout is stable.
+            this->RunItem(*m_current_stage, static_cast<int>(next));
+
+            const int total_items = static_cast<int>(total);
+            if (m_items_done.fetch_add(1, std::memory_order_acq_rel) + 1 == total_items)
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_master_parked.load(std::memory_order_seq_cst))
+                {
+                    std::lock_guard<std::mutex> lock(m_master_mutex);
+                    m_master_cv.notify_one();
+                }
+            }
+            cursor = m_cursor.load(std::memory_order_acquire);
+        }
+    }
+
+    void RunItem(Stage const& stage, int item)
+    {
+        size_t j = stage.st_jobs.size() - 1;
+        while (stage.st_first_item[j] > item)
+        {
+            --j;
+        }
+        const Job& job = m_jobs[stage.st_jobs[j]];
+        if (job.jb_serial_fn)
+            job.jb_serial_fn();
+        else
+            job.jb_item_fn(item - stage.st_first_item[j]);
+    }
+
+    void WakeHelpers()
+    {
+        if (m_num_parked_helpers.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_helper_mutex);
+            m_helper_cv.notify_all();
+        }
+    }
+
+    std::vector<Job>         m_jobs;
+    std::vector<Stage>       m_stages;
+    int                      m_current_run = 0;
+
+    // Stage in progress
+    Stage*                   m_current_stage = nullptr;
+    uint64_t                 m_stage_seq = 0;
+    std::atomic<uint64_t>    m_cursor{0};
+    std::atomic<int>         m_items_done{0};
+
+    // Parking
+    std::atomic<bool>        m_active{false};
+    std::atomic<uint32_t>    m_publish_epoch{0};
+    std::atomic<int>         m_num_parked_helpers{0};
+    std::mutex               m_helper_mutex;
+    std::condition_variable  m_helper_cv;
+    std::atomic<bool>        m_master_parked{false};
+    std::mutex               m_master_mutex;
+    std::condition_variable  m_master_cv;
+};
+
+} // namespace RoR
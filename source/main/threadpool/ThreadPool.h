@@ -1,220 +1,709 @@
-/*
-This source file is part of Rigs of Rods
-Copyright 2016 Fabian Killus
-
-For more information, see http://www.rigsofrods.org/
-
-Rigs of Rods is free software: you can redistribute it and/or modify
-it under the terms of the GNU General Public License version 3, as
-published by the Free Software Foundation.
-
-Rigs of Rods is distributed in the hope that it will be useful,
-but WITHOUT ANY WARRANTY; without even the implied warranty of
-MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-GNU General Public License for more details.
-
-You should have received a copy of the GNU General Public License
-along with Rigs of Rods.  If not, see <http://www.gnu.org/licenses/>.
-*/
-
-#pragma once
-
-#include "Application.h"
-
-#include <atomic>
-#include <condition_variable>
-#include <functional>
-#include <memory>
-#include <mutex>
-#include <queue>
-#include <thread>
-#include <stdexcept>
-#include <vector>
-
-namespace RoR {
-
-/** /brief Handle for a task executed by ThreadPool
- *
- * Returned by ThreadPool instance when submitting a new task to run.
- * Provides a thin wrapper around the callable object which implements the actual task.
- * Allows for synchronization, i.e. to wait for the associated task to finish (see join()).
- *
- * \see ThreadPool
- */
-class Task
-{
-    friend class ThreadPool;
-    public:
-    /// Block the current thread and wait for the associated task to finish.
-    void join() const
-    {
-        // Wait until the tasks is_finished property is set to true by the ThreadPool instance.
-        // Three possible scenarios:
-        // 1) Execution of task has not started yet
-        //    - locks task_mutex
-        //    - is_finished will be false
-        //    - therefore unlocks task_mutex again and waits until signaled by thread pool
-        //    - then is_finished will be true (except in case of spurious wakeups for which the waiting continues)
-        // 2) Task is being executed
-        //    - will try to lock task_mutex, but will fail
-        //    - task_mutex is locked while the task is still running
-        //    - is_finished will be true after aquiring the lock
-        // 3) Task has already finished execution
-        //    - locks task_mutex
-        //    - is_finished will be true
-        std::unique_lock<std::mutex> lock(m_task_mutex);
-        m_finish_cv.wait(lock, [this]{ return m_is_finished; });
-    }
-
-    private:
-    // Only constructable by friend class ThreadPool
-    Task(std::function<void()> task_func) : m_task_func(task_func) {}
-    Task(Task &) = delete;
-    Task & operator=(Task &) = delete;
-
-    bool m_is_finished = false;                   //!< Indicates whether the task execution has finished.
-    mutable std::condition_variable m_finish_cv;  //!< Used to signal the current thread when the task has finished.
-    mutable std::mutex m_task_mutex;              //!< Mutex which is locked while the task is running.
-    const std::function<void()> m_task_func;      //!< Callable object which implements the task to execute.
-};
-
-/** \brief Facilitates execution of (small) tasks on separate threads.
- *
- * Implements a "rent-a-thread" model where each submitted task is assigned to one of several worker threads managed by the thread pool instance.
- * This is especially useful for short running tasks as it avoids the runtime cost of creating and launching a new thread. Notice, there
- * still is a certain overhead present due to the synchronization of threads required in the internal implementation.
- *
- * Usage example 1:
- * \code
- *  ThreadPool tp;
- *  auto task_handle = tp.RunTask([]{ SomeWork() };  // Start asynchronous task
- *  SomeOtherWork();
- *  task_handle.join(); // Wait for async task to finish
- * \endcode
- *
- * Usage example 2:
- * \code
- *  ThreadPool tp;
- *  auto task1 = []{ ... };
- *  auto task2 = std::bind(my_func, arg1, arg2);
- *  tp.Parallelize({task1, task2});  // Run tasks in parallel and wait until all have finished
- * \endcode
- *
- * \see Task
- */
-class ThreadPool {
-public:
-    static ThreadPool* DetectNumWorkersAndCreate()
-    {
-        // Create general-purpose thread pool
-        int logical_cores = std::thread::hardware_concurrency();
-
-        int num_threads = App::app_num_workers->GetInt();
-        if (num_threads < 1 || num_threads > logical_cores)
-        {
-            num_threads = Ogre::Math::Clamp(logical_cores - 1, 1, 8);
-            App::app_num_workers->SetVal(num_threads);
-        }
-
-        RoR::LogFormat("[RoR|ThreadPool] Found %d logical CPU cores, creating %d worker threads",
-                  logical_cores, num_threads);
-
-        return new ThreadPool(num_threads);
-    }
-
-    /** \brief Construct thread pool and launch worker threads.
-     *
-     * @param num_threads Number of worker threads to use
-     */
-    ThreadPool(int num_threads)
-    {
-        ROR_ASSERT(num_threads > 0);
-
-        // Generic function (to be run on a separate thread) within which submitted tasks
-        // are executed. It implements an endless loop (only returning when the ThreadPool
-        // instance itself is destructed) which constantly checks the task queue, grabbing
-        // and executing the frontmost task while the queue is not empty.
-        auto thread_body = [this]{ 
-            while (true) {
-                // Get next task from queue (synchronized access via taskqueue_mutex).
-                // If the queue is empty wait until either
-                //   - being signaled about an available task.
-                //   - the terminate flag is true (i.e. the ThreadPool instance is being destructed).
-                //     In this case return from the running thread.
-                std::unique_lock<std::mutex> queue_lock(m_taskqueue_mutex);
-                while (m_taskqueue.empty()) {
-                    if (m_terminate.load()) { return; }
-                    m_task_available_cv.wait(queue_lock);
-                }
-                const auto current_task = m_taskqueue.front();
-                m_taskqueue.pop();
-                queue_lock.unlock();
-
-                // Execute the actual task and signal the associated Task instance when finished.
-                {
-                    std::lock_guard<std::mutex> task_lock(current_task->m_task_mutex);
-                    current_task->m_task_func();
-                    current_task->m_is_finished = true;
-                }
-                current_task->m_finish_cv.notify_all();
-            }
-        };
-
-        // Launch the specified number of threads
-        for (int i = 0; i < num_threads; ++i) {
-            m_threads.emplace_back(thread_body);
-        }
-    }
-
-    ~ThreadPool() {
-        // Indicate termination and signal potential waiting threads to wake up.
-        // Then wait for all threads to finish their work and return properly.
-        m_terminate = true;
-        m_task_available_cv.notify_all();
-        for (auto &t : m_threads) { t.join(); }
-    }
-
-    /// Submit new asynchronous task to thread pool and return Task handle to allow for synchronization.
-    std::shared_ptr<Task> RunTask(const std::function<void()> &task_func) {
-        // Wrap provided task callable object in task handle. Then append it to the task queue and
-        // notify a waiting worker thread (if any) about the newly available task
-        auto task = std::shared_ptr<Task>(new Task(task_func));
-        {
-            std::lock_guard<std::mutex> lock(m_taskqueue_mutex);
-            m_taskqueue.push(task);
-        }
-        m_task_available_cv.notify_one();
-
-        // Return task handle for later synchronization
-        return task;
-    }
-
-    /// Run collection of tasks in parallel and wait until all have finished.
-    void Parallelize(const std::vector<std::function<void()>> &task_funcs)
-    {
-        if (task_funcs.empty()) return;
-
-        // Launch all provided tasks (except for the first) in parallel and store the associated handles
-        auto it = begin(task_funcs);
-        const auto first_task = it++;
-        std::vector<std::shared_ptr<Task>> handles;
-        for(; it != end(task_funcs); ++it)
-        { 
-            handles.push_back(RunTask(*it));
-        }
-
-        // Run the first task locally on the current thread
-        (*first_task)();
-
-        // Synchronize, i.e. wait for all parallelized tasks to complete
-        for(const auto &h : handles) { h->join(); }
-    }
-
-    std::atomic_bool m_terminate{false};            //!< Indicates destruction of ThreadPool instance to worker threads
-    std::vector<std::thread> m_threads;             //!< Collection of worker threads to run tasks
-    std::queue<std::shared_ptr<Task>> m_taskqueue;  //!< Queue of submitted tasks pending for execution
-    std::mutex m_taskqueue_mutex;                   //!< Protects task queue from concurrent access.
-    std::condition_variable m_task_available_cv;    //!< Used to signal threads that a new task was submitted and is ready to run.
-};
-
-} // namespace RoR
\ No newline at end of file
+/*
+This source file is part of Rigs of Rods
+Copyright 2016 Fabian Killus
+
+For more information, see http://www.rigsofrods.org/
+
+Rigs of Rods is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3, as
+published by the Free Software Foundation.
+
+Rigs of Rods is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Rigs of Rods.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Application.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#   include <emmintrin.h> // _mm_pause()
+#   define ROR_CPU_RELAX() _mm_pause()
+#else
+#   define ROR_CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace RoR {
+
+class ThreadPool;
+
+/// Entry of the pool's fixed task table; recycled, lives as long as the ThreadPool.
+struct TaskSlot
+{
+    std::function<void()>  ts_func;
+    std::atomic<uint32_t>  ts_generation{0};  //!< Incremented when the task finishes
+    std::atomic<bool>      ts_in_use{false};
+};
+
+/** \brief Handle for a task executed by ThreadPool
+ *
+ * Returned by ThreadPool instance when submitting a new task to run.
+ * A plain value (no heap allocation) pointing into the pool's task table;
+ * the slot's generation counter tells whether the task has finished, so the
+ * handle stays valid even after the slot was reused for another task.
+ * A default-constructed handle counts as finished.
+ *
+ * \see ThreadPool
+ */
+class TaskHandle
+{
+    friend class ThreadPool;
+public:
+    TaskHandle() {}
+
+    /// Wait for the associated task to finish. The waiting thread helps executing queued tasks meanwhile.
+    void join() const;
+
+    bool IsFinished() const
+    {
+        return m_slot == nullptr || m_slot->ts_generation.load(std::memory_order_acquire) != m_generation;
+    }
+
+private:
+    TaskHandle(ThreadPool* pool, TaskSlot* slot, uint32_t generation)
+        : m_pool(pool), m_slot(slot), m_generation(generation) {}
+
+    ThreadPool* m_pool = nullptr;
+    TaskSlot*   m_slot = nullptr;
+    uint32_t    m_generation = 0;
+};
+
+/// Counters for diagnostics, see console command 'threadpool'
+struct ThreadPoolStats
+{
+    int         tps_num_workers = 0;
+    uint64_t    tps_tasks_run = 0;      //!< Work items executed by workers (tasks and ParallelFor() helpers)
+    uint64_t    tps_steals = 0;         //!< Work items a worker took from another worker's queue
+    uint64_t    tps_helped = 0;         //!< Work items executed by non-worker threads while waiting
+    uint64_t    tps_idle_us = 0;        //!< Total time workers spent without work (spinning or parked)
+    size_t      tps_queue_depth = 0;    //!< Work items queued right now
+    size_t      tps_max_queue_depth = 0;
+};
+
+/** \brief Facilitates execution of (small) tasks on separate threads.
+ *
+ * Work-stealing scheduler: each worker thread owns a bounded lock-free queue. Submitted work goes
+ * to the calling worker's own queue (or round-robin when submitted from outside the pool),
+ * a worker which runs out of work steals from the others. Idle workers spin briefly and then park.
+ * Threads waiting for work to finish (TaskHandle::join(), ParallelFor()) execute queued work
+ * in the meantime, so nested parallelism from within a task cannot starve the pool.
+ *
+ * Neither RunTask() nor ParallelFor() allocate memory per task: tasks live in a fixed table
+ * and ParallelFor() keeps its state on the caller's stack.
+ *
+ * Usage example 1:
+ * \code
+ *  ThreadPool tp;
+ *  TaskHandle task_handle = tp.RunTask([]{ SomeWork() };  // Start asynchronous task
+ *  SomeOtherWork();
+ *  task_handle.join(); // Wait for async task to finish
+ * \endcode
+ *
+ * Usage example 2:
+ * \code
+ *  ThreadPool tp;
+ *  tp.ParallelFor(0, num_items, 64, [&](int begin, int end) { ... });  // Run ranges in parallel and wait until all have finished
+ * \endcode
+ *
+ * \see TaskHandle
+ */
+class ThreadPool {
+    friend class TaskHandle;
+public:
+    static const size_t QUEUE_CAPACITY = 2048;  //!< Per worker; power of 2
+    static const size_t TASK_SLOTS     = 4096;  //!< Tasks in flight (RunTask()); power of 2
+    static const int    SPIN_COUNT     = 4000;  //!< Empty polls before a worker parks / a waiter blocks
+    static const int    MAX_FOR_HELPERS = 64;   //!< Work items queued by one ParallelFor() call
+
+    static ThreadPool* DetectNumWorkersAndCreate()
+    {
+        // Create general-purpose thread pool
+        int logical_cores = std::thread::hardware_concurrency();
+
+        int num_threads = App::app_num_workers->GetInt();
+        if (num_threads < 1 || num_threads > logical_cores)
+        {
+            num_threads = Ogre::Math::Clamp(logical_cores - 1, 1, 8);
+            App::app_num_workers->SetVal(num_threads);
+        }
+
+        RoR::LogFormat("[RoR|ThreadPool] Found %d logical CPU cores, creating %d worker threads",
+                  logical_cores, num_threads);
+
+        return new ThreadPool(num_threads);
+    }
+
+    /** \brief Construct thread pool and launch worker threads.
+     *
+     * @param num_threads Number of worker threads to use
+     */
+    ThreadPool(int num_threads)
+        : m_task_slots(new TaskSlot[TASK_SLOTS])
+    {
+        ROR_ASSERT(num_threads > 0);
+
+        for (int i = 0; i < num_threads; ++i)
+        {
+            m_workers.emplace_back(new Worker());
+        }
+        // Launch only after all queues exist - workers steal from each other right away.
+        for (int i = 0; i < num_threads; ++i)
+        {
+            m_workers[i]->wk_thread = std::thread([this, i]{ this->WorkerBody(i); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        // Indicate termination and wake up parked workers.
+        // Then wait for all threads to finish their work and return properly.
+        m_terminate = true;
+        {
+            std::lock_guard<std::mutex> lock(m_park_mutex);
+            m_park_cv.notify_all();
+        }
+        for (auto& w : m_workers) { w->wk_thread.join(); }
+    }
+
+    int GetNumWorkers() const { return static_cast<int>(m_workers.size()); }
+
+    /// Submit new asynchronous task to thread pool and return a handle to allow for synchronization.
+    /// If all task slots are in use, the task is executed right away on the calling thread.
+    TaskHandle RunTask(const std::function<void()> &task_func)
+    {
+        TaskSlot* slot = this->AcquireTaskSlot(task_func);
+        if (slot == nullptr)
+        {
+            task_func();
+            return TaskHandle();
+        }
+
+        const uint32_t generation = slot->ts_generation.load(std::memory_order_relaxed);
+        WorkItem item;
+        item.wi_run = &ThreadPool::RunTaskSlot;
+        item.wi_ctx = slot;
+        this->Submit(&item, 1);
+        return TaskHandle(this, slot, generation);
+    }
+
+    /// Submit a task which blocks until other threads make progress (like `JobGraph::Help()`).
+    /// Only idle workers pick these up - never a thread waiting in join() or ParallelFor(),
+    /// which might be the very thread the task waits for. If the task can't be queued,
+    /// it is not run at all and the returned handle counts as finished; use for optional work only.
+    TaskHandle RunBlockingTask(const std::function<void()> &task_func)
+    {
+        TaskSlot* slot = this->AcquireTaskSlot(task_func);
+        if (slot == nullptr)
+        {
+            return TaskHandle();
+        }
+
+        const uint32_t generation = slot->ts_generation.load(std::memory_order_relaxed);
+        WorkItem item;
+        item.wi_run = &ThreadPool::RunTaskSlot;
+        item.wi_ctx = slot;
+        if (!m_blocking_queue.Push(item))
+        {
+            slot->ts_func = nullptr;
+            slot->ts_in_use.store(false, std::memory_order_release);
+            return TaskHandle();
+        }
+        this->WakeWorkers(1);
+        return TaskHandle(this, slot, generation);
+    }
+
+    /** \brief Run `func(range_begin, range_end)` over [begin, end) cut into pieces of `grain` items; returns when all have finished.
+     *
+     * The calling thread takes part in the work. Ranges are handed out dynamically,
+     * so `func` must not depend on which thread executes which range.
+     */
+    template <typename F>
+    void ParallelFor(int begin, int end, int grain, F const& func)
+    {
+        if (end <= begin) return;
+        grain = std::max(grain, 1);
+
+        ForJob job;
+        job.fj_invoke = &ThreadPool::InvokeRange<F>;
+        job.fj_func = &func;
+        job.fj_begin = begin;
+        job.fj_end = end;
+        job.fj_grain = grain;
+        job.fj_num_chunks = (end - begin + grain - 1) / grain;
+        job.fj_next_chunk.store(0, std::memory_order_relaxed);
+
+        const int num_helpers = std::min(std::min(job.fj_num_chunks - 1, this->GetNumWorkers()), MAX_FOR_HELPERS);
+        job.fj_pending_helpers.store(std::max(num_helpers, 0), std::memory_order_relaxed);
+        if (num_helpers > 0)
+        {
+            WorkItem items[MAX_FOR_HELPERS];
+            for (int i = 0; i < num_helpers; ++i)
+            {
+                items[i].wi_run = &ThreadPool::RunForHelper;
+                items[i].wi_ctx = &job;
+            }
+            this->Submit(items, num_helpers);
+        }
+
+        job.RunChunks();
+
+        // Helpers reference `job` on our stack - wait until every one of them is done with it.
+        this->WaitUntil([&job]{ return job.fj_pending_helpers.load(std::memory_order_acquire) == 0; });
+    }
+
+    /// Run collection of tasks in parallel and wait until all have finished.
+    void Parallelize(const std::vector<std::function<void()>> &task_funcs)
+    {
+        this->ParallelFor(0, static_cast<int>(task_funcs.size()), 1, [&task_funcs](int begin, int end)
+            {
+                for (int i = begin; i < end; ++i) { task_funcs[i](); }
+            });
+    }
+
+    ThreadPoolStats GetStats() const
+    {
+        ThreadPoolStats stats;
+        stats.tps_num_workers = this->GetNumWorkers();
+        for (auto& w : m_workers)
+        {
+            stats.tps_tasks_run   += w->wk_tasks_run.load(std::memory_order_relaxed);
+            stats.tps_steals      += w->wk_steals.load(std::memory_order_relaxed);
+            stats.tps_idle_us     += w->wk_idle_us.load(std::memory_order_relaxed);
+            stats.tps_queue_depth += w->wk_queue.ApproxSize();
+        }
+        stats.tps_helped          = m_helped.load(std::memory_order_relaxed);
+        stats.tps_max_queue_depth = m_max_queue_depth.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void ResetStats()
+    {
+        for (auto& w : m_workers)
+        {
+            w->wk_tasks_run = 0;
+            w->wk_steals = 0;
+            w->wk_idle_us = 0;
+        }
+        m_helped = 0;
+        m_max_queue_depth = 0;
+    }
+
+private:
+
+    struct WorkItem
+    {
+        void (*wi_run)(void* ctx);
+        void* wi_ctx;
+    };
+
+    /// Bounded multi-producer/multi-consumer lock-free queue (D. Vyukov's array queue).
+    /// Owner and thieves both pop from the front; anyone may push.
+    class WorkQueue
+    {
+    public:
+        WorkQueue()
+        {
+            for (size_t i = 0; i < QUEUE_CAPACITY; ++i)
+            {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool Push(WorkItem const& item)
+        {
+            Cell* cell;
+            size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[pos & (QUEUE_CAPACITY - 1)];
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (dif == 0)
+                {
+                    if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (dif < 0)
+                {
+                    return false; // Full
+                }
+                else
+                {
+                    pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            cell->item = item;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool Pop(WorkItem& item)
+        {
+            Cell* cell;
+            size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[pos & (QUEUE_CAPACITY - 1)];
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (dif == 0)
+                {
+                    if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (dif < 0)
+                {
+                    return false; // Empty
+                }
+                else
+                {
+                    pos = m_dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            item = cell->item;
+            cell->sequence.store(pos + QUEUE_CAPACITY, std::memory_order_release);
+            return true;
+        }
+
+        size_t ApproxSize() const
+        {
+            const size_t enq = m_enqueue_pos.load(std::memory_order_relaxed);
+            const size_t deq = m_dequeue_pos.load(std::memory_order_relaxed);
+            return (enq > deq) ? (enq - deq) : 0;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            WorkItem            item;
+        };
+
+        Cell                m_cells[QUEUE_CAPACITY];
+        char                m_pad0[64];              //!< Keep producers and consumers on separate cache lines
+        std::atomic<size_t> m_enqueue_pos{0};
+        char                m_pad1[64];
+        std::atomic<size_t> m_dequeue_pos{0};
+        char                m_pad2[64];
+    };
+
+    struct Worker
+    {
+        WorkQueue              wk_queue;
+        std::thread            wk_thread;
+        std::atomic<uint64_t>  wk_tasks_run{0};
+        std::atomic<uint64_t>  wk_steals{0};
+        std::atomic<uint64_t>  wk_idle_us{0};
+    };
+
+    /// State of one ParallelFor() call; lives on the caller's stack.
+    struct ForJob
+    {
+        void (*fj_invoke)(const void* func, int begin, int end);
+        const void*       fj_func;
+        int               fj_begin;
+        int               fj_end;
+        int               fj_grain;
+        int               fj_num_chunks;
+        std::atomic<int>  fj_next_chunk;
+        std::atomic<int>  fj_pending_helpers;
+
+        void RunChunks()
+        {
+            for (;;)
+            {
+                const int chunk = fj_next_chunk.fetch_add(1, std::memory_order_relaxed);
+                if (chunk >= fj_num_chunks)
+                    return;
+                const int begin = fj_begin + chunk * fj_grain;
+                fj_invoke(fj_func, begin, std::min(begin + fj_grain, fj_end));
+            }
+        }
+    };
+
+    template <typename F>
+    static void InvokeRange(const void* func, int begin, int end)
+    {
+        (*static_cast<const F*>(func))(begin, end);
+    }
+
+    static void RunForHelper(void* ctx)
+    {
+        ForJob* job = static_cast<ForJob*>(ctx);
+        job->RunChunks();
+        job->fj_pending_helpers.fetch_sub(1, std::memory_order_release); // `job` may be gone after this
+    }
+
+    TaskSlot* AcquireTaskSlot(const std::function<void()> &task_func)
+    {
+        const size_t start = m_next_slot.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < TASK_SLOTS; ++i)
+        {
+            TaskSlot* slot = &m_task_slots[(start + i) & (TASK_SLOTS - 1)];
+            bool expected = false;
+            if (slot->ts_in_use.load(std::memory_order_relaxed) ||
+                !slot->ts_in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                continue;
+            }
+            slot->ts_func = task_func;
+            return slot;
+        }
+        return nullptr;
+    }
+
+    static void RunTaskSlot(void* ctx)
+    {
+        TaskSlot* slot = static_cast<TaskSlot*>(ctx);
+        slot->ts_func();
+        slot->ts_func = nullptr; // Release captures
+        slot->ts_generation.fetch_add(1, std::memory_order_release);
+        slot->ts_in_use.store(false, std::memory_order_release);
+    }
+
+    // Per-thread identity, so that work submitted from a worker lands in its own queue.
+    static ThreadPool*& TlsPool() { static thread_local ThreadPool* pool = nullptr; return pool; }
+    static int&         TlsIndex() { static thread_local int index = -1; return index; }
+
+    int GetCurrentWorkerIndex() const { return (TlsPool() == this) ? TlsIndex() : -1; }
+
+    void Submit(const WorkItem* items, int count)
+    {
+        const int num_workers = this->GetNumWorkers();
+        const int self = this->GetCurrentWorkerIndex();
+        for (int i = 0; i < count; ++i)
+        {
+            // Spread over queues, starting with our own (if we're a worker)
+            const int first = (self >= 0 && i == 0)
+                ? self
+                : static_cast<int>(m_next_queue.fetch_add(1, std::memory_order_relaxed) % num_workers);
+            bool pushed = false;
+            for (int k = 0; k < num_workers && !pushed; ++k)
+            {
+                WorkQueue& queue = m_workers[(first + k) % num_workers]->wk_queue;
+                pushed = queue.Push(items[i]);
+                if (pushed)
+                {
+                    this->UpdateMaxQueueDepth(queue.ApproxSize());
+                }
+            }
+            if (!pushed)
+            {
+                items[i].wi_run(items[i].wi_ctx); // All queues full - run it right here
+                this->NotifyDone();
+            }
+        }
+
+        this->WakeWorkers(count);
+    }
+
+    void WakeWorkers(int count)
+    {
+        // Wake parked workers (see WorkerBody() for the handshake)
+        m_work_epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (m_num_parked.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_park_mutex);
+            if (count > 1)
+                m_park_cv.notify_all();
+            else
+                m_park_cv.notify_one();
+        }
+    }
+
+    void UpdateMaxQueueDepth(size_t depth)
+    {
+        size_t prev = m_max_queue_depth.load(std::memory_order_relaxed);
+        while (depth > prev && !m_max_queue_depth.compare_exchange_weak(prev, depth, std::memory_order_relaxed)) {}
+    }
+
+    /// Pops from own queue first (if `self` >= 0), then steals from the others.
+    bool FindWork(int self, WorkItem& item, bool& stolen)
+    {
+        const int num_workers = this->GetNumWorkers();
+        if (self >= 0 && m_workers[self]->wk_queue.Pop(item))
+        {
+            stolen = false;
+            return true;
+        }
+        const int start = (self >= 0) ? self + 1 : static_cast<int>(m_next_queue.load(std::memory_order_relaxed) % num_workers);
+        for (int k = 0; k < num_workers; ++k)
+        {
+            const int victim = (start + k) % num_workers;
+            if (victim != self && m_workers[victim]->wk_queue.Pop(item))
+            {
+                stolen = true;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void NotifyDone()
+    {
+        // Pairs with `m_num_waiting` increment in WaitUntil() - the completed work must be visible before we look.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_num_waiting.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_done_mutex);
+            m_done_cv.notify_all();
+        }
+    }
+
+    /// Executes queued work until `done()` holds. Workers never block here (they might hold up
+    /// the work we're waiting for); other threads spin for a while and then block.
+    template <typename P>
+    void WaitUntil(P const& done)
+    {
+        const int self = this->GetCurrentWorkerIndex();
+        int spins = 0;
+        while (!done())
+        {
+            WorkItem item;
+            bool stolen = false;
+            if (this->FindWork(self, item, stolen))
+            {
+                item.wi_run(item.wi_ctx);
+                this->NotifyDone();
+                if (self >= 0)
+                {
+                    m_workers[self]->wk_tasks_run.fetch_add(1, std::memory_order_relaxed);
+                    if (stolen)
+                        m_workers[self]->wk_steals.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    m_helped.fetch_add(1, std::memory_order_relaxed);
+                }
+                spins = 0;
+            }
+            else if (self >= 0 || ++spins < SPIN_COUNT)
+            {
+                ROR_CPU_RELAX();
+            }
+            else
+            {
+                std::unique_lock<std::mutex> lock(m_done_mutex);
+                m_num_waiting.fetch_add(1, std::memory_order_seq_cst);
+                m_done_cv.wait(lock, done);
+                m_num_waiting.fetch_sub(1, std::memory_order_seq_cst);
+            }
+        }
+    }
+
+    void WorkerBody(int index)
+    {
+        TlsPool() = this;
+        TlsIndex() = index;
+        Worker& me = *m_workers[index];
+
+        typedef std::chrono::steady_clock Clock;
+        bool idle = false;
+        Clock::time_point idle_start;
+        int spins = 0;
+
+        for (;;)
+        {
+            // Handshake with Submit(): read the epoch before looking for work,
+            // then only park if it's unchanged - no wakeup can be lost.
+            const uint32_t epoch = m_work_epoch.load(std::memory_order_seq_cst);
+
+            WorkItem item;
+            bool stolen = false;
+            const bool found = this->FindWork(index, item, stolen)
+                || m_blocking_queue.Pop(item); // Only here, see RunBlockingTask()
+            if (found)
+            {
+                if (idle)
+                {
+                    me.wk_idle_us.fetch_add(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - idle_start).count()),
+                        std::memory_order_relaxed);
+                    idle = false;
+                }
+                item.wi_run(item.wi_ctx);
+                this->NotifyDone();
+                me.wk_tasks_run.fetch_add(1, std::memory_order_relaxed);
+                if (stolen)
+                    me.wk_steals.fetch_add(1, std::memory_order_relaxed);
+                spins = 0;
+                continue;
+            }
+
+            if (m_terminate.load())
+            {
+                return; // Queues are drained
+            }
+
+            if (!idle)
+            {
+                idle = true;
+                idle_start = Clock::now();
+            }
+
+            if (++spins < SPIN_COUNT)
+            {
+                ROR_CPU_RELAX();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_park_mutex);
+            m_num_parked.fetch_add(1, std::memory_order_seq_cst);
+            m_park_cv.wait(lock, [this, epoch]{
+                return m_work_epoch.load(std::memory_order_seq_cst) != epoch || m_terminate.load(); });
+            m_num_parked.fetch_sub(1, std::memory_order_seq_cst);
+            spins = 0;
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::unique_ptr<TaskSlot[]>          m_task_slots;
+    std::atomic<size_t>                  m_next_slot{0};
+    std::atomic<size_t>                  m_next_queue{0};
+    std::atomic_bool                     m_terminate{false};       //!< Indicates destruction of ThreadPool instance to worker threads
+    WorkQueue                            m_blocking_queue;         //!< RunBlockingTask(); popped by idle workers only
+
+    // Parking of idle workers
+    std::atomic<uint32_t>                m_work_epoch{0};          //!< Bumped on every submission
+    std::atomic<int>                     m_num_parked{0};
+    std::mutex                           m_park_mutex;
+    std::condition_variable              m_park_cv;
+
+    // Blocking of non-worker threads waiting for completion
+    std::atomic<int>                     m_num_waiting{0};
+    std::mutex                           m_done_mutex;
+    std::condition_variable              m_done_cv;
+
+    // Diagnostics
+    std::atomic<uint64_t>                m_helped{0};
+    std::atomic<size_t>                  m_max_queue_depth{0};
+};
+
+inline void TaskHandle::join() const
+{
+    if (m_slot == nullptr)
+        return;
+
+    const TaskSlot* slot = m_slot;
+    const uint32_t generation = m_generation;
+    m_pool->WaitUntil([slot, generation]{
+        return slot->ts_generation.load(std::memory_order_acquire) != generation; });
+}
+
+} // namespace RoR
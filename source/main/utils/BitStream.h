@@ -0,0 +1,196 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Bit packing and Exp-Golomb coding shared by the network node stream and the replay recorder.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#   include <intrin.h>
+#endif
+
+namespace RoR {
+
+static const int BITSTREAM_MAX_GOLOMB_K = 15;
+
+inline uint32_t ZigZag(int32_t v)    { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+inline int32_t  UnZigZag(uint32_t u) { return static_cast<int32_t>(u >> 1) ^ -static_cast<int32_t>(u & 1); }
+
+inline int FloorLog2(uint32_t v) // v > 0
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, v);
+    return static_cast<int>(index);
+#else
+    return 31 - __builtin_clz(v);
+#endif
+}
+
+inline int CountTrailingZeros(uint64_t v) // v > 0
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+/// LSB-first bit packing
+class BitWriter
+{
+public:
+    BitWriter(uint8_t* out, size_t capacity): m_out(out), m_capacity(capacity) {}
+
+    void Put(uint32_t value, int num_bits) // num_bits <= 32
+    {
+        m_acc |= static_cast<uint64_t>(value) << m_num_bits;
+        m_num_bits += num_bits;
+        if (m_num_bits >= 32)
+        {
+            this->Emit(static_cast<uint32_t>(m_acc), 4);
+            m_acc >>= 32;
+            m_num_bits -= 32;
+        }
+    }
+
+    /// `u` < 2^31 - 2^k, so that the code fits into two Put() calls
+    void PutGolomb(uint32_t u, int k)
+    {
+        const uint32_t w = u + (1u << k);
+        const int nb = FloorLog2(w);
+        this->Put(1u << (nb - k), nb - k + 1);  // (nb - k) zeros, then the leading 1 of `w`
+        if (nb > 0)
+            this->Put(w & ((1u << nb) - 1), nb);
+    }
+
+    /// Returns bytes written, or 0 on overflow.
+    size_t Finish()
+    {
+        this->Emit(static_cast<uint32_t>(m_acc), (m_num_bits + 7) / 8);
+        return m_overflow ? 0 : m_pos;
+    }
+
+private:
+    void Emit(uint32_t bits, int num_bytes)
+    {
+        if (m_pos + num_bytes > m_capacity)
+        {
+            m_overflow = true;
+            return;
+        }
+        for (int i = 0; i < num_bytes; i++)
+            m_out[m_pos++] = static_cast<uint8_t>(bits >> (i * 8));
+    }
+
+    uint8_t* m_out;
+    size_t   m_capacity;
+    size_t   m_pos = 0;
+    uint64_t m_acc = 0;
+    int      m_num_bits = 0;
+    bool     m_overflow = false;
+};
+
+class BitReader
+{
+public:
+    BitReader(const uint8_t* in, size_t size): m_in(in), m_size(size) {}
+
+    bool Get(int num_bits, uint32_t& value) // num_bits <= 32
+    {
+        this->Refill();
+        if (m_num_bits < num_bits)
+            return false;
+        value = static_cast<uint32_t>(m_acc & ((uint64_t(1) << num_bits) - 1));
+        m_acc >>= num_bits;
+        m_num_bits -= num_bits;
+        return true;
+    }
+
+    bool GetGolomb(int k, uint32_t& u)
+    {
+        this->Refill();
+        if (m_acc == 0)
+            return false; // No terminating 1 within reach - malformed
+        const int zeros = CountTrailingZeros(m_acc);
+        if (zeros >= m_num_bits)
+            return false;
+        m_acc >>= zeros + 1;
+        m_num_bits -= zeros + 1;
+
+        const int nb = zeros + k;
+        if (nb > 31)
+            return false;
+        uint32_t low = 0;
+        if (nb > 0 && !this->Get(nb, low))
+            return false;
+        u = ((1u << nb) | low) - (1u << k);
+        return true;
+    }
+
+private:
+    void Refill()
+    {
+        while (m_num_bits <= 56 && m_pos < m_size)
+        {
+            m_acc |= static_cast<uint64_t>(m_in[m_pos++]) << m_num_bits;
+            m_num_bits += 8;
+        }
+    }
+
+    const uint8_t* m_in;
+    size_t         m_size;
+    size_t         m_pos = 0;
+    uint64_t       m_acc = 0;
+    int            m_num_bits = 0;
+};
+
+/// Exp-Golomb order with the smallest total size for `values`.
+inline int ChooseGolombK(const uint32_t* values, size_t count)
+{
+    // Estimate from a histogram of value magnitudes, one pass over the values; exact
+    // sizes aren't needed since the decoder just reads `k` from the header.
+    size_t histogram[33] = {};
+    for (size_t i = 0; i < count; i++)
+        histogram[(values[i] == 0) ? 0 : FloorLog2(values[i]) + 1]++;
+
+    int best_k = 0;
+    size_t best_bits = SIZE_MAX;
+    for (int k = 0; k <= BITSTREAM_MAX_GOLOMB_K; k++)
+    {
+        size_t bits = 0;
+        for (int len = 0; len <= 32; len++)
+            bits += histogram[len] * (2 * std::max(k, len) - k + 1);
+        if (bits < best_bits)
+        {
+            best_bits = bits;
+            best_k = k;
+        }
+    }
+    return best_k;
+}
+
+} // namespace RoR
@@ -0,0 +1,138 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "MappedFile.h"
+
+#include "Application.h"
+
+#ifdef _MSC_VER
+    #include <Windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace RoR {
+
+#ifdef _MSC_VER
+
+std::wstring MSW_Utf8ToWchar(const char* path); // PlatformUtils.cpp
+
+bool MappedFile::Open(std::string const& path)
+{
+    this->Close();
+
+    std::wstring wpath = MSW_Utf8ToWchar(path.c_str());
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        RoR::LogFormat("[RoR] Cannot open '%s' for mapping, error %lu", path.c_str(), GetLastError());
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 || static_cast<uint64_t>(size.QuadPart) > SIZE_MAX)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr)
+    {
+        RoR::LogFormat("[RoR] Cannot map '%s', error %lu", path.c_str(), GetLastError());
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    if (m_file != nullptr)
+        CloseHandle(m_file);
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_file = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(std::string const& path)
+{
+    this->Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        RoR::LogFormat("[RoR] Cannot open '%s' for mapping, errno %d", path.c_str(), errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        RoR::LogFormat("[RoR] Cannot map '%s', errno %d", path.c_str(), errno);
+        close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data != nullptr)
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    if (m_fd != -1)
+        close(m_fd);
+    m_data = nullptr;
+    m_size = 0;
+    m_fd = -1;
+}
+
+#endif // _MSC_VER
+
+} // namespace RoR
@@ -0,0 +1,58 @@
+/*
+    This source file is part of Rigs of Rods
+    Copyright 2013-2020 Petr Ohlidal
+
+    For more information, see http://www.rigsofrods.org/
+
+    Rigs of Rods is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License version 3, as
+    published by the Free Software Foundation.
+
+    Rigs of Rods is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Rigs of Rods. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// @file
+/// @brief Read-only memory mapping of a whole file; the OS pages it in on access.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace RoR {
+
+class MappedFile
+{
+public:
+    MappedFile() {}
+    ~MappedFile() { this->Close(); }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    bool           Open(std::string const& path); //!< Path must be UTF-8 encoded. Empty files can't be mapped.
+    void           Close();
+
+    bool           IsOpen() const  { return m_data != nullptr; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t         GetSize() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t         m_size = 0;
+#ifdef _MSC_VER
+    void*          m_file = nullptr;    //!< HANDLE
+    void*          m_mapping = nullptr; //!< HANDLE
+#else
+    int            m_fd = -1;
+#endif
+};
+
+} // namespace RoR
@@ -36,8 +36,13 @@
     #include <unistd.h> // readlink()
 #endif
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h> // __cpuid(), _xgetbv()
+#endif
+
 #include <OgrePlatform.h>
 #include <OgreFileSystem.h>
+#include <cstdio>
 #include <string>
 
 namespace RoR {
@@ -121,6 +126,13 @@ void CreateFolder(const char* path)
     }
 }
 
+bool RenameFileReplacing(const char* src, const char* dst)
+{
+    std::wstring wsrc = MSW_Utf8ToWchar(src);
+    std::wstring wdst = MSW_Utf8ToWchar(dst);
+    return MoveFileExW(wsrc.c_str(), wdst.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
 std::string GetUserHomeDirectory()
 {
     std::wstring out_wstr(MAX_PATH, 0); // Length limit imposed by the function, see https://msdn.microsoft.com/en-us/library/windows/desktop/bb762181(v=vs.85).aspx
@@ -171,6 +183,14 @@ void CreateFolder(const char* path)
     mkdir(path, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
 }
 
+bool RenameFileReplacing(const char* src, const char* dst)
+{
+#ifdef _WIN32
+    std::remove(dst); // Non-MSVC Windows builds: the C runtime doesn't rename over existing files
+#endif
+    return std::rename(src, dst) == 0; // POSIX: replaces `dst` atomically
+}
+
 std::string GetUserHomeDirectory()
 {
     return getenv("HOME");
@@ -231,4 +251,29 @@ std::time_t GetFileLastModifiedTime(std::string const & path)
     factory.destroyInstance(fs_archive);
     return time;
 }
+
+// -------------------------- CPU features --------------------------
+
+bool CpuSupportsAVX2()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    const bool os_uses_xsave = (info[2] & (1 << 27)) != 0;
+    const bool cpu_has_avx   = (info[2] & (1 << 28)) != 0;
+    if (!os_uses_xsave || !cpu_has_avx || (_xgetbv(0) & 0x6) != 0x6) // OS must preserve XMM+YMM state
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
 } // namespace RoR
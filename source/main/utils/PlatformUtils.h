@@ -40,6 +40,7 @@ extern char PATH_SLASH;
 bool FileExists(const char* path);   //!< Path must be UTF-8 encoded.
 bool FolderExists(const char* path); //!< Path must be UTF-8 encoded.
 void CreateFolder(const char* path); //!< Path must be UTF-8 encoded.
+bool RenameFileReplacing(const char* src, const char* dst); //!< Replaces `dst` atomically where the OS can. Paths must be UTF-8 encoded.
 
 inline bool FileExists(std::string const& path)   { return FileExists(path.c_str()); }
 inline bool FolderExists(std::string const& path) { return FolderExists(path.c_str()); }
@@ -53,4 +54,6 @@ std::string GetParentDirectory(const char* path); //!< Returns UTF-8 path withou
 
 std::time_t GetFileLastModifiedTime(std::string const & path);
 
+bool CpuSupportsAVX2(); //!< Runtime check (CPU and OS support); false on non-x86 platforms.
+
 } // namespace RoR
@@ -0,0 +1,157 @@
+#include "benchmark/benchmark.h"
+// Single-file build: both have no dependencies besides the standard library
+#include "../main/physics/flex/FlexBodyDeform.cpp"
+#include "../main/physics/flex/FlexNodeTree.cpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Per-frame flexbody deformation (`FlexBody::ComputeFlexbodyVertices()`) of a generated chassis-sized body:
+// 150k vertices in surface patches (like mesh vertex order), bound to 600 nodes with the spawn-time rules.
+// AoS in vertex order (the old code) versus SoA sorted by locator nodes, scalar and AVX2.
+// The vertex buffer upload is not part of this; it's one `writeData()` per buffer either way.
+
+const int NUM_NODES = 600;
+const int NUM_VERTICES = 150000;
+const int PATCH_SIZE = 64;
+
+struct Vec3
+{
+    float x, y, z;
+    Vec3 operator-(Vec3 const& o) const { return {x - o.x, y - o.y, z - o.z}; }
+    Vec3 operator+(Vec3 const& o) const { return {x + o.x, y + o.y, z + o.z}; }
+    Vec3 operator*(float f) const { return {x * f, y * f, z * f}; }
+    Vec3 Cross(Vec3 const& o) const { return {y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x}; }
+    float Dot(Vec3 const& o) const { return x * o.x + y * o.y + z * o.z; }
+};
+
+struct NodeSB   { Vec3 AbsPosition; bool nd_has_contact:1; bool nd_is_wet:1; }; // As in GfxActor
+struct Locator  { int ref, nx, ny, nz; Vec3 coords; };                           // As Locator_t
+
+static Vec3 FastNormalise(Vec3 v) { return v * FastInvSqrt(v.Dot(v)); }
+
+struct Flexbody
+{
+    std::vector<NodeSB>    nodes;
+    std::vector<Locator>   locators;
+    std::vector<Vec3>      src_normals;
+    FlexVertexSoa          soa;
+
+    Flexbody()
+    {
+        // A truck-sized box; vertices come in patches around random spots
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> dx(-4.f, 4.f), dy(0.f, 3.f), dz(-1.25f, 1.25f), spread(-0.15f, 0.15f), unit(-1.f, 1.f);
+        nodes.resize(NUM_NODES);
+        std::vector<float> positions;
+        for (NodeSB& n: nodes)
+        {
+            n.AbsPosition = {dx(rng), dy(rng), dz(rng)};
+            positions.push_back(n.AbsPosition.x); positions.push_back(n.AbsPosition.y); positions.push_back(n.AbsPosition.z);
+        }
+        FlexNodeTree tree;
+        tree.Build(positions.data(), NUM_NODES);
+
+        std::vector<FlexVertexBinding> bindings(NUM_VERTICES);
+        locators.resize(NUM_VERTICES);
+        src_normals.resize(NUM_VERTICES);
+        Vec3 patch = {0.f, 0.f, 0.f};
+        for (int i = 0; i < NUM_VERTICES; i++)
+        {
+            if (i % PATCH_SIZE == 0)
+                patch = {dx(rng), dy(rng), dz(rng)};
+            const Vec3 v = patch + Vec3{spread(rng), spread(rng), spread(rng)};
+            Locator& loc = locators[i];
+            tree.FindNearestTwo(&v.x, loc.ref, loc.nx);
+            const Vec3 vx = nodes[loc.nx].AbsPosition - nodes[loc.ref].AbsPosition;
+            loc.ny = tree.FindNearest(&v.x, [&](int k)
+            {
+                const Vec3 vt = nodes[k].AbsPosition - nodes[loc.ref].AbsPosition;
+                return k != loc.ref && k != loc.nx && std::abs(FastNormalise(vx).Dot(FastNormalise(vt))) <= std::sqrt(2.0f) / 2.0f;
+            });
+            loc.ny = (loc.ny == -1) ? 0 : loc.ny;
+            loc.coords = {unit(rng), unit(rng), unit(rng)};
+            src_normals[i] = {unit(rng), unit(rng), unit(rng)};
+
+            FlexVertexBinding& b = bindings[i];
+            b.ref = loc.ref; b.nx = loc.nx; b.ny = loc.ny;
+            b.coords[0] = loc.coords.x;     b.coords[1] = loc.coords.y;     b.coords[2] = loc.coords.z;
+            b.normal[0] = src_normals[i].x; b.normal[1] = src_normals[i].y; b.normal[2] = src_normals[i].z;
+        }
+        BuildFlexVertexSoa(bindings, sizeof(NodeSB) / sizeof(float), soa);
+    }
+};
+
+static Flexbody& GetFlexbody()
+{
+    static Flexbody flexbody;
+    return flexbody;
+}
+
+static void Bench_AoS_VertexOrder(benchmark::State& state)
+{
+    Flexbody& fb = GetFlexbody();
+    std::vector<Vec3> dst_pos(NUM_VERTICES), dst_normals(NUM_VERTICES);
+    const Vec3 center = fb.nodes[0].AbsPosition;
+
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < NUM_VERTICES; i++)
+        {
+            const Locator& loc = fb.locators[i];
+            const Vec3 diffX = fb.nodes[loc.nx].AbsPosition - fb.nodes[loc.ref].AbsPosition;
+            const Vec3 diffY = fb.nodes[loc.ny].AbsPosition - fb.nodes[loc.ref].AbsPosition;
+            const Vec3 nCross = FastNormalise(diffX.Cross(diffY));
+
+            dst_pos[i].x = diffX.x * loc.coords.x + diffY.x * loc.coords.y + nCross.x * loc.coords.z;
+            dst_pos[i].y = diffX.y * loc.coords.x + diffY.y * loc.coords.y + nCross.y * loc.coords.z;
+            dst_pos[i].z = diffX.z * loc.coords.x + diffY.z * loc.coords.y + nCross.z * loc.coords.z;
+            dst_pos[i] = dst_pos[i] + (fb.nodes[loc.ref].AbsPosition - center);
+
+            const Vec3& n = fb.src_normals[i];
+            dst_normals[i].x = diffX.x * n.x + diffY.x * n.y + nCross.x * n.z;
+            dst_normals[i].y = diffX.y * n.x + diffY.y * n.y + nCross.y * n.z;
+            dst_normals[i].z = diffX.z * n.x + diffY.z * n.y + nCross.z * n.z;
+            dst_normals[i] = FastNormalise(dst_normals[i]);
+        }
+        benchmark::DoNotOptimize(dst_pos.data());
+        benchmark::DoNotOptimize(dst_normals.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_VERTICES);
+}
+
+static void RunSoa(benchmark::State& state, FlexDeformFn deform)
+{
+    Flexbody& fb = GetFlexbody();
+    std::vector<float> dst(NUM_VERTICES * FLEX_VERTEX_FLOATS);
+    const float* center = &fb.nodes[0].AbsPosition.x;
+
+    while (state.KeepRunning())
+    {
+        deform(fb.soa, &fb.nodes[0].AbsPosition.x, center, 0, NUM_VERTICES, dst.data());
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_VERTICES);
+}
+
+static void Bench_SoA_Sorted_Scalar(benchmark::State& state)
+{
+    RunSoa(state, DeformFlexVerticesScalar);
+}
+
+static void Bench_SoA_Sorted_AVX2(benchmark::State& state)
+{
+    if (!__builtin_cpu_supports("avx2"))
+    {
+        state.SkipWithError("AVX2 not supported");
+        return;
+    }
+    RunSoa(state, DeformFlexVerticesAVX2);
+}
+
+BENCHMARK(Bench_AoS_VertexOrder)->Unit(benchmark::kMicrosecond);
+BENCHMARK(Bench_SoA_Sorted_Scalar)->Unit(benchmark::kMicrosecond);
+BENCHMARK(Bench_SoA_Sorted_AVX2)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
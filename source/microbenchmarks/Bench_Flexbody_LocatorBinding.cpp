@@ -0,0 +1,110 @@
+#include "benchmark/benchmark.h"
+// Single-file build: the tree has no dependencies besides the standard library
+#include "../main/physics/flex/FlexNodeTree.cpp"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Flexbody spawn without cache: binding every mesh vertex to its ref/nx/ny locator nodes
+// (`FlexBody::FlexBody()`), 200k vertices against a forset of 500 nodes.
+// Brute force (3 linear scans per vertex) versus the k-d tree (2 searches); both single-threaded.
+
+const int NUM_NODES = 500;
+const int NUM_VERTICES = 200000;
+
+struct Vec3
+{
+    float x, y, z;
+    Vec3 operator-(Vec3 const& o) const { return {x - o.x, y - o.y, z - o.z}; }
+    float SquaredDistance(Vec3 const& o) const { Vec3 d = *this - o; return d.x * d.x + d.y * d.y + d.z * d.z; }
+    float Dot(Vec3 const& o) const { return x * o.x + y * o.y + z * o.z; }
+    Vec3 Normalised() const { float l = std::sqrt(this->Dot(*this)); return (l > 1e-08f) ? Vec3{x / l, y / l, z / l} : *this; }
+};
+
+struct Locator { int ref, nx, ny; };
+
+static std::vector<Vec3> GeneratePoints(int count, unsigned seed)
+{
+    // A truck-sized box
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dx(-4.f, 4.f), dy(0.f, 3.f), dz(-1.25f, 1.25f);
+    std::vector<Vec3> points(count);
+    for (Vec3& p: points)
+        p = {dx(rng), dy(rng), dz(rng)};
+    return points;
+}
+
+static bool IsOrthogonal(std::vector<Vec3> const& nodes, Locator const& loc, Vec3 const& vx, int node)
+{
+    const float cost = vx.Dot((nodes[node] - nodes[loc.ref]).Normalised());
+    return std::abs(cost) <= std::sqrt(2.0f) / 2.0f;
+}
+
+static void Bench_BruteForce(benchmark::State& state)
+{
+    const std::vector<Vec3> nodes = GeneratePoints(NUM_NODES, 1);
+    const std::vector<Vec3> vertices = GeneratePoints(NUM_VERTICES, 2);
+    std::vector<Locator> locators(NUM_VERTICES);
+
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < NUM_VERTICES; i++)
+        {
+            Locator& loc = locators[i];
+            float best = std::numeric_limits<float>::max();
+            loc.ref = 0;
+            for (int n = 0; n < NUM_NODES; n++)
+            {
+                const float d = vertices[i].SquaredDistance(nodes[n]);
+                if (d < best) { best = d; loc.ref = n; }
+            }
+            best = std::numeric_limits<float>::max();
+            loc.nx = 0;
+            for (int n = 0; n < NUM_NODES; n++)
+            {
+                const float d = vertices[i].SquaredDistance(nodes[n]);
+                if (n != loc.ref && d < best) { best = d; loc.nx = n; }
+            }
+            const Vec3 vx = (nodes[loc.nx] - nodes[loc.ref]).Normalised();
+            best = std::numeric_limits<float>::max();
+            loc.ny = 0;
+            for (int n = 0; n < NUM_NODES; n++)
+            {
+                const float d = vertices[i].SquaredDistance(nodes[n]);
+                if (n != loc.ref && n != loc.nx && d < best && IsOrthogonal(nodes, loc, vx, n)) { best = d; loc.ny = n; }
+            }
+        }
+        benchmark::DoNotOptimize(locators.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_VERTICES);
+}
+
+static void Bench_KdTree(benchmark::State& state)
+{
+    const std::vector<Vec3> nodes = GeneratePoints(NUM_NODES, 1);
+    const std::vector<Vec3> vertices = GeneratePoints(NUM_VERTICES, 2);
+    std::vector<Locator> locators(NUM_VERTICES);
+
+    while (state.KeepRunning())
+    {
+        RoR::FlexNodeTree tree;
+        tree.Build(&nodes[0].x, NUM_NODES);
+        for (int i = 0; i < NUM_VERTICES; i++)
+        {
+            Locator& loc = locators[i];
+            const float* vertex = &vertices[i].x;
+            tree.FindNearestTwo(vertex, loc.ref, loc.nx);
+            const Vec3 vx = (nodes[loc.nx] - nodes[loc.ref]).Normalised();
+            loc.ny = tree.FindNearest(vertex, [&](int n) { return n != loc.ref && n != loc.nx && IsOrthogonal(nodes, loc, vx, n); });
+        }
+        benchmark::DoNotOptimize(locators.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_VERTICES);
+}
+
+BENCHMARK(Bench_BruteForce)->Unit(benchmark::kMillisecond);
+BENCHMARK(Bench_KdTree)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
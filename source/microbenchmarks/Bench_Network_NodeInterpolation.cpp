@@ -0,0 +1,109 @@
+#include "benchmark/benchmark.h"
+// Single-file build: the kernels have no dependencies besides the standard library
+#include "../main/network/NodeInterpolation.cpp"
+
+#include <random>
+#include <vector>
+
+// Remote actor node update per frame (`Actor::CalcNetworkNodes()`), 40 remote trucks of 600 nodes:
+// the 2020 way (decompress both bracketing packets node by node, then lerp into AoS) versus
+// packets decoded once on arrival (3 frames per packet at 10 packets/s and 30 FPS) plus the Hermite SoA kernel.
+
+const int NUM_ACTORS = 40;
+const int NUM_NODES = 600;
+const float NODE_COMPRESSION = 32767.f / 15.f;
+
+struct Vec3 { float x, y, z; };
+
+struct Packet
+{
+    float                ref[3];
+    std::vector<int16_t> nodes;
+};
+
+static std::vector<Packet> GeneratePackets()
+{
+    std::mt19937 rng(42);
+    std::vector<Packet> packets(NUM_ACTORS * 4);
+    for (Packet& p: packets)
+    {
+        p.ref[0] = 100.f; p.ref[1] = 5.f; p.ref[2] = -20.f;
+        p.nodes.resize((NUM_NODES - 1) * 3);
+        for (int16_t& v: p.nodes)
+            v = static_cast<int16_t>(rng() % 20000) - 10000;
+    }
+    return packets;
+}
+
+static void Bench_LegacyLerp(benchmark::State& state)
+{
+    const std::vector<Packet> packets = GeneratePackets();
+    std::vector<Vec3> abs_pos(NUM_NODES), vel(NUM_NODES);
+    const float tratio = 0.3f;
+
+    while (state.KeepRunning())
+    {
+        for (int a = 0; a < NUM_ACTORS; a++)
+        {
+            Packet const& p1 = packets[a * 4 + 1];
+            Packet const& p2 = packets[a * 4 + 2];
+            for (int i = 0; i < NUM_NODES; i++)
+            {
+                Vec3 v1 = {p1.ref[0], p1.ref[1], p1.ref[2]};
+                Vec3 v2 = {p2.ref[0], p2.ref[1], p2.ref[2]};
+                if (i > 0)
+                {
+                    v1.x += p1.nodes[(i - 1) * 3 + 0] / NODE_COMPRESSION; v2.x += p2.nodes[(i - 1) * 3 + 0] / NODE_COMPRESSION;
+                    v1.y += p1.nodes[(i - 1) * 3 + 1] / NODE_COMPRESSION; v2.y += p2.nodes[(i - 1) * 3 + 1] / NODE_COMPRESSION;
+                    v1.z += p1.nodes[(i - 1) * 3 + 2] / NODE_COMPRESSION; v2.z += p2.nodes[(i - 1) * 3 + 2] / NODE_COMPRESSION;
+                }
+                abs_pos[i] = {v1.x + tratio * (v2.x - v1.x), v1.y + tratio * (v2.y - v1.y), v1.z + tratio * (v2.z - v1.z)};
+                vel[i] = {(v2.x - v1.x) * 10.f, (v2.y - v1.y) * 10.f, (v2.z - v1.z) * 10.f};
+            }
+            benchmark::DoNotOptimize(abs_pos.data());
+            benchmark::DoNotOptimize(vel.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ACTORS * NUM_NODES);
+}
+
+static void Bench_DecodeOnceHermite(benchmark::State& state)
+{
+    const std::vector<Packet> packets = GeneratePackets();
+    const int stride = RoR::GetNodeSoaStride(NUM_NODES);
+    std::vector<std::vector<float>> decoded(packets.size(), std::vector<float>(3 * stride, 0.f));
+    std::vector<float> pos(3 * stride), vel(3 * stride);
+    std::vector<Vec3> abs_pos(NUM_NODES), abs_vel(NUM_NODES);
+    const RoR::NodeHermiteWeights weights = RoR::GetNodeHermiteWeights(0.3f, 100.f, 0.f, 100.f, 200.f, 300.f, 0.f);
+    int frame = 0;
+
+    while (state.KeepRunning())
+    {
+        for (int a = 0; a < NUM_ACTORS; a++)
+        {
+            // One packet arrives every third frame
+            if (frame % 3 == 0)
+            {
+                Packet const& p = packets[a * 4 + 3];
+                RoR::DecodeNodePositions(p.ref, p.nodes.data(), NUM_NODES - 1, 1.f / NODE_COMPRESSION,
+                    decoded[a * 4 + 3].data(), stride);
+            }
+            RoR::InterpolateNodePositions(decoded[a * 4].data(), decoded[a * 4 + 1].data(), decoded[a * 4 + 2].data(),
+                decoded[a * 4 + 3].data(), stride, weights, pos.data(), vel.data());
+            for (int i = 0; i < NUM_NODES; i++) // Scatter into nodes, as the actor does
+            {
+                abs_pos[i] = {pos[i], pos[stride + i], pos[2 * stride + i]};
+                abs_vel[i] = {vel[i], vel[stride + i], vel[2 * stride + i]};
+            }
+            benchmark::DoNotOptimize(abs_pos.data());
+            benchmark::DoNotOptimize(abs_vel.data());
+        }
+        frame++;
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ACTORS * NUM_NODES);
+}
+
+BENCHMARK(Bench_LegacyLerp)->Unit(benchmark::kMicrosecond);
+BENCHMARK(Bench_DecodeOnceHermite)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
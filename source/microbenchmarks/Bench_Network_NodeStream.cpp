@@ -0,0 +1,171 @@
+#include "benchmark/benchmark.h"
+// Single-file build: the codec only needs the standard library and `utils/BitStream.h` (add `-I ../main/utils`)
+#include "../main/network/NodeStreamCodec.cpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Actor node stream: bytes per packet and encode/decode time of the legacy layout (3 floats + 3 shorts
+// per node) versus NodeStreamEncode() with the keyframe policy of `Actor::WriteNodeStreamDelta()`.
+//
+// Sessions: set env var ROR_BENCH_NODESTREAM to a raw recording (int32 node count, then int16[3 * count]
+// per packet, as in `Actor::m_net_send_nodes`); the game writes one per local actor to the logs directory
+// while cvar 'mp_record_node_stream' is on in multiplayer. Without it, three synthetic sessions of a 600-node
+// actor are generated, 10 packets/s for 60s: parked, driving on a bumpy road and crashing.
+
+const int NUM_NODES = 600;
+const int NUM_PACKETS = 600;
+const float NODE_COMPRESSION = 32767.f / 15.f; // 10m truck, see `Actor::m_net_node_compression`
+
+typedef std::vector<int16_t> Packet;
+
+struct Session
+{
+    int                 num_nodes = 0;
+    std::vector<Packet> packets;
+};
+
+static bool LoadRecording(Session& session)
+{
+    const char* path = std::getenv("ROR_BENCH_NODESTREAM");
+    FILE* f = (path) ? std::fopen(path, "rb") : nullptr;
+    if (f == nullptr)
+        return false;
+
+    int32_t num_nodes = 0;
+    if (std::fread(&num_nodes, sizeof(num_nodes), 1, f) == 1 && num_nodes > 0)
+    {
+        session.num_nodes = num_nodes;
+        Packet packet(num_nodes * 3);
+        while (std::fread(packet.data(), sizeof(int16_t), packet.size(), f) == packet.size())
+            session.packets.push_back(packet);
+    }
+    std::fclose(f);
+    return !session.packets.empty();
+}
+
+enum Scenario { SCENARIO_PARKED, SCENARIO_DRIVING, SCENARIO_CRASH };
+
+static Session GenerateSession(Scenario scenario)
+{
+    Session session;
+    if (LoadRecording(session))
+        return session;
+
+    // A box-shaped truck, 10x3x3m
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> shape(0.f, 1.f);
+    std::normal_distribution<float> jitter(0.f, 0.0002f);
+    std::vector<float> rest(NUM_NODES * 3);
+    for (int i = 0; i < NUM_NODES; ++i)
+    {
+        rest[i * 3 + 0] = shape(rng) * 3.f - 1.5f;
+        rest[i * 3 + 1] = shape(rng) * 3.f;
+        rest[i * 3 + 2] = (float)i / NUM_NODES * 10.f;
+    }
+
+    session.num_nodes = NUM_NODES;
+    std::vector<float> dent(NUM_NODES * 3, 0.f);
+    for (int p = 0; p < NUM_PACKETS; ++p)
+    {
+        const float t = p * 0.1f;
+        // Relative to node 0, so only rotation and suspension travel show up
+        const float yaw = (scenario == SCENARIO_PARKED) ? 0.f : 0.3f * std::sin(t * 0.2f);
+        const float bump = (scenario == SCENARIO_PARKED) ? 0.f : 0.03f * std::sin(t * 7.f);
+        if (scenario == SCENARIO_CRASH && p == NUM_PACKETS / 2)
+        {
+            std::uniform_real_distribution<float> crush(-0.5f, 0.f);
+            for (int i = 0; i < NUM_NODES / 3; ++i)
+                dent[i * 3 + 2] = crush(rng);
+        }
+
+        Packet packet(NUM_NODES * 3);
+        for (int i = 0; i < NUM_NODES; ++i)
+        {
+            const float x = rest[i * 3 + 0] + dent[i * 3 + 0];
+            const float y = rest[i * 3 + 1] + dent[i * 3 + 1] + bump * (i % 2);
+            const float z = rest[i * 3 + 2] + dent[i * 3 + 2];
+            packet[i * 3 + 0] = (int16_t)((x * std::cos(yaw) + z * std::sin(yaw) + jitter(rng)) * NODE_COMPRESSION);
+            packet[i * 3 + 1] = (int16_t)((y + jitter(rng)) * NODE_COMPRESSION);
+            packet[i * 3 + 2] = (int16_t)((z * std::cos(yaw) - x * std::sin(yaw) + jitter(rng)) * NODE_COMPRESSION);
+        }
+        session.packets.push_back(packet);
+    }
+    return session;
+}
+
+static void Bench_Legacy(benchmark::State& state)
+{
+    const Session session = GenerateSession((Scenario)state.range(0));
+    std::vector<char> buffer(12 + session.num_nodes * 6);
+
+    while (state.KeepRunning())
+    {
+        for (Packet const& packet: session.packets)
+        {
+            std::memcpy(buffer.data() + 12, packet.data(), packet.size() * sizeof(int16_t));
+            benchmark::DoNotOptimize(buffer.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * session.packets.size());
+    state.counters["bytes_per_packet"] = (double)buffer.size();
+}
+
+static void Bench_Delta(benchmark::State& state)
+{
+    const Session session = GenerateSession((Scenario)state.range(0));
+    const size_t HEADER_SIZE = sizeof(RoR::NodeStreamHeader);
+    std::vector<uint8_t> bits(8192);
+    std::vector<uint32_t> scratch;
+    std::vector<int16_t> decoded(session.num_nodes * 3);
+    size_t total_bytes = 0;
+    size_t num_keyframes = 0;
+
+    while (state.KeepRunning())
+    {
+        Packet key;
+        size_t key_bytes = 0;
+        int since_key = 0;
+        total_bytes = 0;
+        num_keyframes = 0;
+        for (Packet const& packet: session.packets)
+        {
+            uint8_t golomb_k = 0;
+            size_t len = 0;
+            bool keyframe = key.empty() || since_key >= RoR::NODE_STREAM_KEYFRAME_INTERVAL;
+            if (!keyframe)
+            {
+                len = RoR::NodeStreamEncode(packet.data(), key.data(), session.num_nodes, golomb_k, bits.data(), bits.size(), scratch);
+                keyframe = (len == 0 || len > key_bytes * 3 / 4);
+            }
+            if (keyframe)
+            {
+                len = RoR::NodeStreamEncode(packet.data(), nullptr, session.num_nodes, golomb_k, bits.data(), bits.size(), scratch);
+                RoR::NodeStreamDecode(bits.data(), len, nullptr, session.num_nodes, golomb_k, decoded.data());
+                key = packet;
+                key_bytes = len;
+                since_key = 0;
+                num_keyframes++;
+            }
+            else
+            {
+                RoR::NodeStreamDecode(bits.data(), len, key.data(), session.num_nodes, golomb_k, decoded.data());
+                since_key++;
+            }
+            benchmark::DoNotOptimize(decoded.data());
+            total_bytes += HEADER_SIZE + len;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * session.packets.size());
+    state.counters["bytes_per_packet"] = (double)total_bytes / session.packets.size();
+    state.counters["keyframes"] = (double)num_keyframes;
+}
+
+BENCHMARK(Bench_Legacy)->Arg(SCENARIO_PARKED)->Arg(SCENARIO_DRIVING)->Arg(SCENARIO_CRASH)->Unit(benchmark::kMicrosecond);
+BENCHMARK(Bench_Delta)->Arg(SCENARIO_PARKED)->Arg(SCENARIO_DRIVING)->Arg(SCENARIO_CRASH)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
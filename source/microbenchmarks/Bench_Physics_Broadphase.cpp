@@ -0,0 +1,165 @@
+#include "benchmark/benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Inter-actor collision partner search, as done by `PointColDetector::UpdateInterPoint()`
+// for every actor every physics step: the old all-pairs AABB scan versus the per-step
+// uniform grid broadphase (physics/collision/ActorBroadphase.cpp, reduced to plain structs).
+// Actors are car-sized boxes parked along a 2x2 km map, plus a few long trains.
+
+struct Box
+{
+    float min[3], max[3];
+};
+
+static bool Intersects(Box const& a, Box const& b)
+{
+    return a.max[0] >= b.min[0] && a.min[0] <= b.max[0]
+        && a.max[1] >= b.min[1] && a.min[1] <= b.max[1]
+        && a.max[2] >= b.min[2] && a.min[2] <= b.max[2];
+}
+
+static std::vector<Box> GenerateActors(int count)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> pos(-1000.f, 1000.f);
+    std::vector<Box> boxes(count);
+    for (int i = 0; i < count; ++i)
+    {
+        const bool train = (i % 50 == 49);
+        const float x = pos(rng), z = pos(rng);
+        const float len = train ? 200.f : 5.f;
+        boxes[i] = Box{{x, 0.f, z}, {x + len, 3.f, z + 2.f}};
+    }
+    return boxes;
+}
+
+// ---------------- Old: all pairs ----------------
+
+static void Bench_AllPairs(benchmark::State& state)
+{
+    const std::vector<Box> boxes = GenerateActors(state.range(0));
+    const int n = static_cast<int>(boxes.size());
+    size_t num_pairs = 0;
+    while (state.KeepRunning())
+    {
+        for (int self = 0; self < n; ++self)
+        {
+            std::vector<int> partners;
+            for (int other = 0; other < n; ++other)
+            {
+                if (other != self && Intersects(boxes[self], boxes[other]))
+                    partners.push_back(other);
+            }
+            num_pairs += partners.size();
+        }
+    }
+    benchmark::DoNotOptimize(num_pairs);
+    state.SetItemsProcessed(state.iterations() * n); // Queries per second
+}
+
+// ---------------- New: uniform grid ----------------
+
+const float CELL_SIZE = 16.f;
+const int   MAX_ACTOR_CELLS = 64;
+
+struct CellEntry
+{
+    int64_t key;
+    int     actor;
+    bool operator<(CellEntry const& o) const { return (key != o.key) ? key < o.key : actor < o.actor; }
+};
+
+static int     CellCoord(float pos)     { return static_cast<int>(std::floor(pos / CELL_SIZE)); }
+static int64_t CellKey(int cx, int cz)  { return (static_cast<int64_t>(cx) << 32) | static_cast<uint32_t>(cz); }
+
+struct Grid
+{
+    std::vector<CellEntry> cells;
+    std::vector<int>       oversized;
+    std::vector<bool>      is_oversized;
+
+    void Update(std::vector<Box> const& boxes)
+    {
+        cells.clear();
+        oversized.clear();
+        is_oversized.assign(boxes.size(), false);
+        for (int i = 0; i < static_cast<int>(boxes.size()); ++i)
+        {
+            const int x0 = CellCoord(boxes[i].min[0]), x1 = CellCoord(boxes[i].max[0]);
+            const int z0 = CellCoord(boxes[i].min[2]), z1 = CellCoord(boxes[i].max[2]);
+            if ((x1 - x0 + 1) * (z1 - z0 + 1) > MAX_ACTOR_CELLS)
+            {
+                oversized.push_back(i);
+                is_oversized[i] = true;
+                continue;
+            }
+            for (int cx = x0; cx <= x1; ++cx)
+                for (int cz = z0; cz <= z1; ++cz)
+                    cells.push_back(CellEntry{CellKey(cx, cz), i});
+        }
+        std::sort(cells.begin(), cells.end());
+    }
+
+    void Query(std::vector<Box> const& boxes, int self, std::vector<int>& out) const
+    {
+        out.clear();
+        const Box& box = boxes[self];
+        if (is_oversized[self])
+        {
+            for (int i = 0; i < static_cast<int>(boxes.size()); ++i)
+                if (i != self && Intersects(box, boxes[i]))
+                    out.push_back(i);
+            return;
+        }
+        const int x0 = CellCoord(box.min[0]), x1 = CellCoord(box.max[0]);
+        const int z0 = CellCoord(box.min[2]), z1 = CellCoord(box.max[2]);
+        for (int cx = x0; cx <= x1; ++cx)
+        {
+            for (int cz = z0; cz <= z1; ++cz)
+            {
+                const int64_t key = CellKey(cx, cz);
+                for (auto it = std::lower_bound(cells.begin(), cells.end(), CellEntry{key, -1}); it != cells.end() && it->key == key; ++it)
+                {
+                    const Box& other = boxes[it->actor];
+                    if (it->actor == self || cx != std::max(x0, CellCoord(other.min[0])) || cz != std::max(z0, CellCoord(other.min[2])))
+                        continue;
+                    if (Intersects(box, other))
+                        out.push_back(it->actor);
+                }
+            }
+        }
+        for (int other: oversized)
+            if (Intersects(box, boxes[other]))
+                out.push_back(other);
+        std::sort(out.begin(), out.end());
+    }
+};
+
+static void Bench_Grid(benchmark::State& state)
+{
+    const std::vector<Box> boxes = GenerateActors(state.range(0));
+    const int n = static_cast<int>(boxes.size());
+    Grid grid;
+    std::vector<int> partners;
+    size_t num_pairs = 0;
+    while (state.KeepRunning())
+    {
+        grid.Update(boxes); // Once per step
+        for (int self = 0; self < n; ++self)
+        {
+            grid.Query(boxes, self, partners);
+            num_pairs += partners.size();
+        }
+    }
+    benchmark::DoNotOptimize(num_pairs);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(Bench_AllPairs)->RangeMultiplier(10)->Range(10, 1000)->Arg(300);
+BENCHMARK(Bench_Grid)->RangeMultiplier(10)->Range(10, 1000)->Arg(300);
+
+BENCHMARK_MAIN();
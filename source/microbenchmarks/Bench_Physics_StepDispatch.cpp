@@ -0,0 +1,149 @@
+#include "benchmark/benchmark.h"
+#include "../main/threadpool/JobGraph.h"
+
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Per-step wall time of `ActorManager::UpdatePhysicsSimulation()` with many small actors
+// (the traffic scenario): the fork/join dispatch as of 2020 (a batch of std::function tasks
+// through the mutex/condvar ThreadPool, twice per step) versus the persistent JobGraph team.
+// Each iteration is one frame of NUM_STEPS steps; items/s = steps per second.
+
+const int NUM_WORKERS = 4;
+const int NUM_STEPS   = 100; // Steps per simulated frame
+
+struct FakeActor
+{
+    float state[64];
+
+    void Compute()   { for (int k = 0; k < 8; ++k) for (float& s: state) s = std::sqrt(s * s + 1.f) - 0.5f; }
+    void Collide()   { for (float& s: state) s *= 0.999f; }
+};
+
+// ---------------- Old dispatch: mutex/condvar pool, task per actor ----------------
+
+class OldThreadPool
+{
+public:
+    struct Task
+    {
+        std::function<void()>   func;
+        bool                    finished = false;
+        std::mutex              mutex;
+        std::condition_variable cv;
+        void join() { std::unique_lock<std::mutex> lock(mutex); cv.wait(lock, [this]{ return finished; }); }
+    };
+
+    OldThreadPool(int num_threads)
+    {
+        for (int i = 0; i < num_threads; ++i)
+        {
+            m_threads.emplace_back([this]{
+                for (;;)
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    while (m_queue.empty())
+                    {
+                        if (m_terminate) return;
+                        m_cv.wait(lock);
+                    }
+                    auto task = m_queue.front();
+                    m_queue.pop();
+                    lock.unlock();
+                    {
+                        std::lock_guard<std::mutex> task_lock(task->mutex);
+                        task->func();
+                        task->finished = true;
+                    }
+                    task->cv.notify_all();
+                }
+            });
+        }
+    }
+
+    ~OldThreadPool()
+    {
+        { std::lock_guard<std::mutex> lock(m_mutex); m_terminate = true; }
+        m_cv.notify_all();
+        for (auto& t: m_threads) t.join();
+    }
+
+    void Parallelize(std::vector<std::function<void()>> const& funcs)
+    {
+        std::vector<std::shared_ptr<Task>> handles;
+        for (size_t i = 1; i < funcs.size(); ++i)
+        {
+            auto task = std::make_shared<Task>();
+            task->func = funcs[i];
+            { std::lock_guard<std::mutex> lock(m_mutex); m_queue.push(task); }
+            m_cv.notify_one();
+            handles.push_back(task);
+        }
+        if (!funcs.empty()) funcs[0]();
+        for (auto& h: handles) h->join();
+    }
+
+private:
+    std::vector<std::thread>           m_threads;
+    std::queue<std::shared_ptr<Task>>  m_queue;
+    std::mutex                         m_mutex;
+    std::condition_variable            m_cv;
+    bool                               m_terminate = false;
+};
+
+static void Bench_ForkJoin(benchmark::State& state)
+{
+    std::vector<FakeActor> actors(state.range(0));
+    OldThreadPool pool(NUM_WORKERS);
+
+    while (state.KeepRunning())
+    {
+        for (int step = 0; step < NUM_STEPS; ++step)
+        {
+            std::vector<std::function<void()>> tasks;
+            for (FakeActor& a: actors) tasks.push_back([&a]{ a.Compute(); });
+            pool.Parallelize(tasks);
+
+            tasks.clear();
+            for (FakeActor& a: actors) tasks.push_back([&a]{ a.Collide(); });
+            pool.Parallelize(tasks);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_STEPS); // Steps per second
+}
+
+// ---------------- New dispatch: persistent JobGraph team ----------------
+
+static void Bench_JobGraph(benchmark::State& state)
+{
+    std::vector<FakeActor> actors(state.range(0));
+    const int num_actors = static_cast<int>(actors.size());
+
+    RoR::JobGraph graph;
+    const int compute = graph.AddParallelJob("compute", [num_actors]{ return num_actors; }, [&actors](int i){ actors[i].Compute(); });
+    graph.AddParallelJob("collide", [num_actors]{ return num_actors; }, [&actors](int i){ actors[i].Collide(); }, {compute});
+    graph.Finalize();
+
+    while (state.KeepRunning())
+    {
+        // The game submits helpers to its pool once per frame; plain threads stand in for that here.
+        graph.BeginExecution();
+        std::vector<std::thread> helpers;
+        for (int i = 0; i < NUM_WORKERS; ++i) helpers.emplace_back([&graph]{ graph.Help(); });
+        graph.Execute(NUM_STEPS);
+        for (auto& t: helpers) t.join();
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_STEPS);
+}
+
+// 16 cars in a small town, 150 on a highway traffic map.
+BENCHMARK(Bench_ForkJoin)->Arg(16)->Arg(150)->UseRealTime();
+BENCHMARK(Bench_JobGraph)->Arg(16)->Arg(150)->UseRealTime();
+
+BENCHMARK_MAIN();
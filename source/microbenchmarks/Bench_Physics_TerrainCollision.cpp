@@ -0,0 +1,246 @@
+#include "benchmark/benchmark.h"
+// Single-file build: the grid has no dependencies besides the standard library
+#include "../main/physics/collision/StaticCollisionGrid.cpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Per-node static collision lookup of `Collisions::nodeCollision()` (up to the tri tests):
+// the sbox-hashed table of 1M std::vectors as of 2020 versus the StaticCollisionGrid plus packed tri bounds.
+//
+// Tri set: set env var ROR_BENCH_COLLTRIS to a raw dump of a real map's collision tris
+// (float[9] per tri, world coordinates). Without it, a synthetic 2x2 km map is generated:
+// a grid of 8m wide roads with one quad every 4m, plus 2000 box-shaped buildings of 12 tris.
+
+struct Vec3 { float x, y, z; };
+struct Tri  { Vec3 a, b, c; };
+
+const int CELL_SIZE = 2;
+const int MAXIMUM_CELL = 0x7FFF;
+const int NUM_QUERIES = 100000;
+
+static std::vector<Tri> LoadTris()
+{
+    std::vector<Tri> tris;
+    if (const char* path = std::getenv("ROR_BENCH_COLLTRIS"))
+    {
+        if (FILE* f = std::fopen(path, "rb"))
+        {
+            Tri t;
+            while (std::fread(&t, sizeof(Tri), 1, f) == 1)
+                tris.push_back(t);
+            std::fclose(f);
+            return tris;
+        }
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> bump(-0.05f, 0.05f);
+    for (float road = 100.f; road < 2000.f; road += 200.f)
+    {
+        for (float s = 0.f; s < 2000.f; s += 4.f)
+        {
+            const float h0 = 10.f + bump(rng), h1 = 10.f + bump(rng);
+            // Along X and along Z
+            tris.push_back(Tri{{s, h0, road}, {s + 4.f, h1, road}, {s, h0, road + 8.f}});
+            tris.push_back(Tri{{s + 4.f, h1, road}, {s + 4.f, h1, road + 8.f}, {s, h0, road + 8.f}});
+            tris.push_back(Tri{{road, h0, s}, {road, h1, s + 4.f}, {road + 8.f, h0, s}});
+            tris.push_back(Tri{{road, h1, s + 4.f}, {road + 8.f, h1, s + 4.f}, {road + 8.f, h0, s}});
+        }
+    }
+    std::uniform_real_distribution<float> pos(0.f, 1980.f);
+    for (int i = 0; i < 2000; ++i)
+    {
+        const float x = pos(rng), z = pos(rng), w = 10.f, h = 8.f;
+        const Vec3 p[8] = {{x,10,z},{x+w,10,z},{x+w,10,z+w},{x,10,z+w},{x,10+h,z},{x+w,10+h,z},{x+w,10+h,z+w},{x,10+h,z+w}};
+        const int faces[6][4] = {{0,1,2,3},{4,5,6,7},{0,1,5,4},{1,2,6,5},{2,3,7,6},{3,0,4,7}};
+        for (auto& f: faces)
+        {
+            tris.push_back(Tri{p[f[0]], p[f[1]], p[f[2]]});
+            tris.push_back(Tri{p[f[0]], p[f[2]], p[f[3]]});
+        }
+    }
+    return tris;
+}
+
+struct Bounds { float lo[3], hi[3]; };
+
+static Bounds GetBounds(Tri const& t)
+{
+    Bounds b;
+    const Vec3* v[3] = {&t.a, &t.b, &t.c};
+    for (int i = 0; i < 3; ++i)
+    {
+        b.lo[i] = std::min(std::min((&v[0]->x)[i], (&v[1]->x)[i]), (&v[2]->x)[i]) - 0.1f;
+        b.hi[i] = std::max(std::max((&v[0]->x)[i], (&v[1]->x)[i]), (&v[2]->x)[i]) + 0.1f;
+    }
+    return b;
+}
+
+template <typename F> static void ForEachCell(Bounds const& b, F func)
+{
+    const int x0 = std::min(std::max((int)(b.lo[0] / CELL_SIZE), 0), MAXIMUM_CELL), x1 = std::min(std::max((int)(b.hi[0] / CELL_SIZE), 0), MAXIMUM_CELL);
+    const int z0 = std::min(std::max((int)(b.lo[2] / CELL_SIZE), 0), MAXIMUM_CELL), z1 = std::min(std::max((int)(b.hi[2] / CELL_SIZE), 0), MAXIMUM_CELL);
+    for (int i = x0; i <= x1; ++i)
+        for (int j = z0; j <= z1; ++j)
+            func(i, j);
+}
+
+static std::vector<Vec3> GenerateQueries(std::vector<Tri> const& tris)
+{
+    // Nodes resting on or slightly above the collision surface
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> off(-1.f, 1.f);
+    std::vector<Vec3> q(NUM_QUERIES);
+    for (Vec3& v: q)
+    {
+        const Tri& t = tris[rng() % tris.size()];
+        v = Vec3{t.a.x + off(rng), t.a.y + 0.05f * off(rng), t.a.z + off(rng)};
+    }
+    return q;
+}
+
+// Shared part of the narrow phase: the same for both lookups
+struct Hot { Vec3 a; float forward[9]; };
+
+static bool TestTri(Hot const& h, Vec3 const& p)
+{
+    const float d[3] = {p.x - h.a.x, p.y - h.a.y, p.z - h.a.z};
+    const float x = h.forward[0]*d[0] + h.forward[1]*d[1] + h.forward[2]*d[2];
+    const float y = h.forward[3]*d[0] + h.forward[4]*d[1] + h.forward[5]*d[2];
+    const float z = h.forward[6]*d[0] + h.forward[7]*d[1] + h.forward[8]*d[2];
+    return x >= 0 && y >= 0 && x + y <= 1.f && z < 0 && z > -0.1f;
+}
+
+// ---------------- Old: sbox hash, 1M std::vector buckets ----------------
+
+namespace Old {
+
+const int HASH_POWER = 20;
+const int HASH_SIZE = 1 << HASH_POWER;
+
+struct Element { unsigned int cell_id; int element_index; };
+
+struct CollTri // Layout of `Collisions::collision_tri_t` as of 2020
+{
+    Vec3 a, b, c;
+    float aab_min[3], aab_max[3]; int aab_extent;
+    float forward[9], reverse[9];
+    void* gm;
+    bool enabled;
+};
+
+unsigned int HashFunc(unsigned int cellid)
+{
+    // Stand-in for the 256-entry sbox; the cost is in the bucket scan, not in the hash
+    unsigned int hash = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        hash ^= (((unsigned char*)&cellid)[i] * 0x9E3779B1u) ^ 0xF53E1837u;
+        hash *= 3;
+    }
+    return hash & (HASH_SIZE - 1);
+}
+
+} // namespace Old
+
+static void Bench_OldHashtable(benchmark::State& state)
+{
+    const std::vector<Tri> tris = LoadTris();
+    const std::vector<Vec3> queries = GenerateQueries(tris);
+
+    std::vector<std::vector<Old::Element>> hashtable(Old::HASH_SIZE);
+    std::vector<float> hashtable_height(Old::HASH_SIZE, 0.f);
+    std::vector<Old::CollTri> ctris(tris.size());
+    for (size_t t = 0; t < tris.size(); ++t)
+    {
+        const Bounds b = GetBounds(tris[t]);
+        Old::CollTri& c = ctris[t];
+        c.a = tris[t].a; c.b = tris[t].b; c.c = tris[t].c; c.enabled = true;
+        std::copy(b.lo, b.lo + 3, c.aab_min); std::copy(b.hi, b.hi + 3, c.aab_max);
+        std::fill(c.forward, c.forward + 9, 0.1f);
+        ForEachCell(b, [&](int i, int j) {
+            const unsigned int cell_id = (i << 16) + j;
+            const unsigned int pos = Old::HashFunc(cell_id);
+            hashtable[pos].push_back(Old::Element{cell_id, static_cast<int>(t)});
+            hashtable_height[pos] = std::max(hashtable_height[pos], b.hi[1]);
+        });
+    }
+
+    size_t hits = 0;
+    while (state.KeepRunning())
+    {
+        for (Vec3 const& p: queries)
+        {
+            const int refx = (int)(p.x / CELL_SIZE), refz = (int)(p.z / CELL_SIZE);
+            const unsigned int cell_id = (refx << 16) + refz;
+            const unsigned int hash = Old::HashFunc(cell_id);
+            if (p.y > hashtable_height[hash])
+                continue;
+            for (Old::Element const& e: hashtable[hash])
+            {
+                if (e.cell_id != cell_id)
+                    continue;
+                Old::CollTri const& c = ctris[e.element_index];
+                if (!c.enabled) continue;
+                if (p.y > c.aab_max[1] || p.y < c.aab_min[1] || p.x > c.aab_max[0] || p.x < c.aab_min[0] || p.z > c.aab_max[2] || p.z < c.aab_min[2])
+                    continue;
+                Hot h; h.a = c.a; std::copy(c.forward, c.forward + 9, h.forward);
+                hits += TestTri(h, p);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+// ---------------- New: StaticCollisionGrid + packed tri bounds ----------------
+
+static void Bench_StaticGrid(benchmark::State& state)
+{
+    const std::vector<Tri> tris = LoadTris();
+    const std::vector<Vec3> queries = GenerateQueries(tris);
+
+    RoR::StaticCollisionGrid grid;
+    std::vector<Bounds> bounds(tris.size());
+    std::vector<Hot> hot(tris.size());
+    for (size_t t = 0; t < tris.size(); ++t)
+    {
+        bounds[t] = GetBounds(tris[t]);
+        hot[t].a = tris[t].a;
+        std::fill(hot[t].forward, hot[t].forward + 9, 0.1f);
+        ForEachCell(bounds[t], [&](int i, int j) { grid.Add((i << 16) + j, static_cast<int>(t), bounds[t].hi[1]); });
+    }
+    grid.Compact();
+
+    size_t hits = 0;
+    while (state.KeepRunning())
+    {
+        for (Vec3 const& p: queries)
+        {
+            const int refx = (int)(p.x / CELL_SIZE), refz = (int)(p.z / CELL_SIZE);
+            const RoR::StaticCollisionGrid::Cell* cell = grid.Find((refx << 16) + refz);
+            if (cell == nullptr || p.y > cell->max_height)
+                continue;
+            const int* elements = grid.GetElements(*cell);
+            for (int k = 0; k < cell->count; ++k)
+            {
+                Bounds const& b = bounds[elements[k]];
+                if (p.y > b.hi[1] || p.y < b.lo[1] || p.x > b.hi[0] || p.x < b.lo[0] || p.z > b.hi[2] || p.z < b.lo[2])
+                    continue;
+                hits += TestTri(hot[elements[k]], p);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(hits);
+    state.SetItemsProcessed(state.iterations() * queries.size());
+    state.counters["grid_KiB"] = grid.GetMemoryUsage() / 1024;
+}
+
+BENCHMARK(Bench_OldHashtable)->Unit(benchmark::kMillisecond);
+BENCHMARK(Bench_StaticGrid)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
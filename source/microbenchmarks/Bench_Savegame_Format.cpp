@@ -0,0 +1,310 @@
+#include "benchmark/benchmark.h"
+// Single-file build: add the RapidJSON include dir; the binary format only needs the standard library
+#include "../main/physics/SavegameBinary.cpp"
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Savegame node/beam state: the JSON DOM of `ActorManager::SaveScene()` (one array per node and beam)
+// versus the binary blocks of SavegameBinary.h. Save = build + serialize to memory, load = parse + copy
+// into the actor. The scene metadata is left out, it's the same small JSON in both formats.
+// Convoy: 12 actors of 3000 nodes and 9000 beams (big trailers).
+// Run with: Bench_Savegame_Format --benchmark_counters_tabular=true
+
+using namespace RoR;
+
+const int NUM_ACTORS = 12;
+const int NUM_NODES = 3000;
+const int NUM_BEAMS = 9000;
+
+struct Node
+{
+    float pos[3], vel[3], init[3];
+};
+
+struct Beam
+{
+    float maxposstress, maxnegstress, minmaxposnegstress, strength, L;
+    bool  broken, disabled, inter_actor;
+    int   locked_actor;
+};
+
+struct TestActor
+{
+    std::vector<Node> nodes;
+    std::vector<Beam> beams;
+};
+
+typedef rapidjson::Writer<rapidjson::StringBuffer, rapidjson::UTF8<>, rapidjson::UTF8<>,
+                          rapidjson::CrtAllocator, rapidjson::kWriteNanAndInfFlag> JsonWriter;
+
+static std::vector<TestActor> MakeConvoy()
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> jitter(-0.01f, 0.01f);
+    std::vector<TestActor> convoy(NUM_ACTORS);
+    for (int a = 0; a < NUM_ACTORS; a++)
+    {
+        TestActor& actor = convoy[a];
+        actor.nodes.resize(NUM_NODES);
+        for (int i = 0; i < NUM_NODES; i++)
+        {
+            Node& n = actor.nodes[i];
+            n.init[0] = (i % 10) * 0.3f;
+            n.init[1] = (i / 10 % 10) * 0.3f;
+            n.init[2] = (i / 100) * 0.5f;
+            n.pos[0] = 1500.f + a * 20.f + n.init[0] + jitter(rng);
+            n.pos[1] = 40.f + n.init[1] + jitter(rng);
+            n.pos[2] = -800.f + n.init[2] + jitter(rng);
+            n.vel[0] = 12.f + jitter(rng);
+            n.vel[1] = jitter(rng);
+            n.vel[2] = jitter(rng);
+        }
+        actor.beams.resize(NUM_BEAMS);
+        for (int i = 0; i < NUM_BEAMS; i++)
+        {
+            Beam& b = actor.beams[i];
+            b.maxposstress = 1000000.f + jitter(rng);
+            b.maxnegstress = -1000000.f + jitter(rng);
+            b.minmaxposnegstress = 1000000.f;
+            b.strength = 1000000.f;
+            b.L = 0.3f + std::abs(jitter(rng));
+            b.broken = (i % 500 == 0);
+            b.disabled = false;
+            b.inter_actor = false;
+            b.locked_actor = -1;
+        }
+    }
+    return convoy;
+}
+
+static const std::vector<TestActor>& GetConvoy()
+{
+    static std::vector<TestActor> convoy = MakeConvoy();
+    return convoy;
+}
+
+// ---------------- JSON ----------------
+
+static void SaveJson(std::vector<TestActor> const& convoy, rapidjson::StringBuffer& buffer)
+{
+    rapidjson::Document j_doc;
+    j_doc.SetObject();
+    rapidjson::Value j_actors(rapidjson::kArrayType);
+    for (TestActor const& actor: convoy)
+    {
+        rapidjson::Value j_entry(rapidjson::kObjectType);
+        rapidjson::Value j_nodes(rapidjson::kArrayType);
+        for (Node const& n: actor.nodes)
+        {
+            rapidjson::Value j_node(rapidjson::kArrayType);
+            for (int k = 0; k < 3; k++) j_node.PushBack(n.pos[k], j_doc.GetAllocator());
+            for (int k = 0; k < 3; k++) j_node.PushBack(n.vel[k], j_doc.GetAllocator());
+            for (int k = 0; k < 3; k++) j_node.PushBack(n.init[k], j_doc.GetAllocator());
+            j_nodes.PushBack(j_node, j_doc.GetAllocator());
+        }
+        j_entry.AddMember("nodes", j_nodes, j_doc.GetAllocator());
+
+        rapidjson::Value j_beams(rapidjson::kArrayType);
+        for (Beam const& b: actor.beams)
+        {
+            rapidjson::Value j_beam(rapidjson::kArrayType);
+            j_beam.PushBack(b.maxposstress, j_doc.GetAllocator());
+            j_beam.PushBack(b.maxnegstress, j_doc.GetAllocator());
+            j_beam.PushBack(b.minmaxposnegstress, j_doc.GetAllocator());
+            j_beam.PushBack(b.strength, j_doc.GetAllocator());
+            j_beam.PushBack(b.L, j_doc.GetAllocator());
+            j_beam.PushBack(b.broken, j_doc.GetAllocator());
+            j_beam.PushBack(b.disabled, j_doc.GetAllocator());
+            j_beam.PushBack(b.inter_actor, j_doc.GetAllocator());
+            j_beam.PushBack(b.locked_actor, j_doc.GetAllocator());
+            j_beams.PushBack(j_beam, j_doc.GetAllocator());
+        }
+        j_entry.AddMember("beams", j_beams, j_doc.GetAllocator());
+        j_actors.PushBack(j_entry, j_doc.GetAllocator());
+    }
+    j_doc.AddMember("actors", j_actors, j_doc.GetAllocator());
+
+    buffer.Clear();
+    JsonWriter writer(buffer);
+    j_doc.Accept(writer);
+}
+
+static void LoadJson(const char* json, std::vector<TestActor>& convoy)
+{
+    rapidjson::Document j_doc;
+    j_doc.Parse<rapidjson::kParseNanAndInfFlag>(json);
+    auto j_actors = j_doc["actors"].GetArray();
+    convoy.resize(j_actors.Size());
+    for (rapidjson::SizeType a = 0; a < j_actors.Size(); a++)
+    {
+        TestActor& actor = convoy[a];
+        auto nodes = j_actors[a]["nodes"].GetArray();
+        actor.nodes.resize(nodes.Size());
+        for (rapidjson::SizeType i = 0; i < nodes.Size(); i++)
+        {
+            auto data = nodes[i].GetArray();
+            for (int k = 0; k < 3; k++) actor.nodes[i].pos[k] = data[k].GetFloat();
+            for (int k = 0; k < 3; k++) actor.nodes[i].vel[k] = data[3 + k].GetFloat();
+            for (int k = 0; k < 3; k++) actor.nodes[i].init[k] = data[6 + k].GetFloat();
+        }
+        auto beams = j_actors[a]["beams"].GetArray();
+        actor.beams.resize(beams.Size());
+        for (rapidjson::SizeType i = 0; i < beams.Size(); i++)
+        {
+            auto data = beams[i].GetArray();
+            Beam& b = actor.beams[i];
+            b.maxposstress = data[0].GetFloat();
+            b.maxnegstress = data[1].GetFloat();
+            b.minmaxposnegstress = data[2].GetFloat();
+            b.strength = data[3].GetFloat();
+            b.L = data[4].GetFloat();
+            b.broken = data[5].GetBool();
+            b.disabled = data[6].GetBool();
+            b.inter_actor = data[7].GetBool();
+            b.locked_actor = data[8].GetInt();
+        }
+    }
+}
+
+// ---------------- Binary ----------------
+
+static void SaveBinary(std::vector<TestActor> const& convoy, std::vector<uint8_t>& out)
+{
+    SavedActorBlocksVec blocks;
+    for (TestActor const& actor: convoy)
+    {
+        std::shared_ptr<SavedActorBlocks> b = std::make_shared<SavedActorBlocks>();
+        b->Resize((uint32_t)actor.nodes.size(), (uint32_t)actor.beams.size());
+        for (size_t i = 0; i < actor.nodes.size(); i++)
+        {
+            for (int k = 0; k < 3; k++) b->NodeField(SAVEGAME_NODE_POS_X + k)[i] = actor.nodes[i].pos[k];
+            for (int k = 0; k < 3; k++) b->NodeField(SAVEGAME_NODE_VEL_X + k)[i] = actor.nodes[i].vel[k];
+            for (int k = 0; k < 3; k++) b->NodeField(SAVEGAME_NODE_INIT_X + k)[i] = actor.nodes[i].init[k];
+        }
+        for (size_t i = 0; i < actor.beams.size(); i++)
+        {
+            Beam const& beam = actor.beams[i];
+            b->BeamField(SAVEGAME_BEAM_MAXPOSSTRESS)[i] = beam.maxposstress;
+            b->BeamField(SAVEGAME_BEAM_MAXNEGSTRESS)[i] = beam.maxnegstress;
+            b->BeamField(SAVEGAME_BEAM_MINMAXPOSNEGSTRESS)[i] = beam.minmaxposnegstress;
+            b->BeamField(SAVEGAME_BEAM_STRENGTH)[i] = beam.strength;
+            b->BeamField(SAVEGAME_BEAM_L)[i] = beam.L;
+            b->beam_flags[i] = (beam.broken ? SAVEGAME_BEAM_BROKEN : 0) | (beam.disabled ? SAVEGAME_BEAM_DISABLED : 0)
+                             | (beam.inter_actor ? SAVEGAME_BEAM_INTER_ACTOR : 0);
+            b->beam_locked_actors[i] = beam.locked_actor;
+        }
+        blocks.push_back(b);
+    }
+    SavegameBinaryWrite("{}", blocks, out);
+}
+
+static bool LoadBinary(std::vector<uint8_t> const& data, std::vector<TestActor>& convoy)
+{
+    SavegameBinaryHeader header;
+    std::memcpy(&header, data.data(), sizeof(SavegameBinaryHeader));
+    if (!SavegameBinaryCheckHeader(header))
+        return false;
+    const size_t offset = sizeof(SavegameBinaryHeader) + header.json_size;
+    SavedActorBlocksVec blocks;
+    if (!SavegameBinaryReadBlocks(data.data() + offset, data.size() - offset, header.num_actors, blocks))
+        return false;
+
+    convoy.resize(blocks.size());
+    for (size_t a = 0; a < blocks.size(); a++)
+    {
+        SavedActorBlocks const& b = *blocks[a];
+        TestActor& actor = convoy[a];
+        actor.nodes.resize(b.num_nodes);
+        for (size_t i = 0; i < b.num_nodes; i++)
+        {
+            for (int k = 0; k < 3; k++) actor.nodes[i].pos[k] = b.NodeField(SAVEGAME_NODE_POS_X + k)[i];
+            for (int k = 0; k < 3; k++) actor.nodes[i].vel[k] = b.NodeField(SAVEGAME_NODE_VEL_X + k)[i];
+            for (int k = 0; k < 3; k++) actor.nodes[i].init[k] = b.NodeField(SAVEGAME_NODE_INIT_X + k)[i];
+        }
+        actor.beams.resize(b.num_beams);
+        for (size_t i = 0; i < b.num_beams; i++)
+        {
+            Beam& beam = actor.beams[i];
+            beam.maxposstress = b.BeamField(SAVEGAME_BEAM_MAXPOSSTRESS)[i];
+            beam.maxnegstress = b.BeamField(SAVEGAME_BEAM_MAXNEGSTRESS)[i];
+            beam.minmaxposnegstress = b.BeamField(SAVEGAME_BEAM_MINMAXPOSNEGSTRESS)[i];
+            beam.strength = b.BeamField(SAVEGAME_BEAM_STRENGTH)[i];
+            beam.L = b.BeamField(SAVEGAME_BEAM_L)[i];
+            beam.broken = (b.beam_flags[i] & SAVEGAME_BEAM_BROKEN) != 0;
+            beam.disabled = (b.beam_flags[i] & SAVEGAME_BEAM_DISABLED) != 0;
+            beam.inter_actor = (b.beam_flags[i] & SAVEGAME_BEAM_INTER_ACTOR) != 0;
+            beam.locked_actor = b.beam_locked_actors[i];
+        }
+    }
+    return true;
+}
+
+// ---------------- Benchmarks ----------------
+
+static void BM_Save_Json(benchmark::State& state)
+{
+    std::vector<TestActor> const& convoy = GetConvoy();
+    rapidjson::StringBuffer buffer;
+    for (auto _ : state)
+    {
+        SaveJson(convoy, buffer);
+        benchmark::DoNotOptimize(buffer.GetString());
+    }
+    state.counters["MB"] = buffer.GetSize() / 1e6;
+}
+BENCHMARK(BM_Save_Json)->Unit(benchmark::kMillisecond);
+
+static void BM_Load_Json(benchmark::State& state)
+{
+    rapidjson::StringBuffer buffer;
+    SaveJson(GetConvoy(), buffer);
+    std::vector<TestActor> loaded;
+    for (auto _ : state)
+    {
+        LoadJson(buffer.GetString(), loaded);
+        benchmark::ClobberMemory();
+    }
+    state.counters["MB"] = buffer.GetSize() / 1e6;
+}
+BENCHMARK(BM_Load_Json)->Unit(benchmark::kMillisecond);
+
+static void BM_Save_Binary(benchmark::State& state)
+{
+    std::vector<TestActor> const& convoy = GetConvoy();
+    std::vector<uint8_t> data;
+    for (auto _ : state)
+    {
+        SaveBinary(convoy, data);
+        benchmark::DoNotOptimize(data.data());
+    }
+    state.counters["MB"] = data.size() / 1e6;
+}
+BENCHMARK(BM_Save_Binary)->Unit(benchmark::kMillisecond);
+
+static void BM_Load_Binary(benchmark::State& state)
+{
+    std::vector<uint8_t> data;
+    SaveBinary(GetConvoy(), data);
+    std::vector<TestActor> loaded;
+    for (auto _ : state)
+    {
+        if (!LoadBinary(data, loaded))
+        {
+            state.SkipWithError("damaged data");
+            break;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.counters["MB"] = data.size() / 1e6;
+}
+BENCHMARK(BM_Load_Binary)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();